@@ -0,0 +1,148 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <thread>
+#include <new>
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
+#include "BatchScheduler.h"
+
+namespace grk
+{
+BatchScheduler::BatchScheduler(uint32_t maxInFlight, uint64_t memoryBudget)
+	: maxInFlight_(std::max<uint32_t>(maxInFlight, 1)), memoryBudget_(memoryBudget), nextFile_(0),
+	  nextAdmit_(0), memoryInFlight_(0), peakMemoryInFlight_(0), numInFlight_(0), peakInFlight_(0),
+	  numProcessed_(0), numFailed_(0), numSkipped_(0), bytesIn_(0), bytesOut_(0),
+	  elapsed_(std::chrono::duration<double>::zero())
+{}
+uint32_t BatchScheduler::getNumProcessed(void) const
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	return numProcessed_;
+}
+uint32_t BatchScheduler::getNumFailed(void) const
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	return numFailed_;
+}
+uint32_t BatchScheduler::run(const std::vector<std::string>& files, BatchEstimateFn estimate,
+							 BatchJobFn job)
+{
+	if(files.empty())
+		return 0;
+	uint32_t numProcessedBefore = getNumProcessed();
+	nextFile_ = 0;
+	nextAdmit_ = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	auto numWorkers = (uint32_t)std::min<size_t>(maxInFlight_, files.size());
+	if(numWorkers == 1)
+	{
+		worker(&files, &estimate, &job);
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		for(uint32_t i = 0; i < numWorkers; ++i)
+			workers.push_back(std::thread(&BatchScheduler::worker, this, &files, &estimate, &job));
+		for(auto& w : workers)
+			w.join();
+	}
+	elapsed_ += std::chrono::high_resolution_clock::now() - start;
+
+	return getNumProcessed() - numProcessedBefore;
+}
+void BatchScheduler::worker(const std::vector<std::string>* files, BatchEstimateFn* estimate,
+							BatchJobFn* job)
+{
+	while(true)
+	{
+		size_t index = nextFile_++;
+		if(index >= files->size())
+			break;
+		auto& fileName = (*files)[index];
+		uint64_t memEstimate = *estimate ? (*estimate)(fileName) : 0;
+		{
+			std::unique_lock<std::mutex> lk(mutex_);
+			admitCondition_.wait(lk, [this, index, memEstimate] {
+				return nextAdmit_ == index &&
+					   (numInFlight_ == 0 || !memoryBudget_ ||
+						memoryInFlight_ + memEstimate <= memoryBudget_);
+			});
+			nextAdmit_++;
+			numInFlight_++;
+			memoryInFlight_ += memEstimate;
+			peakInFlight_ = std::max(peakInFlight_, numInFlight_);
+			peakMemoryInFlight_ = std::max(peakMemoryInFlight_, memoryInFlight_);
+		}
+		// wake up worker holding next admission ticket
+		admitCondition_.notify_all();
+
+		BatchJobResult result;
+		int rc = 0;
+		try
+		{
+			rc = (*job)(fileName, &result);
+		}
+		catch([[maybe_unused]] std::bad_alloc& ba)
+		{
+			spdlog::error("Out of memory processing {}", fileName);
+			rc = 0;
+		}
+		{
+			std::unique_lock<std::mutex> lk(mutex_);
+			numInFlight_--;
+			memoryInFlight_ -= memEstimate;
+			switch(rc)
+			{
+				case 1:
+					numProcessed_++;
+					bytesIn_ += result.bytesIn;
+					bytesOut_ += result.bytesOut;
+					break;
+				case 2:
+					numSkipped_++;
+					break;
+				default:
+					numFailed_++;
+					break;
+			}
+		}
+		admitCondition_.notify_all();
+	}
+}
+void BatchScheduler::printStats(const std::string& verb) const
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	if(!numProcessed_)
+		return;
+	double seconds = elapsed_.count();
+	double mb = 1024.0 * 1024.0;
+	spdlog::info("{} time: {} ms/image", verb, (seconds * 1000) / (double)numProcessed_);
+	if(seconds > 0)
+	{
+		spdlog::info("{} throughput: {:.2f} images/s, {:.2f} MB/s in, {:.2f} MB/s out", verb,
+					 (double)numProcessed_ / seconds, (double)bytesIn_ / mb / seconds,
+					 (double)bytesOut_ / mb / seconds);
+	}
+	spdlog::info("{} batch: {} succeeded, {} failed, {} skipped, peak {} in flight, peak estimated "
+				 "memory {:.2f} MB",
+				 verb, numProcessed_, numFailed_, numSkipped_, peakInFlight_,
+				 (double)peakMemoryInFlight_ / mb);
+}
+
+} // namespace grk
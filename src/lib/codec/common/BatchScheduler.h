@@ -0,0 +1,111 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+namespace grk
+{
+/**
+ * Per-file result reported by a batch job
+ */
+struct BatchJobResult
+{
+	BatchJobResult() : bytesIn(0), bytesOut(0) {}
+	uint64_t bytesIn;
+	uint64_t bytesOut;
+};
+
+/**
+ * Estimate peak memory (in bytes) needed to process a file. Return 0 if unknown.
+ */
+typedef std::function<uint64_t(const std::string& fileName)> BatchEstimateFn;
+
+/**
+ * Process a single file.
+ * Returns 0 for failure, 1 for success, and 2 if file is not suitable for processing
+ */
+typedef std::function<int(const std::string& fileName, BatchJobResult* result)> BatchJobFn;
+
+/**
+ * Keeps up to maxInFlight files in flight, each driven by its own thread, while the
+ * heavy lifting (T1, wavelet, etc.) for all of them is shared by the library's
+ * executor. A file is only admitted once the sum of estimated memory for all files
+ * in flight, including the new file, fits into the memory budget. At least one file
+ * is always admitted, so that a file larger than the budget still gets processed.
+ * Files are admitted in order.
+ */
+class BatchScheduler
+{
+  public:
+	/**
+	 * @param maxInFlight maximum number of files processed concurrently
+	 * @param memoryBudget memory budget in bytes; 0 means no limit
+	 */
+	BatchScheduler(uint32_t maxInFlight, uint64_t memoryBudget);
+
+	/**
+	 * Process files
+	 *
+	 * @param files file names
+	 * @param estimate memory estimator (may be empty)
+	 * @param job job run for each file
+	 *
+	 * @return number of files successfully processed
+	 */
+	uint32_t run(const std::vector<std::string>& files, BatchEstimateFn estimate, BatchJobFn job);
+
+	/**
+	 * Log aggregate throughput for all calls to run()
+	 *
+	 * @param verb "compress" or "decompress"
+	 */
+	void printStats(const std::string& verb) const;
+
+	uint32_t getNumProcessed(void) const;
+	uint32_t getNumFailed(void) const;
+
+  private:
+	void worker(const std::vector<std::string>* files, BatchEstimateFn* estimate, BatchJobFn* job);
+	uint32_t maxInFlight_;
+	uint64_t memoryBudget_;
+
+	std::atomic<size_t> nextFile_;
+	size_t nextAdmit_;
+	uint64_t memoryInFlight_;
+	uint64_t peakMemoryInFlight_;
+	uint32_t numInFlight_;
+	uint32_t peakInFlight_;
+	mutable std::mutex mutex_;
+	std::condition_variable admitCondition_;
+
+	uint32_t numProcessed_;
+	uint32_t numFailed_;
+	uint32_t numSkipped_;
+	uint64_t bytesIn_;
+	uint64_t bytesOut_;
+	std::chrono::duration<double> elapsed_;
+};
+
+} // namespace grk
@@ -234,6 +234,56 @@ bool isFinalOutputSubsampled(grk_image* image)
 	return false;
 }
 
+static void logMemStats(grk_codec* codec)
+{
+	grk_mem_stats stats;
+	if(!grk_get_mem_stats(codec, &stats))
+		return;
+	double mb = 1024.0 * 1024.0;
+	for(uint32_t i = 0; i < GRK_NUM_MEM_CATEGORIES; ++i)
+	{
+		auto usage = stats.categories + i;
+		spdlog::info("stats: mem {:<12} current {:>10.2f} MB peak {:>10.2f} MB",
+					 grk_get_mem_category_name((GRK_MEM_CATEGORY)i), (double)usage->current / mb,
+					 (double)usage->peak / mb);
+	}
+	spdlog::info("stats: mem {:<12} current {:>10.2f} MB peak {:>10.2f} MB", "total",
+				 (double)stats.total.current / mb, (double)stats.total.peak / mb);
+}
+void logStats(grk_codec* codec, const char* traceFile)
+{
+	logMemStats(codec);
+	grk_stats stats;
+	if(!grk_get_stats(codec, &stats))
+		return;
+	spdlog::info("stats: elapsed {:.3f} ms", stats.elapsed_ms);
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+	{
+		auto stage = stats.stages + i;
+		if(!stage->count)
+			continue;
+		spdlog::info("stats: {:<12} count {:>8} total {:>10.3f} ms max {:>8.3f} ms",
+					 grk_get_stage_name((GRK_STAGE)i), stage->count, stage->total_ms,
+					 stage->max_ms);
+	}
+	for(uint32_t i = 0; i < GRK_NUM_COUNTERS; ++i)
+		spdlog::info("stats: {:<12} {}", grk_get_counter_name((GRK_COUNTER)i), stats.counters[i]);
+	if(traceFile && traceFile[0])
+	{
+		if(grk_dump_trace(codec, traceFile))
+			spdlog::info("stats: trace written to {}", traceFile);
+		else
+			spdlog::warn("stats: unable to write trace to {}", traceFile);
+	}
+}
+std::string traceFileForInput(const std::string& traceFile, const std::string& inputFile)
+{
+	std::filesystem::path trace(traceFile);
+	auto name = trace.stem().string() + "_" + std::filesystem::path(inputFile).stem().string() +
+				trace.extension().string();
+
+	return trace.replace_filename(name).string();
+}
 
 const char* pathSeparator()
 {
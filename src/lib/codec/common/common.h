@@ -129,6 +129,22 @@ char* get_file_name(char* name);
 uint32_t get_num_images(char* imgdirpath);
 char* actual_path(const char* outfile, bool* mem_allocated);
 bool isFinalOutputSubsampled(grk_image* image);
+/**
+ * Log per-stage timing and counters collected by codec, and optionally
+ * write trace to file
+ *
+ * @param codec codec with instrumentation enabled
+ * @param traceFile trace file name, or null/empty for no trace
+ */
+void logStats(grk_codec* codec, const char* traceFile);
+/**
+ * Get trace file name for one file of a directory, by appending the
+ * file's stem to the trace file's stem i.e. trace.json, a.tif => trace_a.json
+ *
+ * @param traceFile trace file name
+ * @param inputFile input file name
+ */
+std::string traceFileForInput(const std::string& traceFile, const std::string& inputFile);
 
 // swap endian for 16 bit integer
 template<typename T>
@@ -14,132 +14,400 @@
  *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "grk_apps_config.h"
-#include <iostream>
-
-#ifdef GROK_HAVE_EXIFTOOL
-#ifndef _MSC_VER
-#pragma GCC diagnostic push
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wdeprecated-volatile"
-#else
-#pragma GCC diagnostic ignored "-Wvolatile"
-#endif
-#pragma GCC diagnostic ignored "-Wconversion"
-#pragma GCC diagnostic ignored "-Wsign-conversion"
-#endif
-
-#define PERL_NO_GET_CONTEXT
-#include "EXTERN.h"
-#include "perl.h"
-#include "XSUB.h"
-#ifndef _MSC_VER
-#pragma GCC diagnostic pop
-#endif
-#endif
+#include "common.h"
 #include "exif.h"
-#include <stdexcept>
 
 namespace grk
 {
-#ifdef GROK_HAVE_EXIFTOOL
-class PerlInterp
+const uint8_t Exif::jpegIdentifier[6] = {'E', 'x', 'i', 'f', 0, 0};
+
+// tags linking a directory to its sub-directories
+const uint16_t EXIF_IFD_TAG = 34665;
+const uint16_t GPS_IFD_TAG = 34853;
+const uint16_t INTEROP_IFD_TAG = 40965;
+
+// descriptive IFD0 tags that travel with the Exif block:
+// ImageDescription, Make, Model, Software, DateTime, Artist and Copyright
+const uint16_t ifd0Tags[] = {270, 271, 272, 305, 306, 315, 33432, EXIF_IFD_TAG, GPS_IFD_TAG};
+
+const uint16_t TIFF_TYPE_LONG = 4;
+const uint16_t TIFF_TYPE_IFD = 13;
+
+// sanity limits for untrusted directories
+const uint32_t maxIfdEntries = 4096;
+const uint32_t maxValueBytes = 1U << 24;
+const uint32_t maxIfdDepth = 4;
+
+static uint16_t get16(const uint8_t* p, bool bigEndian)
+{
+	return bigEndian ? (uint16_t)((p[0] << 8) | p[1]) : (uint16_t)((p[1] << 8) | p[0]);
+}
+static uint32_t get32(const uint8_t* p, bool bigEndian)
+{
+	return bigEndian ? (uint32_t)((get16(p, true) << 16) | get16(p + 2, true))
+					 : (uint32_t)((get16(p + 2, false) << 16) | get16(p, false));
+}
+static void put16(uint8_t* p, uint16_t val, bool bigEndian)
+{
+	for(uint32_t i = 0; i < 2; ++i)
+		p[bigEndian ? 1 - i : i] = (uint8_t)(val >> (8 * i));
+}
+static void put32(uint8_t* p, uint32_t val, bool bigEndian)
+{
+	for(uint32_t i = 0; i < 4; ++i)
+		p[bigEndian ? 3 - i : i] = (uint8_t)(val >> (8 * i));
+}
+
+/**
+ * Size of a value of the given field type, and the size of the unit
+ * that is byte swapped when converting between byte orders.
+ * Returns 0 for unknown types.
+ */
+static uint32_t typeSize(uint16_t type, uint32_t* swapUnit)
+{
+	switch(type)
+	{
+		case 1: // BYTE
+		case 2: // ASCII
+		case 6: // SBYTE
+		case 7: // UNDEFINED
+			*swapUnit = 1;
+			return 1;
+		case 3: // SHORT
+		case 8: // SSHORT
+			*swapUnit = 2;
+			return 2;
+		case 4: // LONG
+		case 9: // SLONG
+		case 11: // FLOAT
+		case 13: // IFD
+			*swapUnit = 4;
+			return 4;
+		case 5: // RATIONAL
+		case 10: // SRATIONAL
+			*swapUnit = 4;
+			return 8;
+		case 12: // DOUBLE
+			*swapUnit = 8;
+			return 8;
+		default:
+			return 0;
+	}
+}
+
+static bool isIfdPointer(uint16_t tag)
+{
+	return tag == EXIF_IFD_TAG || tag == GPS_IFD_TAG || tag == INTEROP_IFD_TAG;
+}
+
+struct IfdEntry
+{
+	uint16_t tag;
+	uint16_t type;
+	uint32_t count;
+	// value or value offset, in byte order of the directory the entry belongs to
+	uint8_t value[4];
+};
+
+/**
+ * Copies directory entries and their out-of-line values from a source TIFF
+ * structure to a destination buffer that will live at a given file offset,
+ * converting byte order if necessary.
+ */
+class IfdCopier
 {
   public:
-	PerlInterp() : my_perl(nullptr)
+	IfdCopier(const ExifReader& reader, bool srcBigEndian, bool dstBigEndian, uint32_t dstBase)
+		: reader_(reader), srcBigEndian_(srcBigEndian), dstBigEndian_(dstBigEndian),
+		  dstBase_(dstBase)
+	{}
+	bool readIfd(uint32_t offset, std::vector<IfdEntry>& entries, uint32_t* next)
 	{
-		std::string script{R"x(
-                use strict;
-				use warnings;
-				use Image::ExifTool;
-				sub transfer {
-					my $srcFile = $_[0];
-					my $outFile = $_[1];
-					my $exifTool = new Image::ExifTool;
-					my $info = $exifTool->SetNewValuesFromFile($srcFile, 'all:all');
-					my $result = $exifTool->WriteInfo($outFile);
-				}
-		    )x"};
-		constexpr int NUM_ARGS = 3;
-		const char* embedding[NUM_ARGS] = {"", "-e", "0"};
-		PERL_SYS_INIT3(nullptr, nullptr, nullptr);
-		my_perl = perl_alloc();
-		if(my_perl)
+		uint8_t buf[12];
+		if(!reader_(offset, buf, 2))
+			return false;
+		uint32_t numEntries = get16(buf, srcBigEndian_);
+		if(numEntries > maxIfdEntries)
+			return false;
+		std::vector<uint8_t> raw(numEntries * 12 + 4);
+		if(!reader_(offset + 2, raw.data(), raw.size()))
+			return false;
+		for(uint32_t i = 0; i < numEntries; ++i)
 		{
-			perl_construct(my_perl);
-			if(perl_parse(my_perl, nullptr, NUM_ARGS, (char**)embedding, nullptr))
-			{
-				dealloc();
-				throw std::runtime_error("Unable to parse Perl script used to extract exif tags");
-			}
-			if(perl_run(my_perl))
-			{
-				dealloc();
-				throw std::runtime_error(
-					"Unable to run Perl interpreter used to extract exif tags");
-			}
-			if(!eval_pv(script.c_str(), TRUE))
-			{
-				dealloc();
-				throw std::runtime_error(
-					"Unable to evaluate Perl script used to extract exif tags");
-			}
+			auto p = raw.data() + i * 12;
+			IfdEntry entry;
+			entry.tag = get16(p, srcBigEndian_);
+			entry.type = get16(p + 2, srcBigEndian_);
+			entry.count = get32(p + 4, srcBigEndian_);
+			memcpy(entry.value, p + 8, 4);
+			entries.push_back(entry);
 		}
-		else
+		if(next)
+			*next = get32(raw.data() + numEntries * 12, srcBigEndian_);
+
+		return true;
+	}
+	/**
+	 * Copy entry value to destination, and convert entry to destination byte order.
+	 * Sub-directories are copied recursively.
+	 */
+	bool copyEntry(IfdEntry& entry, uint32_t depth)
+	{
+		uint32_t swapUnit = 0;
+		uint32_t size = typeSize(entry.type, &swapUnit);
+		if(!size || entry.count > maxValueBytes / size)
+			return false;
+		if(isIfdPointer(entry.tag) &&
+		   (entry.type == TIFF_TYPE_LONG || entry.type == TIFF_TYPE_IFD) && entry.count == 1)
+		{
+			uint32_t dstOffset = 0;
+			if(depth >= maxIfdDepth ||
+			   !copyIfd(get32(entry.value, srcBigEndian_), &dstOffset, depth + 1))
+				return false;
+			put32(entry.value, dstOffset, dstBigEndian_);
+
+			return true;
+		}
+		uint32_t len = entry.count * size;
+		if(len <= 4)
 		{
-			PERL_SYS_TERM();
+			swap(entry.value, len, swapUnit);
+			memset(entry.value + len, 0, 4 - len);
+
+			return true;
 		}
+		std::vector<uint8_t> val(len);
+		if(!reader_(get32(entry.value, srcBigEndian_), val.data(), len))
+			return false;
+		swap(val.data(), len, swapUnit);
+		align();
+		put32(entry.value, tell(), dstBigEndian_);
+		out_.insert(out_.end(), val.begin(), val.end());
+
+		return true;
 	}
+	bool copyIfd(uint32_t srcOffset, uint32_t* dstOffset, uint32_t depth)
+	{
+		std::vector<IfdEntry> entries;
+		if(!readIfd(srcOffset, entries, nullptr))
+			return false;
+		std::vector<IfdEntry> copied;
+		for(auto& entry : entries)
+		{
+			if(copyEntry(entry, depth))
+				copied.push_back(entry);
+		}
+		*dstOffset = writeIfd(copied, 0);
 
-	~PerlInterp()
+		return true;
+	}
+	/**
+	 * Write directory whose entries are already in destination byte order
+	 *
+	 * @return offset of directory
+	 */
+	uint32_t writeIfd(std::vector<IfdEntry>& entries, uint32_t next)
 	{
-		dealloc();
+		std::sort(entries.begin(), entries.end(),
+				  [](const IfdEntry& a, const IfdEntry& b) { return a.tag < b.tag; });
+		align();
+		uint32_t offset = tell();
+		size_t pos = out_.size();
+		out_.resize(pos + 2 + entries.size() * 12 + 4);
+		auto p = out_.data() + pos;
+		put16(p, (uint16_t)entries.size(), dstBigEndian_);
+		p += 2;
+		for(auto& entry : entries)
+		{
+			put16(p, entry.tag, dstBigEndian_);
+			put16(p + 2, entry.type, dstBigEndian_);
+			put32(p + 4, entry.count, dstBigEndian_);
+			memcpy(p + 8, entry.value, 4);
+			p += 12;
+		}
+		put32(p, next, dstBigEndian_);
+
+		return offset;
+	}
+	std::vector<uint8_t>& data(void)
+	{
+		return out_;
 	}
 
   private:
-	void dealloc(void)
+	void swap(uint8_t* buf, uint32_t len, uint32_t swapUnit)
 	{
-		if(my_perl)
-		{
-			perl_destruct(my_perl);
-			perl_free(my_perl);
-			PERL_SYS_TERM();
-		}
-		my_perl = nullptr;
+		if(srcBigEndian_ == dstBigEndian_ || swapUnit == 1)
+			return;
+		for(uint32_t i = 0; i + swapUnit <= len; i += swapUnit)
+			std::reverse(buf + i, buf + i + swapUnit);
+	}
+	// TIFF values and directories begin on a word boundary
+	void align(void)
+	{
+		if(tell() & 1)
+			out_.push_back(0);
 	}
-	PerlInterpreter* my_perl;
+	uint32_t tell(void)
+	{
+		return dstBase_ + (uint32_t)out_.size();
+	}
+	const ExifReader& reader_;
+	bool srcBigEndian_;
+	bool dstBigEndian_;
+	uint32_t dstBase_;
+	std::vector<uint8_t> out_;
 };
 
-class PerlScriptRunner
+static bool isCarriedIfd0Tag(uint16_t tag)
 {
-  public:
-	static PerlInterp* instance(void)
+	return std::find(std::begin(ifd0Tags), std::end(ifd0Tags), tag) != std::end(ifd0Tags);
+}
+
+/**
+ * Parse classic TIFF header
+ *
+ * @return false if header is not a little or big endian classic TIFF header
+ */
+static bool readHeader(const uint8_t* hdr, bool* bigEndian, uint32_t* ifd0Offset)
+{
+	if(hdr[0] == 'I' && hdr[1] == 'I')
+		*bigEndian = false;
+	else if(hdr[0] == 'M' && hdr[1] == 'M')
+		*bigEndian = true;
+	else
+		return false;
+	if(get16(hdr + 2, *bigEndian) != 42)
+		return false;
+	*ifd0Offset = get32(hdr + 4, *bigEndian);
+
+	return true;
+}
+
+void Exif::stripIdentifier(const uint8_t*& buf, size_t& len)
+{
+	if(len > sizeof(jpegIdentifier) && memcmp(buf, jpegIdentifier, sizeof(jpegIdentifier)) == 0)
 	{
-		static PerlInterp interp;
-		return &interp;
+		buf += sizeof(jpegIdentifier);
+		len -= sizeof(jpegIdentifier);
 	}
-};
-#endif
+}
 
-void transferExifTags([[maybe_unused]] std::string src, [[maybe_unused]] std::string dest)
+bool Exif::extract(const ExifReader& reader, bool bigEndian, uint32_t ifd0Offset,
+				   std::vector<uint8_t>& exif)
 {
-#ifdef GROK_HAVE_EXIFTOOL
-	try
+	IfdCopier copier(reader, bigEndian, bigEndian, 0);
+	std::vector<IfdEntry> entries;
+	if(!copier.readIfd(ifd0Offset, entries, nullptr))
+		return false;
+	// reserve space for header
+	copier.data().resize(8);
+	std::vector<IfdEntry> carried;
+	bool hasSubIfd = false;
+	for(auto& entry : entries)
 	{
-		PerlScriptRunner::instance();
+		if(!isCarriedIfd0Tag(entry.tag) || !copier.copyEntry(entry, 0))
+			continue;
+		hasSubIfd |= isIfdPointer(entry.tag);
+		carried.push_back(entry);
 	}
-	catch(std::runtime_error& re)
+	if(!hasSubIfd)
+		return false;
+	uint32_t ifd0 = copier.writeIfd(carried, 0);
+	auto hdr = copier.data().data();
+	hdr[0] = hdr[1] = bigEndian ? 'M' : 'I';
+	put16(hdr + 2, 42, bigEndian);
+	put32(hdr + 4, ifd0, bigEndian);
+	exif = std::move(copier.data());
+
+	return true;
+}
+
+bool Exif::embedInTiff(const std::string& fileName, const uint8_t* exif, size_t len)
+{
+	bool exifBigEndian = false;
+	uint32_t exifIfd0 = 0;
+	if(len < 8 || !readHeader(exif, &exifBigEndian, &exifIfd0))
 	{
-		std::cout << re.what() << std::endl;
-		return;
+		spdlog::warn("Exif block has invalid TIFF header; Exif will not be stored");
+		return false;
 	}
-	dTHX;
-	char* args[] = {(char*)src.c_str(), (char*)dest.c_str(), nullptr};
-	if(call_argv("transfer", G_DISCARD, args))
-		std::cout << "Unable to run Perl script used to extract exif tags" << std::endl;
-#else
-	std::cout << "ExifTool not available; unable to transfer Exif tags" << std::endl;
-#endif
+	auto fp = fopen(fileName.c_str(), "r+b");
+	if(!fp)
+	{
+		spdlog::error("Unable to open {} to store Exif", fileName);
+		return false;
+	}
+	bool rc = false;
+	uint8_t hdr[8];
+	bool tiffBigEndian = false;
+	uint32_t tiffIfd0 = 0;
+	uint32_t next = 0;
+	int64_t fileLength = 0;
+	ExifReader exifReader = [exif, len](uint64_t offset, uint8_t* buf, size_t numBytes) {
+		if(offset > len || numBytes > len - offset)
+			return false;
+		memcpy(buf, exif + offset, numBytes);
+		return true;
+	};
+	ExifReader tiffReader = [fp](uint64_t offset, uint8_t* buf, size_t numBytes) {
+		return GRK_FSEEK(fp, (int64_t)offset, SEEK_SET) == 0 &&
+			   fread(buf, 1, numBytes, fp) == numBytes;
+	};
+	std::vector<IfdEntry> tiffEntries;
+	std::vector<IfdEntry> exifEntries;
+	if(!tiffReader(0, hdr, sizeof(hdr)) || !readHeader(hdr, &tiffBigEndian, &tiffIfd0))
+	{
+		spdlog::warn("Exif can only be stored in classic TIFF files");
+		goto cleanup;
+	}
+	if(GRK_FSEEK(fp, 0, SEEK_END) != 0)
+		goto cleanup;
+	fileLength = GRK_FTELL(fp);
+	if(fileLength < 0 || (uint64_t)fileLength + len * 2 > UINT32_MAX)
+		goto cleanup;
+	{
+		IfdCopier tiff(tiffReader, tiffBigEndian, tiffBigEndian, 0);
+		IfdCopier copier(exifReader, exifBigEndian, tiffBigEndian, (uint32_t)fileLength);
+		if(!tiff.readIfd(tiffIfd0, tiffEntries, &next) ||
+		   !copier.readIfd(exifIfd0, exifEntries, nullptr))
+			goto cleanup;
+		bool linked = false;
+		for(auto& entry : exifEntries)
+		{
+			if(!isCarriedIfd0Tag(entry.tag))
+				continue;
+			if(std::any_of(tiffEntries.begin(), tiffEntries.end(),
+						   [&entry](const IfdEntry& e) { return e.tag == entry.tag; }))
+				continue;
+			if(copier.copyEntry(entry, 0))
+			{
+				tiffEntries.push_back(entry);
+				linked = true;
+			}
+		}
+		if(!linked)
+		{
+			rc = true;
+			goto cleanup;
+		}
+		uint32_t ifd0 = copier.writeIfd(tiffEntries, next);
+		auto& data = copier.data();
+		if(GRK_FSEEK(fp, fileLength, SEEK_SET) != 0 ||
+		   fwrite(data.data(), 1, data.size(), fp) != data.size())
+			goto cleanup;
+		put32(hdr + 4, ifd0, tiffBigEndian);
+		if(GRK_FSEEK(fp, 4, SEEK_SET) != 0 || fwrite(hdr + 4, 1, 4, fp) != 4)
+			goto cleanup;
+	}
+	rc = true;
+cleanup:
+	if(fclose(fp))
+		rc = false;
+	if(!rc)
+		spdlog::error("Failed to store Exif in {}", fileName);
+
+	return rc;
 }
 
 } // namespace grk
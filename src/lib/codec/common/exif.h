@@ -13,12 +13,74 @@
  *    You should have received a copy of the GNU Affero General Public License
  *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#pragma once
 
+#include <cstdint>
+#include <cstddef>
 #include <string>
+#include <vector>
+#include <functional>
 
 namespace grk
 {
-// transfer metadata
-void transferExifTags(std::string src, std::string dest);
+/**
+ * Random access reader over TIFF-structured data
+ *
+ * @param offset	offset relative to TIFF header
+ * @param buf		destination buffer
+ * @param len		number of bytes to read
+ *
+ * @return true if all bytes were read
+ */
+typedef std::function<bool(uint64_t offset, uint8_t* buf, size_t len)> ExifReader;
+
+/**
+ * Native Exif transfer between TIFF, JPEG, PNG and JP2.
+ *
+ * An Exif block is a self-contained TIFF structure: byte order mark, IFD0 holding
+ * descriptive tags plus pointers to the Exif and GPS IFDs, and the sub-IFDs themselves.
+ * JPEG APP1, PNG eXIf and JP2 Exif UUID boxes carry the block as is; for TIFF files,
+ * the relevant directories are copied to and from the file's own IFD0.
+ */
+class Exif
+{
+  public:
+	/**
+	 * Skip JPEG APP1 identifier, if present
+	 *
+	 * @param buf	Exif data - advanced past identifier
+	 * @param len	length of Exif data - reduced by identifier length
+	 */
+	static void stripIdentifier(const uint8_t*& buf, size_t& len);
+
+	/**
+	 * Build Exif block from a classic TIFF directory
+	 *
+	 * @param reader		reader over TIFF data
+	 * @param bigEndian		true if TIFF data is big endian
+	 * @param ifd0Offset	offset of IFD0
+	 * @param exif			Exif block
+	 *
+	 * @return true if directory links to Exif or GPS IFD, and block was built
+	 */
+	static bool extract(const ExifReader& reader, bool bigEndian, uint32_t ifd0Offset,
+						std::vector<uint8_t>& exif);
+
+	/**
+	 * Link Exif block into existing classic TIFF file.
+	 * Sub-IFDs and a merged IFD0 are appended to the file, and the header
+	 * is updated to point to the new IFD0.
+	 *
+	 * @param fileName	TIFF file name
+	 * @param exif		Exif block
+	 * @param len		length of Exif block
+	 *
+	 * @return true if successful
+	 */
+	static bool embedInTiff(const std::string& fileName, const uint8_t* exif, size_t len);
+
+	/** identifier preceding Exif block in JPEG APP1 marker segment */
+	static const uint8_t jpegIdentifier[6];
+};
 
 } // namespace grk
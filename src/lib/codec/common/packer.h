@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
 
 namespace grk {
 
@@ -927,6 +928,35 @@ public:
 	}
 };
 
+/**
+ * Copies 32 bit samples as is, for example floating point samples
+ * stored in integer planes (adjust is ignored)
+ */
+template <typename T> class PlanarToInterleaved32 : public PlanarToInterleaved<T>{
+public:
+	void interleave(T **src,
+					const uint32_t numPlanes,
+					uint8_t* dest,
+					const uint32_t srcWidth,
+					const uint32_t srcStride,
+					const uint64_t destStride,
+					const uint32_t h,
+					[[maybe_unused]] const int32_t adjust) override
+	{
+		for(size_t i = 0; i < h; i++) {
+			auto destPtr = dest;
+			for(size_t j = 0; j < srcWidth; j++)
+				for(size_t k = 0; k < numPlanes; ++k) {
+					memcpy(destPtr, src[k] + j, sizeof(uint32_t));
+					destPtr+=4;
+				}
+			dest += destStride;
+			for(size_t k = 0; k < numPlanes; ++k)
+				src[k] += srcStride;
+		}
+	}
+};
+
 template<typename T> class InterleaverFactory {
 public:
 	static PlanarToInterleaved<T>* makeInterleaver(uint8_t prec){
@@ -963,6 +993,8 @@ public:
 			return new PlanarToInterleaved15<T>();
 		case 16:
 			return new PlanarToInterleaved16<T>();
+		case 32:
+			return new PlanarToInterleaved32<T>();
 		case packer16BitBE:
 			return new PlanarToInterleaved16BE<T>();
 		default:
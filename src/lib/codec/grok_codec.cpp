@@ -19,6 +19,8 @@
 #include "GrkDecompress.h"
 #include "GrkCompress.h"
 #include "GrkCompareImages.h"
+#include "GrkTranscode.h"
+#include "GrkStitch.h"
 
 int GRK_CALLCONV grk_codec_dump(int argc, char* argv[])
 {
@@ -37,3 +39,11 @@ int GRK_CALLCONV grk_codec_compare_images(int argc, char* argv[])
 {
 	return grk::GrkCompareImages().main(argc, argv);
 }
+int GRK_CALLCONV grk_codec_transcode(int argc, char* argv[])
+{
+	return grk::GrkTranscode().main(argc, argv);
+}
+int GRK_CALLCONV grk_codec_stitch(int argc, char* argv[])
+{
+	return grk::GrkStitch().main(argc, argv);
+}
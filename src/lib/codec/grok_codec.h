@@ -73,6 +73,30 @@ GRK_API int grk_codec_decompress(int argc, char* argv[]);
  */
 GRK_API int grk_codec_compare_images(int argc, char* argv[]);
 
+/**
+ * Transcode image in the compressed domain.
+ *
+ * Pass grk_transcode command line arguments
+ *
+ * @param argc
+ * @param argv
+ *
+ * return 0 if successful
+ */
+GRK_API int grk_codec_transcode(int argc, char* argv[]);
+
+/**
+ * Stitch code stream fragments into a single code stream.
+ *
+ * Pass grk_stitch command line arguments
+ *
+ * @param argc
+ * @param argv
+ *
+ * return 0 if successful
+ */
+GRK_API int grk_codec_stitch(int argc, char* argv[]);
+
 #ifdef __cplusplus
 }
 #endif
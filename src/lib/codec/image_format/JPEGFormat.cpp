@@ -30,8 +30,32 @@
 #include <cassert>
 
 #include "common.h"
+#include "exif.h"
 #include "FileStreamIO.h"
 
+// identifier preceding XMP packet in JPEG APP1 marker segment
+static const char xmpIdentifier[] = "http://ns.adobe.com/xap/1.0/";
+const size_t xmpIdentifierLen = sizeof(xmpIdentifier);
+
+static void write_app1_marker(j_compress_ptr cinfo, const uint8_t* identifier,
+							  size_t identifierLen, const uint8_t* data, size_t len,
+							  const char* name)
+{
+	// marker segment length field includes itself
+	if(identifierLen + len > 0xFFFF - 2)
+	{
+		spdlog::warn("{} meta-data of length {} is too large for JPEG APP1 marker and "
+					 "will not be stored",
+					 name, len);
+		return;
+	}
+	jpeg_write_m_header(cinfo, JPEG_APP0 + 1, (unsigned int)(identifierLen + len));
+	for(size_t i = 0; i < identifierLen; ++i)
+		jpeg_write_m_byte(cinfo, identifier[i]);
+	for(size_t i = 0; i < len; ++i)
+		jpeg_write_m_byte(cinfo, data[i]);
+}
+
 struct my_error_mgr
 {
 	struct jpeg_error_mgr pub; /* "public" fields */
@@ -93,6 +117,10 @@ grk_image* JPEGFormat::jpegtoimage(const char* filename, grk_cparameters* parame
 	cvtInterleavedToPlanar cvtToPlanar;
 	JOCTET* icc_data_ptr = nullptr;
 	unsigned int icc_data_len = 0;
+	const uint8_t* exif_data = nullptr;
+	size_t exif_len = 0;
+	const uint8_t* xmp_data = nullptr;
+	size_t xmp_len = 0;
 
 	/* This struct contains the JPEG decompression parameters and pointers to
 	 * working space (which is allocated as needed by the JPEG library).
@@ -142,6 +170,8 @@ grk_image* JPEGFormat::jpegtoimage(const char* filename, grk_cparameters* parame
 	/* Now we can initialize the JPEG decompression object. */
 	jpeg_create_decompress(&cinfo);
 	setup_read_icc_profile(&cinfo);
+	// Exif and XMP are stored in APP1 marker segments
+	jpeg_save_markers(&cinfo, JPEG_APP0 + 1, 0xFFFF);
 
 	/* Step 2: specify data source (eg, a file) */
 	jpeg_stdio_src(&cinfo, fileStream_);
@@ -160,6 +190,23 @@ grk_image* JPEGFormat::jpegtoimage(const char* filename, grk_cparameters* parame
 	{
 		spdlog::warn("jpegtoimage: Failed to read ICC profile");
 	}
+	for(auto marker = cinfo.marker_list; marker; marker = marker->next)
+	{
+		if(marker->marker != JPEG_APP0 + 1)
+			continue;
+		if(!exif_data && marker->data_length > sizeof(grk::Exif::jpegIdentifier) &&
+		   !memcmp(marker->data, grk::Exif::jpegIdentifier, sizeof(grk::Exif::jpegIdentifier)))
+		{
+			exif_data = marker->data + sizeof(grk::Exif::jpegIdentifier);
+			exif_len = marker->data_length - sizeof(grk::Exif::jpegIdentifier);
+		}
+		else if(!xmp_data && marker->data_length > xmpIdentifierLen &&
+				!memcmp(marker->data, xmpIdentifier, xmpIdentifierLen))
+		{
+			xmp_data = marker->data + xmpIdentifierLen;
+			xmp_len = marker->data_length - xmpIdentifierLen;
+		}
+	}
 
 	/* Step 4: set parameters for decompression */
 
@@ -216,6 +263,21 @@ grk_image* JPEGFormat::jpegtoimage(const char* filename, grk_cparameters* parame
 	}
 	free(icc_data_ptr);
 	icc_data_ptr = nullptr;
+	// marker data is owned by decompressor, so copy before it is destroyed
+	if(exif_data)
+	{
+		create_meta(image_);
+		image_->meta->exif_len = exif_len;
+		image_->meta->exif_buf = new uint8_t[exif_len];
+		memcpy(image_->meta->exif_buf, exif_data, exif_len);
+	}
+	if(xmp_data)
+	{
+		create_meta(image_);
+		image_->meta->xmp_len = xmp_len;
+		image_->meta->xmp_buf = new uint8_t[xmp_len];
+		memcpy(image_->meta->xmp_buf, xmp_data, xmp_len);
+	}
 	/* set image_ offset and reference grid */
 	image_->x0 = parameters->image_offset_x0;
 	image_->x1 = !image_->x0 ? (w - 1) * 1 + 1 : image_->x0 + (w - 1) * 1 + 1;
@@ -523,6 +585,12 @@ bool JPEGFormat::encodeHeader(void)
 		write_icc_profile(&cinfo, image_->meta->color.icc_profile_buf,
 						  image_->meta->color.icc_profile_len);
 	}
+	if(image_->meta && image_->meta->exif_buf && image_->meta->exif_len)
+		write_app1_marker(&cinfo, grk::Exif::jpegIdentifier, sizeof(grk::Exif::jpegIdentifier),
+						  image_->meta->exif_buf, image_->meta->exif_len, "Exif");
+	if(image_->meta && image_->meta->xmp_buf && image_->meta->xmp_len)
+		write_app1_marker(&cinfo, (const uint8_t*)xmpIdentifier, xmpIdentifierLen,
+						  image_->meta->xmp_buf, image_->meta->xmp_len, "XMP");
 	encodeState = IMAGE_FORMAT_ENCODED_HEADER;
 
 	return true;
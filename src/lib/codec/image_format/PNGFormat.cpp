@@ -32,6 +32,7 @@
 #include <cassert>
 #include <locale>
 #include "common.h"
+#include "exif.h"
 #include "FileStreamIO.h"
 
 #define PNG_MAGIC "\x89PNG\x0d\x0a\x1a\x0a"
@@ -246,6 +247,10 @@ bool PNGFormat::encodeHeader(void)
 		txt.lang_key = nullptr;
 		png_set_text(png, info_, &txt, 1);
 	}
+#ifdef PNG_eXIf_SUPPORTED
+	if(image_->meta && image_->meta->exif_buf && image_->meta->exif_len)
+		png_set_eXIf_1(png, info_, (png_uint_32)image_->meta->exif_len, image_->meta->exif_buf);
+#endif
 
 	if(image_->capture_resolution[0] > 0 && image_->capture_resolution[1] > 0)
 	{
@@ -608,6 +613,22 @@ grk_image* PNGFormat::do_decode(grk_cparameters* params)
 			{}
 		}
 	}
+#ifdef PNG_eXIf_SUPPORTED
+	{
+		png_uint_32 exif_len = 0;
+		png_bytep exif_data = nullptr;
+		if(png_get_eXIf_1(png, info_, &exif_len, &exif_data) && exif_data && exif_len)
+		{
+			const uint8_t* exif = exif_data;
+			size_t len = exif_len;
+			grk::Exif::stripIdentifier(exif, len);
+			create_meta(image_);
+			image_->meta->exif_len = len;
+			image_->meta->exif_buf = new uint8_t[len];
+			memcpy(image_->meta->exif_buf, exif, len);
+		}
+	}
+#endif
 
 	if(png_get_pHYs(png, info_, &resx, &resy, &unit))
 	{
@@ -62,6 +62,38 @@ static bool writeToFile(FILE* fileStream_, bool bigEndian, int32_t* ptr, uint32_
 	return true;
 }
 
+/**
+ * Write floating point samples, stored as bit patterns in integer plane
+ */
+static bool writeFloatToFile(FILE* fileStream_, bool bigEndian, const int32_t* ptr, uint32_t w,
+							 uint32_t stride, uint32_t h)
+{
+	const size_t bufSize = 4096;
+	uint32_t buf[bufSize];
+	uint32_t* outPtr = buf;
+	size_t outCount = 0;
+	for(uint32_t j = 0; j < h; ++j)
+	{
+		auto rowPtr = (const uint32_t*)ptr;
+		for(uint32_t i = 0; i < w; ++i)
+		{
+			if(!grk::writeBytes<uint32_t>(rowPtr[i], buf, &outPtr, &outCount, bufSize, bigEndian,
+										  fileStream_))
+				return false;
+		}
+		ptr += stride;
+	}
+	// flush
+	if(outCount)
+	{
+		size_t res = fwrite(buf, sizeof(uint32_t), outCount, fileStream_);
+		if(res != outCount)
+			return false;
+	}
+
+	return true;
+}
+
 bool RAWFormat::encodeHeader(void)
 {
 	encodeState = IMAGE_FORMAT_ENCODED_HEADER;
@@ -100,11 +132,13 @@ bool RAWFormat::encodePixels(void)
 			break;
 		if(image_->comps[0].sgnd != image_->comps[compno].sgnd)
 			break;
+		if(image_->comps[0].float_data != image_->comps[compno].float_data)
+			break;
 	}
 	if(compno != numcomps)
 	{
 		spdlog::error("imagetoraw: All components shall have the same subsampling, same bit depth, "
-					  "same sign.");
+					  "same sign, same sample format.");
 		goto beach;
 	}
 	if(!grk::grk_open_for_output(&fileStream_, outfile, useStdIO_))
@@ -136,7 +170,13 @@ bool RAWFormat::encodePixels(void)
 		int32_t* ptr = comp->data;
 
 		bool rc;
-		if(prec <= 8)
+		if(comp->float_data)
+		{
+			rc = writeFloatToFile(fileStream_, bigEndian, ptr, w, stride, h);
+			if(!rc)
+				spdlog::error("imagetoraw: failed to write bytes for {}", outfile);
+		}
+		else if(prec <= 8)
 		{
 			if(sgnd)
 				rc = writeToFile<int8_t>(fileStream_, bigEndian, ptr, w, stride, h, lower, upper);
@@ -29,6 +29,7 @@
 #include "TIFFFormat.h"
 #include "convert.h"
 #include "common.h"
+#include "exif.h"
 
 #ifdef GRK_CUSTOM_TIFF_IO
 #define IO_MAX 2147483647U
@@ -209,6 +210,7 @@ bool TIFFFormat::encodeHeader(TIFF* tif)
 	uint32_t num_colour_channels = 0;
 	size_t numExtraChannels = 0;
 	bool sgnd = image_->comps[0].sgnd;
+	bool floatData = image_->comps[0].float_data;
 	uint32_t width = image_->decompressWidth;
 	units = width;
 	uint32_t height = image_->decompressHeight;
@@ -275,6 +277,21 @@ bool TIFFFormat::encodeHeader(TIFF* tif)
 					  grk::maxNumPackComponents);
 		goto cleanup;
 	}
+	for(uint16_t i = 1; i < numcomps; ++i)
+	{
+		if(image_->comps[i].float_data != floatData)
+		{
+			spdlog::error("TIFFFormat::encodeHeader: mix of floating point and integer "
+						  "components not supported");
+			goto cleanup;
+		}
+	}
+	if(floatData && (subsampled || bps != 32))
+	{
+		spdlog::error("TIFFFormat::encodeHeader: floating point components must be "
+					  "32 bit and not subsampled");
+		goto cleanup;
+	}
 	if(isFinalOutputSubsampled(image_))
 	{
 		if(tiPhoto != PHOTOMETRIC_YCBCR)
@@ -320,7 +337,8 @@ bool TIFFFormat::encodeHeader(TIFF* tif)
 		units = (width + chroma_subsample_x - 1) / chroma_subsample_x;
 	TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
 	TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
-	TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT, sgnd ? SAMPLEFORMAT_INT : SAMPLEFORMAT_UINT);
+	TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT,
+				 floatData ? SAMPLEFORMAT_IEEEFP : (sgnd ? SAMPLEFORMAT_INT : SAMPLEFORMAT_UINT));
 	TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, numcomps);
 	TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bps);
 	TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
@@ -586,12 +604,22 @@ bool TIFFFormat::encodeFinish(void)
 		assert(!tif_);
 		return true;
 	}
+	bool rc = true;
 	if(tif_)
+	{
 		TIFFClose(tif_);
+		// Exif sub-directories are linked in once libtiff has written IFD0
+		if(image_->meta && image_->meta->exif_buf && image_->meta->exif_len &&
+		   !grk::Exif::embedInTiff(fileName_, image_->meta->exif_buf, image_->meta->exif_len))
+		{
+			spdlog::error("TIFFFormat::encodeFinish: failed to store Exif in {}", fileName_);
+			rc = false;
+		}
+	}
 	tif_ = nullptr;
 	encodeState |= IMAGE_FORMAT_ENCODED_PIXELS;
 
-	return true;
+	return rc;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -997,6 +1025,7 @@ grk_image* TIFFFormat::decode(const std::string& filename, grk_cparameters* para
 	uint32_t iptc_len = 0;
 	uint8_t* xmp_buf = nullptr;
 	uint32_t xmp_len = 0;
+	uint64_t exifOffset = 0;
 	uint16_t* sampleinfo = nullptr;
 	uint16_t extrasamples = 0;
 	bool hasXRes = false, hasYRes = false, hasResUnit = false;
@@ -1354,7 +1383,29 @@ grk_image* TIFFFormat::decode(const std::string& filename, grk_cparameters* para
 		image->meta->xmp_buf = new uint8_t[xmp_len];
 		memcpy(image->meta->xmp_buf, xmp_buf, xmp_len);
 	}
-	// 9. read pixel data
+	// 9. extract Exif meta-data from Exif and GPS sub-directories
+	if(!TIFFIsBigTIFF(tif_) && (TIFFGetField(tif_, TIFFTAG_EXIFIFD, &exifOffset) == 1 ||
+								TIFFGetField(tif_, TIFFTAG_GPSIFD, &exifOffset) == 1))
+	{
+		auto handle = TIFFClientdata(tif_);
+		auto seekProc = TIFFGetSeekProc(tif_);
+		auto readProc = TIFFGetReadProc(tif_);
+		grk::ExifReader reader = [handle, seekProc, readProc](uint64_t offset, uint8_t* buf,
+															  size_t len) {
+			return seekProc(handle, offset, SEEK_SET) == offset &&
+				   readProc(handle, buf, (tmsize_t)len) == (tmsize_t)len;
+		};
+		std::vector<uint8_t> exif;
+		if(grk::Exif::extract(reader, TIFFIsBigEndian(tif_),
+							  (uint32_t)TIFFCurrentDirOffset(tif_), exif))
+		{
+			create_meta(image);
+			image->meta->exif_len = exif.size();
+			image->meta->exif_buf = new uint8_t[exif.size()];
+			memcpy(image->meta->exif_buf, exif.data(), exif.size());
+		}
+	}
+	// 10. read pixel data
 	if(needSignedPixelReader)
 	{
 		if(tiBps == 8)
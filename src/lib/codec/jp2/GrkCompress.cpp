@@ -63,7 +63,6 @@ using namespace grk;
 #define TCLAP_NAMESTARTSTRING "-"
 #include "tclap/CmdLine.h"
 #include "spdlog/sinks/basic_file_sink.h"
-#include "exif.h"
 #include "GrkCompress.h"
 
 void exit_func()
@@ -221,6 +220,11 @@ static void compress_help_display(void)
 	fprintf(stdout, "[-t|-tile_dims] <tile width>,<tile height>\n");
 	fprintf(stdout, "    Tile dimensions.\n");
 	fprintf(stdout, "    Default: the dimension of the whole image, thus only one tile.\n");
+	fprintf(stdout, "[-tile_range] <first tile>,<last tile>\n");
+	fprintf(stdout, "    Only compress tiles <first tile> to <last tile> (inclusive) into a\n"
+					"    code stream fragment. Fragments compressed from the same image and\n"
+					"    parameters, but with different tile ranges, can be stitched into a\n"
+					"    single code stream with grk_stitch. Implies -X.\n");
 	fprintf(stdout, "[-p|-progression_order] <LRCP|RLCP|RPCL|PCRL|CPRL>\n");
 	fprintf(stdout, "    Progression order.\n");
 	fprintf(stdout, "    Default: LRCP.\n");
@@ -321,6 +325,23 @@ static void compress_help_display(void)
 	fprintf(stdout, "    Path to T1 plugin.\n");
 	fprintf(stdout, "[-H|-num_threads] <number of threads>\n");
 	fprintf(stdout, "    Number of threads used by libgrokj2k library.\n");
+	fprintf(stdout, "[-j|-batch_jobs] <number of files>\n");
+	fprintf(stdout, "    Only applicable when [in_dir] option is used. Number of files\n"
+					"    compressed concurrently. All files share the library thread pool.\n"
+					"    Default is 1.\n");
+	fprintf(stdout, "[-B|-batch_memory] <memory budget in MB>\n");
+	fprintf(stdout, "    Only applicable when [in_dir] option is used. A new file is only\n"
+					"    started when the estimated memory of all files in flight fits into\n"
+					"    this budget. Default is 0 (no limit).\n");
+	fprintf(stdout, "[-stats]\n");
+	fprintf(stdout, "    Log time spent in each codec stage (MCT, wavelet, T1, T2, tile),\n"
+					"    along with tile, block, pass and byte counts, and current and peak\n"
+					"    memory used by tile windows, code blocks, compressed data and T1.\n");
+	fprintf(stdout, "[-trace_file] <trace file>\n");
+	fprintf(stdout, "    Write a per-tile, per-resolution trace of all codec stages to file,\n"
+					"    in Chrome trace event (JSON) format. Implies -stats. When compressing\n"
+					"    a directory, each file's trace is written to a separate file, named\n"
+					"    by appending the input file name e.g. trace.json => trace_a.json\n");
 	fprintf(stdout, "[-G|-device_id] <device ID>\n");
 	fprintf(stdout, "    (GPU) Specify which GPU accelerator to run codec on.\n");
 	fprintf(stdout, "    A value of -1 will specify all devices.\n");
@@ -344,9 +365,11 @@ static GRK_PROG_ORDER getProgression(const char progression[4])
 	return GRK_PROG_UNKNOWN;
 }
 CompressInitParams::CompressInitParams()
-	: initialized(false), transferExifTags(false), in_image(nullptr), out_buffer(nullptr)
+	: initialized(false), transferExifTags(false), in_image(nullptr), out_buffer(nullptr),
+	  batchJobs(1), batchMemory(0)
 {
 	pluginPath[0] = 0;
+	traceFile[0] = 0;
 	memset(&inputFolder, 0, sizeof(inputFolder));
 	memset(&outFolder, 0, sizeof(outFolder));
 }
@@ -480,6 +503,7 @@ int GrkCompress::main(int argc, char** argv, grk_image* in_image, grk_stream_par
 
 		// cache certain settings
 		grk_cparameters parametersCache = initParams.parameters;
+		BatchScheduler scheduler(initParams.batchJobs, initParams.batchMemory);
 		auto start = std::chrono::high_resolution_clock::now();
 		for(uint32_t i = 0; i < initParams.parameters.repeats; ++i)
 		{
@@ -496,21 +520,16 @@ int GrkCompress::main(int argc, char** argv, grk_image* in_image, grk_stream_par
 			}
 			else
 			{
-				for(const auto& entry :
-					std::filesystem::directory_iterator(initParams.inputFolder.imgdirpath))
-				{
-					initParams.parameters = parametersCache;
-					if(compress(entry.path().filename().string(), &initParams) == 1)
-					{
-						spdlog::info("Compressed file {}", initParams.parameters.outfile);
-						numCompressedFiles++;
-					}
-				}
+				numCompressedFiles += compressBatch(&initParams, &parametersCache, &scheduler);
 			}
 		}
 		auto finish = std::chrono::high_resolution_clock::now();
 		std::chrono::duration<double> elapsed = finish - start;
-		if(numCompressedFiles)
+		if(initParams.inputFolder.set_imgdir)
+		{
+			scheduler.printStats("compress");
+		}
+		else if(numCompressedFiles)
 		{
 			spdlog::info("compress time: {} {}",
 						 (elapsed.count() * 1000) / (double)numCompressedFiles,
@@ -668,6 +687,13 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 												"unsigned integer", cmd);
 		TCLAP::ValueArg<std::string> inputFileArg("i", "in_file", "Input file", false, "", "string",
 												  cmd);
+		TCLAP::ValueArg<uint32_t> batchJobsArg("j", "batch_jobs", "Number of files in flight", false,
+											   1, "unsigned integer", cmd);
+		TCLAP::ValueArg<uint64_t> batchMemoryArg("B", "batch_memory", "Batch memory budget in MB",
+												 false, 0, "unsigned integer", cmd);
+		TCLAP::SwitchArg statsArg("", "stats", "Log codec statistics", cmd);
+		TCLAP::ValueArg<std::string> traceFileArg("", "trace_file", "Trace file", false, "",
+												  "string", cmd);
 		TCLAP::SwitchArg irreversibleArg("I", "irreversible", "Irreversible", cmd);
 		TCLAP::ValueArg<uint32_t> durationArg("J", "duration", "Duration in seconds", false, 0,
 											  "unsigned integer", cmd);
@@ -712,6 +738,8 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 
 		TCLAP::ValueArg<std::string> tilesArg("t", "tile_dims", "Tile dimensions", false, "",
 											  "string", cmd);
+		TCLAP::ValueArg<std::string> tileRangeArg("", "tile_range", "Tile range", false, "",
+												  "string", cmd);
 		TCLAP::ValueArg<uint8_t> tpArg("u", "tile_parts", "Tile part generation", false, 0,
 									   "uint8_t", cmd);
 		TCLAP::SwitchArg verboseArg("v", "verbose", "Verbose", cmd);
@@ -742,16 +770,6 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 			spdlog::set_default_logger(file_logger);
 		}
 		initParams->transferExifTags = transferExifTagsArg.isSet();
-#ifndef GROK_HAVE_EXIFTOOL
-		if(initParams->transferExifTags)
-		{
-			spdlog::warn("Transfer of EXIF tags not supported. Transfer can be achieved by "
-						 "directly calling");
-			spdlog::warn("exiftool after compression as follows: ");
-			spdlog::warn("exiftool -TagsFromFile $SOURCE_FILE -all:all>all:all $DEST_FILE");
-			initParams->transferExifTags = false;
-		}
-#endif
 		inputFolder->set_out_format = false;
 		parameters->raw_cp.width = 0;
 
@@ -766,7 +784,8 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 
 		if(verboseArg.isSet())
 			parameters->verbose = true;
-		else
+		// statistics are logged at info level
+		else if(!statsArg.isSet() && !traceFileArg.isSet())
 			spdlog::set_level(spdlog::level::level_enum::err);
 
 		if(repetitionsArg.isSet())
@@ -787,6 +806,22 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 
 		if(numThreadsArg.isSet())
 			parameters->numThreads = numThreadsArg.getValue();
+		if(batchJobsArg.isSet())
+			initParams->batchJobs = std::max<uint32_t>(batchJobsArg.getValue(), 1);
+		if(batchMemoryArg.isSet())
+			initParams->batchMemory = batchMemoryArg.getValue() * 1024 * 1024;
+		if(statsArg.isSet() || traceFileArg.isSet())
+			parameters->statsFlags = GRK_STATS_ENABLE | GRK_STATS_MEMORY;
+		if(traceFileArg.isSet())
+		{
+			if(grk::strcpy_s(initParams->traceFile, sizeof(initParams->traceFile),
+							 traceFileArg.getValue().c_str()) != 0)
+			{
+				spdlog::error("Path is too long");
+				return 1;
+			}
+			parameters->statsFlags |= GRK_STATS_TRACE;
+		}
 
 		if(deviceIdArg.isSet())
 			parameters->deviceId = deviceIdArg.getValue();
@@ -1657,6 +1692,20 @@ int GrkCompress::parseCommandLine(int argc, char** argv, CompressInitParams* ini
 			parameters->t_height = (uint32_t)t_height;
 			parameters->tile_size_on = true;
 		}
+		if(tileRangeArg.isSet())
+		{
+			uint32_t first = 0, last = 0;
+			if(sscanf(tileRangeArg.getValue().c_str(), "%u,%u", &first, &last) != 2 ||
+			   first > last || last >= UINT16_MAX)
+			{
+				spdlog::error("Invalid tile range {}: must be <first tile>,<last tile> "
+							  "with first tile <= last tile < {}",
+							  tileRangeArg.getValue(), UINT16_MAX);
+				return 1;
+			}
+			parameters->tileRangeBegin = (uint16_t)first;
+			parameters->tileRangeEnd = (uint16_t)(last + 1);
+		}
 		if(tileOffsetArg.isSet())
 		{
 			int32_t off1, off2;
@@ -2015,6 +2064,12 @@ static uint64_t pluginCompressCallback(grk_plugin_compress_user_callback_info* i
 			goto cleanup;
 		}
 		createdImage = true;
+		if(!info->transferExifTags && image->meta && image->meta->exif_buf)
+		{
+			delete[] image->meta->exif_buf;
+			image->meta->exif_buf = nullptr;
+			image->meta->exif_len = 0;
+		}
 	}
 
 	if(info->out_buffer)
@@ -2164,11 +2219,8 @@ static uint64_t pluginCompressCallback(grk_plugin_compress_user_callback_info* i
 		spdlog::error("failed to compress image: grk_compress");
 		goto cleanup;
 	}
-#ifdef GROK_HAVE_EXIFTOOL
-	if(compressedBytes && info->transferExifTags &&
-	   info->compressor_parameters->cod_format == GRK_FMT_JP2)
-		transferExifTags(info->input_file_name, info->output_file_name);
-#endif
+	if(parameters->statsFlags)
+		logStats(codec, info->trace_file);
 
 cleanup:
 	grk_object_unref(codec);
@@ -2189,33 +2241,87 @@ cleanup:
 	return compressedBytes;
 }
 
+static uint64_t fileSize(const char* fileName)
+{
+	std::error_code ec;
+	auto size = std::filesystem::file_size(fileName, ec);
+
+	return ec ? 0 : (uint64_t)size;
+}
+
+uint32_t GrkCompress::compressBatch(CompressInitParams* initParams,
+									const grk_cparameters* parametersCache,
+									BatchScheduler* scheduler)
+{
+	std::vector<std::string> files;
+	for(const auto& entry : std::filesystem::directory_iterator(initParams->inputFolder.imgdirpath))
+		files.push_back(entry.path().filename().string());
+	BatchEstimateFn estimate;
+	if(initParams->batchJobs > 1 && initParams->batchMemory)
+	{
+		estimate = [initParams](const std::string& fileName) {
+			std::string infile =
+				initParams->inputFolder.imgdirpath + std::string(grk::pathSeparator()) + fileName;
+			// uncompressed samples are widened to 32 bit integers, and compressed
+			// output is bounded by the size of the input
+			return fileSize(infile.c_str()) * (sizeof(int32_t) + 1);
+		};
+	}
+	auto job = [this, initParams, parametersCache](const std::string& fileName,
+												   BatchJobResult* result) {
+		// each file in flight gets its own copy of the parameters
+		grk_cparameters parameters = *parametersCache;
+		int rc = compress(fileName, initParams, &parameters);
+		if(rc == 1)
+		{
+			spdlog::info("Compressed file {}", parameters.outfile);
+			result->bytesIn = fileSize(parameters.infile);
+			result->bytesOut = fileSize(parameters.outfile);
+		}
+		return rc;
+	};
+
+	return scheduler->run(files, estimate, job);
+}
+
 // returns 0 if failed, 1 if succeeded,
 // and 2 if file is not suitable for compression
 int GrkCompress::compress(const std::string& inputFile, CompressInitParams* initParams)
+{
+	return compress(inputFile, initParams, &initParams->parameters);
+}
+
+int GrkCompress::compress(const std::string& inputFile, CompressInitParams* initParams,
+						  grk_cparameters* parameters)
 {
 	// clear for next file compress
-	initParams->parameters.write_capture_resolution_from_file = false;
+	parameters->write_capture_resolution_from_file = false;
 	// don't reset format if reading from STDIN
-	if(initParams->parameters.infile[0])
-		initParams->parameters.decod_format = GRK_FMT_UNK;
+	if(parameters->infile[0])
+		parameters->decod_format = GRK_FMT_UNK;
 	if(initParams->inputFolder.set_imgdir)
 	{
 		if(nextFile(inputFile, &initParams->inputFolder,
 					initParams->outFolder.set_imgdir ? &initParams->outFolder
 													 : &initParams->inputFolder,
-					&initParams->parameters))
+					parameters))
 		{
 			return 2;
 		}
 	}
 	grk_plugin_compress_user_callback_info callbackInfo;
 	memset(&callbackInfo, 0, sizeof(grk_plugin_compress_user_callback_info));
-	callbackInfo.compressor_parameters = &initParams->parameters;
+	callbackInfo.compressor_parameters = parameters;
 	callbackInfo.image = initParams->in_image;
 	callbackInfo.out_buffer = initParams->out_buffer;
-	callbackInfo.output_file_name = initParams->parameters.outfile;
-	callbackInfo.input_file_name = initParams->parameters.infile;
+	callbackInfo.output_file_name = parameters->outfile;
+	callbackInfo.input_file_name = parameters->infile;
 	callbackInfo.transferExifTags = initParams->transferExifTags;
+	// each file of a directory gets its own trace
+	std::string traceFile = initParams->traceFile;
+	if(initParams->inputFolder.set_imgdir && !traceFile.empty())
+		traceFile = traceFileForInput(traceFile, inputFile);
+	callbackInfo.trace_file = traceFile.c_str();
 
 	uint64_t compressedBytes = pluginCompressCallback(&callbackInfo);
 	if(initParams->out_buffer)
@@ -18,6 +18,7 @@
 
 #include "common.h"
 #include "IImageFormat.h"
+#include "BatchScheduler.h"
 
 namespace grk
 {
@@ -33,6 +34,12 @@ struct CompressInitParams
 	bool transferExifTags;
 	grk_image* in_image;
 	grk_stream_params* out_buffer;
+	// number of files compressed concurrently when compressing a directory
+	uint32_t batchJobs;
+	// memory budget (in bytes) for all files in flight; 0 means no limit
+	uint64_t batchMemory;
+	// Chrome trace output file (empty for no trace)
+	char traceFile[GRK_PATH_LEN];
 };
 
 class GrkCompress
@@ -47,6 +54,10 @@ class GrkCompress
 	int pluginMain(int argc, char** argv, CompressInitParams* initParams);
 	int parseCommandLine(int argc, char** argv, CompressInitParams* initParams);
 	int compress(const std::string& inputFile, CompressInitParams* initParams);
+	int compress(const std::string& inputFile, CompressInitParams* initParams,
+				 grk_cparameters* parameters);
+	uint32_t compressBatch(CompressInitParams* initParams, const grk_cparameters* parametersCache,
+						   BatchScheduler* scheduler);
 };
 
 } // namespace grk
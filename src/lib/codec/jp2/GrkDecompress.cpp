@@ -58,7 +58,6 @@
 #define TCLAP_NAMESTARTSTRING "-"
 #include "tclap/CmdLine.h"
 #include "spdlog/sinks/basic_file_sink.h"
-#include "exif.h"
 #include "GrkDecompress.h"
 
 namespace grk
@@ -139,6 +138,41 @@ static void decompress_help_display(void)
 					"    Path to T1 plugin.\n");
 	fprintf(stdout, "  [-H | -num_threads] <number of threads>\n"
 					"    Number of threads used by libgrokj2k library.\n");
+	fprintf(stdout, "  [-j | -batch_jobs] <number of files>\n"
+					"    Only applicable when [in_dir] option is used. Number of files\n"
+					"    decompressed concurrently. All files share the library thread pool.\n"
+					"    Default value is 1.\n");
+	fprintf(stdout, "  [-B | -batch_memory] <memory budget in MB>\n"
+					"    Only applicable when [in_dir] option is used. A new file is only\n"
+					"    started when the estimated memory of all files in flight fits into\n"
+					"    this budget. Default value is 0 (no limit).\n");
+	fprintf(stdout, "  [-max_memory] <memory budget in MB>\n"
+					"    Memory budget for decompressing a single image. Tiles are only\n"
+					"    decompressed concurrently while their estimated memory fits into this\n"
+					"    budget, and pooled output strips are freed when over budget.\n"
+					"    Default value is 0 (no limit).\n");
+	fprintf(stdout, "  [-deadline] <deadline in ms>\n"
+					"    Abort decompression of an image once it has taken longer than this.\n"
+					"    Default value is 0 (no deadline).\n");
+	fprintf(stdout, "  [-float_output]\n"
+					"    Output irreversible (9/7) components as 32 bit floating point samples,\n"
+					"    without rounding to integer. Colour and precision conversions are\n"
+					"    skipped. Only supported for TIFF and RAW output.\n");
+	fprintf(stdout, "  [-target_size] <width>,<height>\n"
+					"    Decompress to this output size. The lowest resolution that is at\n"
+					"    least as large is decompressed, and then downscaled with an area\n"
+					"    filter. If width or height is 0, the aspect ratio is preserved.\n"
+					"    Regions are scaled by the same factor. Cannot be combined with -r.\n");
+	fprintf(stdout, "  [-stats]\n"
+					"    Log time spent in each codec stage (marker parsing, T2, T1, wavelet,\n"
+					"    MCT, output, I/O), along with tile, block, pass, byte and packet counts,\n"
+					"    and current and peak memory used by tile windows, code blocks,\n"
+					"    compressed data, strips and T1.\n");
+	fprintf(stdout, "  [-trace_file] <trace file>\n"
+					"    Write a per-tile, per-resolution trace of all codec stages to file,\n"
+					"    in Chrome trace event (JSON) format. Implies -stats. When decompressing\n"
+					"    a directory, each file's trace is written to a separate file, named\n"
+					"    by appending the input file name e.g. trace.json => trace_a.json\n");
 	fprintf(stdout,
 			"  [-c|-compression] <compression method>\n"
 			"   Compress output image data. Currently, this option is only applicable when\n"
@@ -150,6 +184,9 @@ static void decompress_help_display(void)
 					"   Other options are 0 (Z_NO_COMPRESSION) and 1 (Z_BEST_SPEED)\n");
 	fprintf(stdout, "  [-t | -tile_info] <tile index>\n"
 					"    Index of tile to be decompressed\n");
+	fprintf(stdout, "  [-tile_range] <first tile>,<last tile>\n"
+					"    Only decompress tiles <first tile> to <last tile> (inclusive).\n"
+					"    The output image is the bounding box of these tiles.\n");
 	fprintf(
 		stdout,
 		"  [-d | -region] <x0,y0,x1,y1>\n"
@@ -423,6 +460,20 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 												"unsigned integer", cmd);
 		TCLAP::ValueArg<std::string> inputFileArg("i", "in_file", "Input file", false, "", "string",
 												  cmd);
+		TCLAP::ValueArg<uint32_t> batchJobsArg("j", "batch_jobs", "Number of files in flight", false,
+											   1, "unsigned integer", cmd);
+		TCLAP::ValueArg<uint64_t> batchMemoryArg("B", "batch_memory", "Batch memory budget in MB",
+												 false, 0, "unsigned integer", cmd);
+		TCLAP::ValueArg<uint64_t> maxMemoryArg("", "max_memory", "Decompress memory budget in MB",
+											   false, 0, "unsigned integer", cmd);
+		TCLAP::ValueArg<uint32_t> deadlineArg("", "deadline", "Decompress deadline in ms", false, 0,
+											  "unsigned integer", cmd);
+		TCLAP::SwitchArg floatOutputArg("", "float_output", "Floating point output", cmd);
+		TCLAP::ValueArg<std::string> targetSizeArg("", "target_size", "Target output size", false,
+												   "", "string", cmd);
+		TCLAP::SwitchArg statsArg("", "stats", "Log codec statistics", cmd);
+		TCLAP::ValueArg<std::string> traceFileArg("", "trace_file", "Trace file", false, "",
+												  "string", cmd);
 		TCLAP::ValueArg<uint16_t> layerArg("l", "layer", "layer", false, 0, "unsigned integer",
 										   cmd);
 		TCLAP::ValueArg<uint32_t> randomAccessArg("m", "random_access",
@@ -447,6 +498,8 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 		TCLAP::SwitchArg splitPnmArg("s", "split_pnm", "Split PNM", cmd);
 		TCLAP::ValueArg<uint32_t> tileArg("t", "tile_info", "Input tile index", false, 0,
 										  "unsigned integer", cmd);
+		TCLAP::ValueArg<std::string> tileRangeArg("", "tile_range", "Tile range", false, "",
+												  "string", cmd);
 		TCLAP::SwitchArg upsampleArg("u", "upsample", "Upsample", cmd);
 		TCLAP::SwitchArg verboseArg("v", "verbose", "Verbose", cmd);
 		TCLAP::SwitchArg transferExifTagsArg("V", "transfer_exif_tags", "Transfer Exif tags", cmd);
@@ -464,7 +517,9 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 		// disable verbose mode so we don't write info or warnings to stdout
 		if(useStdio)
 			parameters->verbose_ = false;
-		if(!parameters->verbose_)
+		// statistics are logged at info level
+		bool logStats = !useStdio && (statsArg.isSet() || traceFileArg.isSet());
+		if(!parameters->verbose_ && !logStats)
 			spdlog::set_level(spdlog::level::level_enum::err);
 
 		if(logfileArg.isSet())
@@ -474,16 +529,6 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 		}
 
 		initParams->transferExifTags = transferExifTagsArg.isSet();
-#ifndef GROK_HAVE_EXIFTOOL
-		if(initParams->transferExifTags)
-		{
-			spdlog::warn("Transfer of EXIF tags not supported. Transfer can be achieved by "
-						 "directly calling");
-			spdlog::warn("exiftool after decompression as follows: ");
-			spdlog::warn("exiftool -TagsFromFile $SOURCE_FILE -all:all>all:all $DEST_FILE");
-			initParams->transferExifTags = false;
-		}
-#endif
 		parameters->io_xml = xmlArg.isSet();
 		parameters->force_rgb = forceRgbArg.isSet();
 		if(upsampleArg.isSet())
@@ -656,10 +701,78 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 		parameters->singleTileDecompress = tileArg.isSet();
 		if(tileArg.isSet())
 			parameters->tileIndex = (uint16_t)tileArg.getValue();
+		if(tileRangeArg.isSet())
+		{
+			uint32_t first = 0, last = 0;
+			if(sscanf(tileRangeArg.getValue().c_str(), "%u,%u", &first, &last) != 2 ||
+			   first > last || last >= UINT16_MAX)
+			{
+				spdlog::error("Invalid tile range {}: must be <first tile>,<last tile> "
+							  "with first tile <= last tile < {}",
+							  tileRangeArg.getValue(), UINT16_MAX);
+				return 1;
+			}
+			if(tileArg.isSet() || decodeRegionArg.isSet())
+			{
+				spdlog::error("Tile range cannot be combined with tile index or region");
+				return 1;
+			}
+			parameters->tileRangeBegin = (uint16_t)first;
+			parameters->tileRangeEnd = (uint16_t)(last + 1);
+		}
 		if(precisionArg.isSet() && !parsePrecision(precisionArg.getValue().c_str(), parameters))
 			return 1;
 		if(numThreadsArg.isSet())
 			parameters->numThreads = numThreadsArg.getValue();
+		if(batchJobsArg.isSet())
+			initParams->batchJobs = std::max<uint32_t>(batchJobsArg.getValue(), 1);
+		if(batchMemoryArg.isSet())
+			initParams->batchMemory = batchMemoryArg.getValue() * 1024 * 1024;
+		if(maxMemoryArg.isSet())
+			parameters->core.max_memory = maxMemoryArg.getValue() * 1024 * 1024;
+		if(deadlineArg.isSet())
+			parameters->core.deadline_ms = deadlineArg.getValue();
+		if(floatOutputArg.isSet())
+		{
+			auto fmt = parameters->cod_format;
+			if(fmt != GRK_FMT_TIF && fmt != GRK_FMT_RAW && fmt != GRK_FMT_RAWL)
+			{
+				spdlog::error("Floating point output only supported for TIFF and RAW formats");
+				return 1;
+			}
+			parameters->core.float_output = true;
+		}
+		if(targetSizeArg.isSet())
+		{
+			uint32_t width = 0, height = 0;
+			if(sscanf(targetSizeArg.getValue().c_str(), "%u,%u", &width, &height) != 2 ||
+			   (width == 0 && height == 0))
+			{
+				spdlog::error("Invalid target size {}: must be <width>,<height> "
+							  "with at least one of them non-zero",
+							  targetSizeArg.getValue());
+				return 1;
+			}
+			if(reduceArg.isSet())
+			{
+				spdlog::error("Target size cannot be combined with resolution reduction");
+				return 1;
+			}
+			parameters->core.target_width = width;
+			parameters->core.target_height = height;
+		}
+		if(statsArg.isSet() || traceFileArg.isSet())
+			parameters->core.statsFlags_ = GRK_STATS_ENABLE | GRK_STATS_MEMORY;
+		if(traceFileArg.isSet())
+		{
+			if(grk::strcpy_s(initParams->traceFile, sizeof(initParams->traceFile),
+							 traceFileArg.getValue().c_str()) != 0)
+			{
+				spdlog::error("Path is too long");
+				return 1;
+			}
+			parameters->core.statsFlags_ |= GRK_STATS_TRACE;
+		}
 		if(decodeRegionArg.isSet())
 		{
 			size_t size_optarg = (size_t)strlen(decodeRegionArg.getValue().c_str()) + 1U;
@@ -759,12 +872,23 @@ static int decompress_callback(grk_plugin_decompress_callback_info* info);
 // returns 0 for failure, 1 for success, and 2 if file is not suitable for decoding
 int GrkDecompress::decompress(const std::string& fileName, DecompressInitParams* initParams)
 {
+	return decompress(fileName, initParams, &initParams->parameters);
+}
+
+int GrkDecompress::decompress(const std::string& fileName, DecompressInitParams* initParams,
+							  grk_decompress_parameters* parameters)
+{
+	traceFile = initParams->traceFile;
+	// each file of a directory gets its own trace
+	if(initParams->inputFolder.set_imgdir && !traceFile.empty())
+		traceFile = traceFileForInput(traceFile, fileName);
+	transferExifTags = initParams->transferExifTags;
 	if(initParams->inputFolder.set_imgdir)
 	{
 		if(nextFile(fileName, &initParams->inputFolder,
 					initParams->outFolder.set_imgdir ? &initParams->outFolder
 													 : &initParams->inputFolder,
-					&initParams->parameters))
+					parameters))
 		{
 			return 2;
 		}
@@ -773,7 +897,7 @@ int GrkDecompress::decompress(const std::string& fileName, DecompressInitParams*
 	memset(&info, 0, sizeof(grk_plugin_decompress_callback_info));
 	info.decod_format = GRK_CODEC_UNK;
 	info.decompress_flags = GRK_DECODE_ALL;
-	info.decompressor_parameters = &initParams->parameters;
+	info.decompressor_parameters = parameters;
 	info.user_data = this;
 	info.cod_format =
 		info.cod_format != GRK_FMT_UNK ? info.cod_format : info.decompressor_parameters->cod_format;
@@ -794,15 +918,97 @@ int GrkDecompress::decompress(const std::string& fileName, DecompressInitParams*
 		grk_object_unref(info.codec);
 		return 0;
 	}
-#ifdef GROK_HAVE_EXIFTOOL
-	if(initParams->transferExifTags && initParams->parameters.decod_format == GRK_CODEC_JP2)
-		transferExifTags(initParams->parameters.infile, initParams->parameters.outfile);
-#endif
 	grk_object_unref(info.codec);
 	info.codec = nullptr;
 	return 1;
 }
 
+static uint64_t fileSize(const char* fileName)
+{
+	std::error_code ec;
+	auto size = std::filesystem::file_size(fileName, ec);
+
+	return ec ? 0 : (uint64_t)size;
+}
+
+uint64_t GrkDecompress::estimateMemory(const std::string& fileName,
+									   DecompressInitParams* initParams)
+{
+	std::string infile =
+		initParams->inputFolder.imgdirpath + std::string(pathSeparator()) + fileName;
+	GRK_CODEC_FORMAT fmt;
+	if(!grk_decompress_detect_format(infile.c_str(), &fmt) || fmt == GRK_CODEC_UNK)
+		return 0;
+	uint64_t estimate = fileSize(infile.c_str());
+
+	// peek at main header to get image dimensions
+	grk_stream_params stream_params;
+	memset(&stream_params, 0, sizeof(stream_params));
+	stream_params.file = infile.c_str();
+	grk_decompress_core_params core = initParams->parameters.core;
+	core.io_buffer_callback = nullptr;
+	core.io_user_data = nullptr;
+	core.io_register_client_callback = nullptr;
+	auto codec = grk_decompress_init(&stream_params, &core);
+	if(!codec)
+		return estimate;
+	grk_header_info header_info;
+	memset(&header_info, 0, sizeof(header_info));
+	if(grk_decompress_read_header(codec, &header_info))
+	{
+		auto img = grk_decompress_get_composited_image(codec);
+		if(img)
+		{
+			uint64_t samples = 0;
+			for(uint16_t i = 0; i < img->numcomps; ++i)
+			{
+				auto comp = img->comps + i;
+				if(!comp->dx || !comp->dy)
+					continue;
+				uint64_t w = ((uint64_t)(img->x1 - img->x0) + comp->dx - 1) / comp->dx;
+				uint64_t h = ((uint64_t)(img->y1 - img->y0) + comp->dy - 1) / comp->dy;
+				samples += (w >> core.reduce) * (h >> core.reduce);
+			}
+			// decompressed samples are stored as 32 bit integers, and
+			// output formats keep a copy of (part of) the image while encoding
+			estimate += samples * sizeof(int32_t) * 2;
+		}
+	}
+	grk_object_unref(codec);
+
+	return estimate;
+}
+
+uint32_t GrkDecompress::decompressBatch(DecompressInitParams* initParams, BatchScheduler* scheduler)
+{
+	std::vector<std::string> files;
+	for(const auto& entry : std::filesystem::directory_iterator(initParams->inputFolder.imgdirpath))
+		files.push_back(entry.path().filename().string());
+	BatchEstimateFn estimate;
+	if(initParams->batchJobs > 1 && initParams->batchMemory)
+	{
+		estimate = [this, initParams](const std::string& fileName) {
+			return estimateMemory(fileName, initParams);
+		};
+	}
+	auto job = [this, initParams](const std::string& fileName, BatchJobResult* result) {
+		// each file in flight gets its own decompressor state and parameters
+		GrkDecompress worker;
+		worker.storeToDisk = storeToDisk;
+		grk_decompress_parameters parameters = initParams->parameters;
+		parameters.user_data = &worker;
+		int rc = worker.decompress(fileName, initParams, &parameters);
+		if(rc == 1)
+		{
+			result->bytesIn = fileSize(parameters.infile);
+			result->bytesOut = fileSize(parameters.outfile);
+		}
+		return rc;
+	};
+
+	return scheduler->run(files, estimate, job);
+}
+
 int GrkDecompress::pluginMain(int argc, char** argv, DecompressInitParams* initParams)
 {
 	grk_dircnt* dirptr = nullptr;
@@ -1186,8 +1392,19 @@ int GrkDecompress::preProcess(grk_plugin_decompress_callback_info* info)
 			goto cleanup;
 		}
 	}
-	if(!grk_decompress_set_window(info->codec, parameters->dw_x0, parameters->dw_y0,
-								  parameters->dw_x1, parameters->dw_y1))
+	if(parameters->tileRangeEnd)
+	{
+		std::vector<uint16_t> tiles;
+		for(uint32_t i = parameters->tileRangeBegin; i < parameters->tileRangeEnd; ++i)
+			tiles.push_back((uint16_t)i);
+		if(!grk_decompress_set_tiles(info->codec, tiles.data(), (uint16_t)tiles.size()))
+		{
+			spdlog::error("grk_decompress: failed to set the decompressed tiles");
+			goto cleanup;
+		}
+	}
+	else if(!grk_decompress_set_window(info->codec, parameters->dw_x0, parameters->dw_y0,
+									   parameters->dw_x1, parameters->dw_y1))
 	{
 		spdlog::error("grk_decompress: failed to set the decompressed area");
 		goto cleanup;
@@ -1210,6 +1427,13 @@ int GrkDecompress::preProcess(grk_plugin_decompress_callback_info* info)
 			goto cleanup;
 		}
 	}
+	// Exif is only carried over to the output file on request
+	if(!transferExifTags && info->image->meta && info->image->meta->exif_buf)
+	{
+		delete[] info->image->meta->exif_buf;
+		info->image->meta->exif_buf = nullptr;
+		info->image->meta->exif_len = 0;
+	}
 	if(!encodeHeader(info))
 		goto cleanup;
 	failed = false;
@@ -1244,10 +1468,11 @@ int GrkDecompress::postProcess(grk_plugin_decompress_callback_info* info)
 							  : info->output_file_name;
 	if(image->meta)
 	{
+		auto cod_format = info->decompressor_parameters->cod_format;
 		if(image->meta->xmp_buf)
 		{
-			bool canStoreXMP = (info->decompressor_parameters->cod_format == GRK_FMT_TIF ||
-								info->decompressor_parameters->cod_format == GRK_FMT_PNG);
+			bool canStoreXMP = (cod_format == GRK_FMT_TIF || cod_format == GRK_FMT_PNG ||
+								cod_format == GRK_FMT_JPG);
 			if(!canStoreXMP)
 			{
 				spdlog::warn(" Input file `{}` contains XMP meta-data,\nbut the file format for "
@@ -1257,7 +1482,7 @@ int GrkDecompress::postProcess(grk_plugin_decompress_callback_info* info)
 		}
 		if(image->meta->iptc_buf)
 		{
-			bool canStoreIPTC_IIM = (info->decompressor_parameters->cod_format == GRK_FMT_TIF);
+			bool canStoreIPTC_IIM = (cod_format == GRK_FMT_TIF);
 			if(!canStoreIPTC_IIM)
 			{
 				spdlog::warn(
@@ -1266,6 +1491,17 @@ int GrkDecompress::postProcess(grk_plugin_decompress_callback_info* info)
 					infile, outfile);
 			}
 		}
+		if(image->meta->exif_buf)
+		{
+			bool canStoreExif = (cod_format == GRK_FMT_TIF || cod_format == GRK_FMT_PNG ||
+								 cod_format == GRK_FMT_JPG);
+			if(!canStoreExif)
+			{
+				spdlog::warn(" Input file `{}` contains Exif meta-data,\nbut the file format for "
+							 "output file `{}` does not support storage of this data.",
+							 infile, outfile);
+			}
+		}
 	}
 	if(storeToDisk)
 	{
@@ -1283,6 +1519,8 @@ int GrkDecompress::postProcess(grk_plugin_decompress_callback_info* info)
 	}
 	failed = false;
 cleanup:
+	if(info->decompressor_parameters->core.statsFlags_)
+		logStats(info->codec, traceFile.c_str());
 	grk_object_unref(info->codec);
 	info->codec = nullptr;
 	if(image && imageNeedsDestroy)
@@ -1321,6 +1559,7 @@ int GrkDecompress::main(int argc, char** argv)
 			rc = EXIT_SUCCESS;
 			goto cleanup;
 		}
+		BatchScheduler scheduler(initParams.batchJobs, initParams.batchMemory);
 		auto start = std::chrono::high_resolution_clock::now();
 		for(uint32_t i = 0; i < initParams.parameters.repeats; ++i)
 		{
@@ -1339,15 +1578,13 @@ int GrkDecompress::main(int argc, char** argv)
 			}
 			else
 			{
-				for(const auto& entry :
-					std::filesystem::directory_iterator(initParams.inputFolder.imgdirpath))
-				{
-					if(decompress(entry.path().filename().string(), &initParams) == 1)
-						numDecompressed++;
-				}
+				numDecompressed += decompressBatch(&initParams, &scheduler);
 			}
 		}
-		printTiming(numDecompressed, std::chrono::high_resolution_clock::now() - start);
+		if(initParams.inputFolder.set_imgdir)
+			scheduler.printStats("decompress");
+		else
+			printTiming(numDecompressed, std::chrono::high_resolution_clock::now() - start);
 	}
 	catch([[maybe_unused]] std::bad_alloc& ba)
 	{
@@ -1360,7 +1597,8 @@ cleanup:
 	grk_deinitialize();
 	return rc;
 }
-GrkDecompress::GrkDecompress() : storeToDisk(true), imageFormat(nullptr) {}
+GrkDecompress::GrkDecompress() : storeToDisk(true), transferExifTags(false), imageFormat(nullptr)
+{}
 GrkDecompress::~GrkDecompress(void)
 {
 	delete imageFormat;
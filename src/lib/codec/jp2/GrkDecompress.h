@@ -18,14 +18,17 @@
 
 #include "common.h"
 #include "IImageFormat.h"
+#include "BatchScheduler.h"
 
 namespace grk
 {
 struct DecompressInitParams
 {
-	DecompressInitParams() : initialized(false), transferExifTags(false)
+	DecompressInitParams()
+		: initialized(false), transferExifTags(false), batchJobs(1), batchMemory(0)
 	{
 		pluginPath[0] = 0;
+		traceFile[0] = 0;
 		memset(&inputFolder, 0, sizeof(inputFolder));
 		memset(&outFolder, 0, sizeof(outFolder));
 		memset(&parameters, 0, sizeof(grk_decompress_parameters));
@@ -41,6 +44,12 @@ struct DecompressInitParams
 	grk_img_fol inputFolder;
 	grk_img_fol outFolder;
 	bool transferExifTags;
+	// number of files decompressed concurrently when decompressing a directory
+	uint32_t batchJobs;
+	// memory budget (in bytes) for all files in flight; 0 means no limit
+	uint64_t batchMemory;
+	// Chrome trace output file (empty for no trace)
+	char traceFile[GRK_PATH_LEN];
 };
 
 class GrkDecompress
@@ -57,6 +66,10 @@ class GrkDecompress
 	bool encodeInit(grk_plugin_decompress_callback_info* info);
 	// returns 0 for failure, 1 for success, and 2 if file is not suitable for decoding
 	int decompress(const std::string& fileName, DecompressInitParams* initParams);
+	int decompress(const std::string& fileName, DecompressInitParams* initParams,
+				   grk_decompress_parameters* parameters);
+	uint32_t decompressBatch(DecompressInitParams* initParams, BatchScheduler* scheduler);
+	uint64_t estimateMemory(const std::string& fileName, DecompressInitParams* initParams);
 	int pluginMain(int argc, char** argv, DecompressInitParams* initParams);
 	bool parsePrecision(const char* option, grk_decompress_parameters* parameters);
 	int loadImages(grk_dircnt* dirptr, char* imgdirpath);
@@ -69,7 +82,10 @@ class GrkDecompress
 	void printTiming(uint32_t num_images, std::chrono::duration<double> elapsed);
 
 	bool storeToDisk;
+	bool transferExifTags;
 	IImageFormat* imageFormat;
+	// trace output file for current decompress (empty for no trace)
+	std::string traceFile;
 };
 
 } // namespace grk
@@ -0,0 +1,149 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "grk_config.h"
+#include "common.h"
+#define TCLAP_NAMESTARTSTRING "-"
+#include "tclap/CmdLine.h"
+#include "GrkStitch.h"
+
+namespace grk
+{
+
+struct StitchParams
+{
+	std::vector<std::string> fragments;
+	std::string outfile;
+};
+
+static void stitch_help_display(void)
+{
+	fprintf(stdout,
+			"\nThis is the grk_stitch utility from the Grok project.\n"
+			"It stitches code stream fragments, compressed by grk_compress from different\n"
+			"tile ranges of the same image, into a single code stream, without\n"
+			"decompressing them.\n"
+			"It has been compiled against Grok library v%s.\n\n",
+			grk_version());
+
+	fprintf(stdout, "Parameters:\n");
+	fprintf(stdout, "-----------\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, "  -i <compressed file>\n");
+	fprintf(stdout, "    REQUIRED\n");
+	fprintf(stdout, "    Code stream fragment: J2K-file or JP2-file. Repeat for each fragment.\n");
+	fprintf(stdout, "    Tile parts are written in the order in which fragments are given.\n");
+	fprintf(stdout, "  -o <compressed file>\n");
+	fprintf(stdout, "    REQUIRED\n");
+	fprintf(stdout, "    Output J2K code stream.\n");
+	fprintf(stdout, "\n");
+}
+
+class StitchOutput : public TCLAP::StdOutput
+{
+  public:
+	virtual void usage([[maybe_unused]] TCLAP::CmdLineInterface& c)
+	{
+		stitch_help_display();
+	}
+};
+
+static int parseCommandLine(int argc, char** argv, StitchParams* params)
+{
+	try
+	{
+		TCLAP::CmdLine cmd("grk_stitch command line", ' ', grk_version());
+
+		// set the output
+		StitchOutput output;
+		cmd.setOutput(&output);
+
+		TCLAP::MultiArg<std::string> inputArg("i", "input", "fragment file", true, "string", cmd);
+		TCLAP::ValueArg<std::string> outputArg("o", "output", "output file", true, "", "string",
+											   cmd);
+
+		cmd.parse(argc, argv);
+
+		for(auto& fragment : inputArg.getValue())
+		{
+			GRK_CODEC_FORMAT fmt;
+			if(!grk_decompress_detect_format(fragment.c_str(), &fmt))
+			{
+				spdlog::error("Unknown input file format: {} \n"
+							  "        Known file formats are *.j2k, *.jp2 or *.jpc",
+							  fragment);
+				return 1;
+			}
+		}
+		params->fragments = inputArg.getValue();
+		params->outfile = outputArg.getValue();
+	}
+	catch(TCLAP::ArgException& e) // catch any exceptions
+	{
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int GrkStitch::main(int argc, char* argv[])
+{
+	StitchParams params;
+
+	grk_initialize(nullptr, 0);
+	grk_set_msg_handlers(infoCallback, nullptr, warningCallback, nullptr, errorCallback, nullptr);
+
+	int rc = EXIT_FAILURE;
+	if(parseCommandLine(argc, argv, &params) == 0)
+	{
+		std::vector<grk_stream_params> fragments(params.fragments.size());
+		for(size_t i = 0; i < fragments.size(); ++i)
+		{
+			memset(&fragments[i], 0, sizeof(grk_stream_params));
+			fragments[i].file = params.fragments[i].c_str();
+		}
+		grk_stream_params dest;
+		memset(&dest, 0, sizeof(dest));
+		dest.file = params.outfile.c_str();
+		auto start = std::chrono::high_resolution_clock::now();
+		uint64_t bytesWritten = grk_stitch(fragments.data(), (uint32_t)fragments.size(), &dest);
+		if(bytesWritten)
+		{
+			std::chrono::duration<double> elapsed =
+				std::chrono::high_resolution_clock::now() - start;
+			spdlog::info("stitched {} fragments to {} ({} bytes) in {} ms", fragments.size(),
+						 params.outfile, bytesWritten, elapsed.count() * 1000);
+			rc = EXIT_SUCCESS;
+		}
+		else
+		{
+			spdlog::error("grk_stitch: failed to stitch fragments");
+		}
+	}
+	grk_deinitialize();
+
+	return rc;
+}
+
+} // namespace grk
@@ -0,0 +1,219 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+ *
+ *    This source code incorporates work covered by the BSD 2-clause license.
+ *    Please see the LICENSE file in the root directory for details.
+ *
+ */
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "grk_config.h"
+#include "common.h"
+#define TCLAP_NAMESTARTSTRING "-"
+#include "tclap/CmdLine.h"
+#include "GrkTranscode.h"
+
+namespace grk
+{
+
+struct TranscodeParams
+{
+	std::string infile;
+	std::string outfile;
+	grk_transcode_params transcode;
+};
+
+static void transcode_help_display(void)
+{
+	fprintf(stdout,
+			"\nThis is the grk_transcode utility from the Grok project.\n"
+			"It keeps the first quality layers and/or discards the highest resolutions\n"
+			"of a JPEG 2000 image, without decompressing it, changes its block coder,\n"
+			"or crops it to a rectangle of tiles.\n"
+			"It has been compiled against Grok library v%s.\n\n",
+			grk_version());
+
+	fprintf(stdout, "Parameters:\n");
+	fprintf(stdout, "-----------\n");
+	fprintf(stdout, "\n");
+	fprintf(stdout, "  -i <compressed file>\n");
+	fprintf(stdout, "    REQUIRED\n");
+	fprintf(stdout, "    Currently accepts J2K-files and JP2-files. The file type\n");
+	fprintf(stdout, "    is identified based on its suffix.\n");
+	fprintf(stdout, "  -o <compressed file>\n");
+	fprintf(stdout, "    REQUIRED\n");
+	fprintf(stdout, "    Output J2K code stream.\n");
+	fprintf(stdout, "  -l <number of quality layers>\n");
+	fprintf(stdout, "    OPTIONAL\n");
+	fprintf(stdout, "    Keep only the first <number of quality layers> layers.\n");
+	fprintf(stdout, "    By default all layers are kept.\n");
+	fprintf(stdout, "  -r <reduce factor>\n");
+	fprintf(stdout, "    OPTIONAL\n");
+	fprintf(stdout, "    Discard the <reduce factor> highest resolutions: image dimensions\n");
+	fprintf(stdout, "    are divided by 2^(reduce factor).\n");
+	fprintf(stdout, "    By default all resolutions are kept.\n");
+	fprintf(stdout, "  -b <block coder>\n");
+	fprintf(stdout, "    OPTIONAL\n");
+	fprintf(stdout, "    Re-compress code blocks with a different block coder: either\n");
+	fprintf(stdout, "    \"ht\" (High Throughput JPEG 2000) or \"part1\" (JPEG 2000 Part-1).\n");
+	fprintf(stdout, "    Code blocks are decompressed to wavelet coefficients and re-compressed\n");
+	fprintf(stdout, "    into a single lossless quality layer, so that the decompressed image\n");
+	fprintf(stdout, "    is unchanged.\n");
+	fprintf(stdout, "    Cannot be combined with -r.\n");
+	fprintf(stdout, "    By default packets are copied unchanged.\n");
+	fprintf(stdout, "  -c <x0,y0,x1,y1>\n");
+	fprintf(stdout, "    OPTIONAL\n");
+	fprintf(stdout, "    Crop to the tiles intersecting the region with top left corner\n");
+	fprintf(stdout, "    (x0,y0) and bottom right corner (x1,y1), in reference grid\n");
+	fprintf(stdout, "    coordinates.\n");
+	fprintf(stdout, "    Tile parts are copied without reading packets, and tiles keep their\n");
+	fprintf(stdout, "    reference grid coordinates.\n");
+	fprintf(stdout, "    Cannot be combined with -l, -r or -b.\n");
+	fprintf(stdout, "\n");
+}
+
+class TranscodeOutput : public TCLAP::StdOutput
+{
+  public:
+	virtual void usage([[maybe_unused]] TCLAP::CmdLineInterface& c)
+	{
+		transcode_help_display();
+	}
+};
+
+static int parseCommandLine(int argc, char** argv, TranscodeParams* params)
+{
+	try
+	{
+		TCLAP::CmdLine cmd("grk_transcode command line", ' ', grk_version());
+
+		// set the output
+		TranscodeOutput output;
+		cmd.setOutput(&output);
+
+		TCLAP::ValueArg<std::string> inputArg("i", "input", "input file", true, "", "string", cmd);
+		TCLAP::ValueArg<std::string> outputArg("o", "output", "output file", true, "", "string",
+											   cmd);
+		TCLAP::ValueArg<uint16_t> layerArg("l", "layer", "number of quality layers to keep",
+										   false, 0, "unsigned integer", cmd);
+		TCLAP::ValueArg<uint32_t> reduceArg("r", "reduce", "number of resolutions to discard",
+											false, 0, "unsigned integer", cmd);
+		TCLAP::ValueArg<std::string> blockCoderArg("b", "block-coder", "block coder", false, "",
+												   "string", cmd);
+		TCLAP::ValueArg<std::string> cropArg("c", "crop", "crop region", false, "", "string", cmd);
+
+		cmd.parse(argc, argv);
+
+		GRK_CODEC_FORMAT fmt;
+		if(!grk_decompress_detect_format(inputArg.getValue().c_str(), &fmt))
+		{
+			spdlog::error("Unknown input file format: {} \n"
+						  "        Known file formats are *.j2k, *.jp2 or *.jpc",
+						  inputArg.getValue());
+			return 1;
+		}
+		params->infile = inputArg.getValue();
+		params->outfile = outputArg.getValue();
+		params->transcode.max_layers = layerArg.getValue();
+		if(reduceArg.getValue() >= GRK_J2K_MAXRLVLS)
+		{
+			spdlog::error("Reduce factor {} must be less than {}", reduceArg.getValue(),
+						  GRK_J2K_MAXRLVLS);
+			return 1;
+		}
+		params->transcode.reduce = (uint8_t)reduceArg.getValue();
+		if(blockCoderArg.isSet())
+		{
+			auto blockCoder = blockCoderArg.getValue();
+			if(blockCoder == "ht")
+			{
+				params->transcode.block_coder = GRK_BLOCK_CODER_HT;
+			}
+			else if(blockCoder == "part1")
+			{
+				params->transcode.block_coder = GRK_BLOCK_CODER_PART1;
+			}
+			else
+			{
+				spdlog::error("Unknown block coder {}: must be either ht or part1", blockCoder);
+				return 1;
+			}
+		}
+		if(cropArg.isSet())
+		{
+			auto& crop = params->transcode;
+			if(sscanf(cropArg.getValue().c_str(), "%u,%u,%u,%u", &crop.crop_x0, &crop.crop_y0,
+					  &crop.crop_x1, &crop.crop_y1) != 4 ||
+			   crop.crop_x0 >= crop.crop_x1 || crop.crop_y0 >= crop.crop_y1)
+			{
+				spdlog::error("Invalid crop region {}: must be x0,y0,x1,y1 "
+							  "with x0 < x1 and y0 < y1",
+							  cropArg.getValue());
+				return 1;
+			}
+		}
+	}
+	catch(TCLAP::ArgException& e) // catch any exceptions
+	{
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int GrkTranscode::main(int argc, char* argv[])
+{
+	TranscodeParams params;
+	memset(&params.transcode, 0, sizeof(params.transcode));
+
+	grk_initialize(nullptr, 0);
+	grk_set_msg_handlers(infoCallback, nullptr, warningCallback, nullptr, errorCallback, nullptr);
+
+	int rc = EXIT_FAILURE;
+	if(parseCommandLine(argc, argv, &params) == 0)
+	{
+		grk_stream_params src;
+		memset(&src, 0, sizeof(src));
+		src.file = params.infile.c_str();
+		grk_stream_params dest;
+		memset(&dest, 0, sizeof(dest));
+		dest.file = params.outfile.c_str();
+		auto start = std::chrono::high_resolution_clock::now();
+		uint64_t bytesWritten = grk_transcode(&src, &dest, &params.transcode);
+		if(bytesWritten)
+		{
+			std::chrono::duration<double> elapsed =
+				std::chrono::high_resolution_clock::now() - start;
+			spdlog::info("transcoded {} to {} ({} bytes) in {} ms", params.infile, params.outfile,
+						 bytesWritten, elapsed.count() * 1000);
+			rc = EXIT_SUCCESS;
+		}
+		else
+		{
+			spdlog::error("grk_transcode: failed to transcode {}", params.infile);
+		}
+	}
+	grk_deinitialize();
+
+	return rc;
+}
+
+} // namespace grk
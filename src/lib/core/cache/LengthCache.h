@@ -103,6 +103,9 @@ struct TilePartLengthInfo
 typedef std::vector<TilePartLengthInfo> TL_INFO_VEC;
 typedef std::map<uint16_t, TL_INFO_VEC*> TL_MAP;
 
+// TLM marker segment holds at most this many 16-bit index/32-bit length pairs
+const uint32_t maxTLMTileParts = (USHRT_MAX - 4) / 6;
+
 struct TileLengthMarkers
 {
 	explicit TileLengthMarkers(uint16_t numSignalledTiles);
@@ -97,4 +97,109 @@ void grk_free(void* ptr)
 {
 	free(ptr);
 }
+
+static const char* memCategoryNames[GRK_NUM_MEM_CATEGORIES] = {"tile_window", "codeblock",
+																 "compressed", "strip", "t1"};
+const char* memCategoryName(GRK_MEM_CATEGORY category)
+{
+	return category < GRK_NUM_MEM_CATEGORIES ? memCategoryNames[category] : "unknown";
+}
+
+thread_local MemAccount* MemAccount::current_ = nullptr;
+
+MemAccount::MemAccount(void) : totalCurrentBytes_(0), totalPeakBytes_(0)
+{
+	for(uint32_t i = 0; i < GRK_NUM_MEM_CATEGORIES; ++i)
+	{
+		currentBytes_[i] = 0;
+		peakBytes_[i] = 0;
+	}
+}
+MemAccount* MemAccount::current(void)
+{
+	return current_;
+}
+void MemAccount::updatePeak(std::atomic<uint64_t>& peak, uint64_t val)
+{
+	uint64_t prev = peak;
+	while(val > prev && !peak.compare_exchange_weak(prev, val))
+	{
+	}
+}
+void MemAccount::add(GRK_MEM_CATEGORY category, uint64_t bytes)
+{
+	if(category >= GRK_NUM_MEM_CATEGORIES)
+		return;
+	updatePeak(peakBytes_[category], currentBytes_[category] += bytes);
+	updatePeak(totalPeakBytes_, totalCurrentBytes_ += bytes);
+}
+void MemAccount::sub(GRK_MEM_CATEGORY category, uint64_t bytes)
+{
+	if(category >= GRK_NUM_MEM_CATEGORIES)
+		return;
+	currentBytes_[category] -= bytes;
+	totalCurrentBytes_ -= bytes;
+}
+void MemAccount::get(grk_mem_stats* stats) const
+{
+	for(uint32_t i = 0; i < GRK_NUM_MEM_CATEGORIES; ++i)
+	{
+		stats->categories[i].current = currentBytes_[i];
+		stats->categories[i].peak = peakBytes_[i];
+	}
+	stats->total.current = totalCurrentBytes_;
+	stats->total.peak = totalPeakBytes_;
+}
+
+MemBudget::MemBudget(void) : limit_(0), used_(0), numReservations_(0) {}
+void MemBudget::setLimit(uint64_t limit)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	limit_ = limit;
+}
+bool MemBudget::enabled(void) const
+{
+	return limit_ != 0;
+}
+void MemBudget::acquire(uint64_t bytes)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	cond_.wait(lk, [this, bytes] {
+		return !limit_ || numReservations_ == 0 || used_ + bytes <= limit_;
+	});
+	used_ += bytes;
+	numReservations_++;
+}
+bool MemBudget::tryAcquire(uint64_t bytes)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	if(limit_ && used_ + bytes > limit_)
+		return false;
+	used_ += bytes;
+
+	return true;
+}
+void MemBudget::charge(uint64_t bytes)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	used_ += bytes;
+}
+void MemBudget::releaseReservation(uint64_t bytes)
+{
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		assert(numReservations_);
+		numReservations_--;
+		used_ = bytes < used_ ? used_ - bytes : 0;
+	}
+	cond_.notify_all();
+}
+void MemBudget::release(uint64_t bytes)
+{
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		used_ = bytes < used_ ? used_ - bytes : 0;
+	}
+	cond_.notify_all();
+}
 } // namespace grk
@@ -20,6 +20,10 @@
  */
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
 #if defined(__GNUC__) && !defined(GROK_SKIP_POISON)
 #pragma GCC poison malloc calloc realloc free
 #endif
@@ -60,4 +64,190 @@ void* grk_realloc(void* m, size_t s);
  */
 void grk_free(void* m);
 
+const char* memCategoryName(GRK_MEM_CATEGORY category);
+
+/**
+ * Per-codec memory accounting: current and peak bytes for each category.
+ *
+ * Buffer owners charge the account that is current on the allocating
+ * thread, via MemTracker. The codec makes its account current with
+ * MemAccountScope on entry, and the account is carried over to tasks
+ * scheduled on the executor.
+ */
+class MemAccount
+{
+  public:
+	MemAccount(void);
+	void add(GRK_MEM_CATEGORY category, uint64_t bytes);
+	void sub(GRK_MEM_CATEGORY category, uint64_t bytes);
+	void get(grk_mem_stats* stats) const;
+	/**
+	 * Get account that is current on calling thread
+	 *
+	 * @return current account, or nullptr if memory is not being accounted for
+	 */
+	static MemAccount* current(void);
+
+  private:
+	friend class MemAccountScope;
+	static void updatePeak(std::atomic<uint64_t>& peak, uint64_t val);
+	static thread_local MemAccount* current_;
+	std::atomic<uint64_t> currentBytes_[GRK_NUM_MEM_CATEGORIES];
+	std::atomic<uint64_t> peakBytes_[GRK_NUM_MEM_CATEGORIES];
+	std::atomic<uint64_t> totalCurrentBytes_;
+	std::atomic<uint64_t> totalPeakBytes_;
+};
+
+/**
+ * RAII: make account current on calling thread, and restore previous
+ * account on destruction. account may be null.
+ */
+class MemAccountScope
+{
+  public:
+	explicit MemAccountScope(MemAccount* account) : previous_(MemAccount::current_)
+	{
+		MemAccount::current_ = account;
+	}
+	~MemAccountScope()
+	{
+		MemAccount::current_ = previous_;
+	}
+	MemAccountScope(const MemAccountScope&) = delete;
+	MemAccountScope& operator=(const MemAccountScope&) = delete;
+
+  private:
+	MemAccount* previous_;
+};
+
+/**
+ * Tracks the size of memory held by a single owner.
+ * The account current when memory is first tracked is charged
+ * until the tracker is released or destroyed. Copies start out
+ * empty, since they don't own the memory.
+ */
+class MemTracker
+{
+  public:
+	explicit MemTracker(GRK_MEM_CATEGORY category)
+		: account_(nullptr), bytes_(0), category_(category)
+	{}
+	MemTracker(const MemTracker& rhs) : MemTracker(rhs.category_) {}
+	MemTracker& operator=([[maybe_unused]] const MemTracker& rhs)
+	{
+		return *this;
+	}
+	~MemTracker()
+	{
+		release();
+	}
+	/**
+	 * Set number of bytes held by owner
+	 */
+	void set(uint64_t bytes)
+	{
+		if(!account_)
+		{
+			account_ = MemAccount::current();
+			if(!account_)
+				return;
+		}
+		if(bytes > bytes_)
+			account_->add(category_, bytes - bytes_);
+		else if(bytes < bytes_)
+			account_->sub(category_, bytes_ - bytes);
+		bytes_ = bytes;
+	}
+	/**
+	 * Add to number of bytes held by owner
+	 */
+	void add(uint64_t bytes)
+	{
+		set(bytes_ + bytes);
+	}
+	/**
+	 * Subtract from number of bytes held by owner
+	 */
+	void sub(uint64_t bytes)
+	{
+		set(bytes < bytes_ ? bytes_ - bytes : 0);
+	}
+	void release(void)
+	{
+		if(account_ && bytes_)
+			account_->sub(category_, bytes_);
+		account_ = nullptr;
+		bytes_ = 0;
+	}
+
+  private:
+	MemAccount* account_;
+	uint64_t bytes_;
+	GRK_MEM_CATEGORY category_;
+};
+
+/**
+ * Hard ceiling on memory used by a codec.
+ *
+ * Consumers that are able to wait (i.e. tile decompression) reserve their estimated
+ * footprint with acquire() before starting, and block while it doesn't fit.
+ * Consumers that must not wait (i.e. strip buffers) charge() unconditionally,
+ * and cached memory is only kept if tryAcquire() succeeds.
+ *
+ * acquire() never blocks when no other reservation is held, so that an item
+ * larger than the budget still gets processed, and so that unconditional charges
+ * can't starve waiting consumers. A limit of zero disables the budget.
+ */
+class MemBudget
+{
+  public:
+	MemBudget(void);
+	void setLimit(uint64_t limit);
+	bool enabled(void) const;
+	void acquire(uint64_t bytes);
+	bool tryAcquire(uint64_t bytes);
+	void charge(uint64_t bytes);
+	/**
+	 * Release reservation made with acquire()
+	 */
+	void releaseReservation(uint64_t bytes);
+	/**
+	 * Release memory charged with charge() or tryAcquire()
+	 */
+	void release(uint64_t bytes);
+
+  private:
+	uint64_t limit_;
+	uint64_t used_;
+	uint32_t numReservations_;
+	std::mutex mutex_;
+	std::condition_variable cond_;
+};
+
+/**
+ * RAII: reserve memory with budget, and release reservation on destruction.
+ * budget may be null.
+ */
+class MemReservation
+{
+  public:
+	MemReservation(MemBudget* budget, uint64_t bytes)
+		: budget_(budget && budget->enabled() ? budget : nullptr), bytes_(bytes)
+	{
+		if(budget_)
+			budget_->acquire(bytes_);
+	}
+	~MemReservation()
+	{
+		if(budget_)
+			budget_->releaseReservation(bytes_);
+	}
+	MemReservation(const MemReservation&) = delete;
+	MemReservation& operator=(const MemReservation&) = delete;
+
+  private:
+	MemBudget* budget_;
+	uint64_t bytes_;
+};
+
 } // namespace grk
@@ -205,20 +205,33 @@ grk_buf8* PLMarkerMgr::addNewMarker(uint8_t* data, uint16_t len)
 
 	return b;
 }
-bool PLMarkerMgr::readPLT(uint8_t* headerData, uint16_t header_size)
+grk_buf8* PLMarkerMgr::addMarkerView(uint8_t* data, uint16_t len)
+{
+	auto b = new grk_buf8(data, len);
+	currMarkerIter_->second->push_back(b);
+
+	return b;
+}
+bool PLMarkerMgr::readPLT(uint8_t* headerData, uint16_t header_size, bool persistent)
 {
 	if(header_size <= 1)
 	{
 		GRK_ERROR("PLT marker segment too short");
 		return false;
 	}
+	// packet lengths will never be read
+	if(!enabled_)
+		return true;
 	/* Zplt */
 	uint8_t Zpl = *headerData++;
 	--header_size;
 	if(!findMarker(Zpl, false))
 		return false;
 
-	addNewMarker(headerData, header_size);
+	if(persistent)
+		addMarkerView(headerData, header_size);
+	else
+		addNewMarker(headerData, header_size);
 #ifdef DEBUG_PLT
 	GRK_INFO("PLT marker %u", Zpl);
 #endif
@@ -283,11 +296,62 @@ bool PLMarkerMgr::readNextByte(uint8_t Iplm, uint32_t* packetLength)
 
 	return packetLen_ == 0;
 }
+void PLMarkerMgr::nextMarkerBuf(void)
+{
+	currMarkerBufIndex_++;
+	if(currMarkerBufIndex_ < currMarkerIter_->second->size())
+	{
+		currMarkerBuf_ = currMarkerIter_->second->operator[](currMarkerBufIndex_);
+	}
+	else
+	{
+		currMarkerIter_++;
+		if(currMarkerIter_ != rawMarkers_->end())
+		{
+			currMarkerBufIndex_ = 0;
+			currMarkerBuf_ = currMarkerIter_->second->front();
+		}
+		else
+		{
+			currMarkerBuf_ = nullptr;
+		}
+	}
+}
 uint64_t PLMarkerMgr::pop(uint64_t numPackets)
 {
 	uint64_t total = 0;
-	for(uint64_t i = 0; i < numPackets; ++i)
-		total += pop();
+	if(!numPackets)
+		return 0;
+	if(currMarkerIter_ == rawMarkers_->end())
+	{
+		GRK_ERROR("Attempt to pop PLT beyond PLT marker range.");
+		return 0;
+	}
+	// sum packet lengths directly from comma code, one marker buffer at a time
+	while(numPackets && currMarkerBuf_)
+	{
+		auto buf = currMarkerBuf_->buf;
+		auto offset = currMarkerBuf_->offset;
+		auto len = currMarkerBuf_->len;
+		while(numPackets && offset < len)
+		{
+			uint8_t Iplm = buf[offset++];
+			packetLen_ |= (Iplm & 0x7f);
+			if(Iplm & 0x80)
+			{
+				packetLen_ <<= 7;
+			}
+			else
+			{
+				total += packetLen_;
+				packetLen_ = 0;
+				numPackets--;
+			}
+		}
+		currMarkerBuf_->offset = offset;
+		if(offset == len)
+			nextMarkerBuf();
+	}
 
 	return total;
 }
@@ -310,26 +374,7 @@ uint32_t PLMarkerMgr::pop(void)
 		{}
 		// advance to next buffer
 		if(currMarkerBuf_->offset == currMarkerBuf_->len)
-		{
-			currMarkerBufIndex_++;
-			if(currMarkerBufIndex_ < currMarkerIter_->second->size())
-			{
-				currMarkerBuf_ = currMarkerIter_->second->operator[](currMarkerBufIndex_);
-			}
-			else
-			{
-				currMarkerIter_++;
-				if(currMarkerIter_ != rawMarkers_->end())
-				{
-					currMarkerBufIndex_ = 0;
-					currMarkerBuf_ = currMarkerIter_->second->front();
-				}
-				else
-				{
-					currMarkerBuf_ = nullptr;
-				}
-			}
-		}
+			nextMarkerBuf();
 	}
 
 	// static int count = 0;
@@ -341,8 +386,15 @@ void PLMarkerMgr::rewind(void)
 {
 	if(!rawMarkers_->empty())
 	{
+		for(auto& m : *rawMarkers_)
+		{
+			for(auto b : *m.second)
+				b->offset = 0;
+		}
 		currMarkerIter_ = rawMarkers_->begin();
+		currMarkerBufIndex_ = 0;
 		currMarkerBuf_ = currMarkerIter_->second->front();
+		packetLen_ = 0;
 	}
 }
 
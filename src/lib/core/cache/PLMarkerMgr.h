@@ -45,7 +45,16 @@ struct PLMarkerMgr
 	/////////////////////////////////////////////
 	// decompress
 	PLMarkerMgr(BufferedStream* strm);
-	bool readPLT(uint8_t* headerData, uint16_t header_size);
+	/**
+	 * Read PLT marker
+	 *
+	 * @param headerData marker data
+	 * @param header_size length of marker data
+	 * @param persistent true if marker data outlives this object: packet lengths
+	 * are then decoded from the marker data in place, on demand, rather than from a copy
+	 * @return true if successful
+	 */
+	bool readPLT(uint8_t* headerData, uint16_t header_size, bool persistent);
 	bool readPLM(uint8_t* headerData, uint16_t header_size);
 	void rewind(void);
 	uint32_t pop(void);
@@ -55,6 +64,7 @@ struct PLMarkerMgr
 	void clearMarkers(void);
 	bool findMarker(uint32_t index, bool compress);
 	grk_buf8* addNewMarker(uint8_t* data, uint16_t len);
+	grk_buf8* addMarkerView(uint8_t* data, uint16_t len);
 	PL_MARKERS* rawMarkers_;
 	PL_MARKERS::iterator currMarkerIter_;
 
@@ -68,6 +78,7 @@ struct PLMarkerMgr
 	//////////////////////////
 	// decompress
 	bool readNextByte(uint8_t Iplm, uint32_t* packetLength);
+	void nextMarkerBuf(void);
 	bool sequential_;
 	uint32_t packetLen_;
 	uint32_t currMarkerBufIndex_;
@@ -0,0 +1,180 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#define GROK_SKIP_POISON
+#include "grk_includes.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace grk
+{
+// each block starts with a header holding its size class, which keeps
+// the buffer handed out aligned to 64 bytes
+const size_t poolHeaderSize = 64;
+// smallest pooled block is 4 KiB (2^12)
+const uint32_t poolMinOctave = 12;
+const uint32_t poolNumOctaves = 36;
+const uint32_t poolClassesPerOctave = 4;
+const size_t hugePageSize = (size_t)2 << 20;
+const uint64_t defaultMaxIdleBytes = (uint64_t)256 << 20;
+
+const uint32_t SizeClassPool::numSizeClasses = poolNumOctaves * poolClassesPerOctave;
+const uint32_t SizeClassPool::noSizeClass = 0xFFFFFFFF;
+
+SizeClassPool::SizeClassPool(void)
+	: idle_(numSizeClasses), idleBytes_(0),
+	  maxIdleBytes_(defaultMaxIdleBytes), hugePages_(false)
+{}
+SizeClassPool::~SizeClassPool()
+{
+	purge(0);
+}
+SizeClassPool* SizeClassPool::get(void)
+{
+	static SizeClassPool singleton;
+
+	return &singleton;
+}
+uint32_t SizeClassPool::sizeClass(size_t blockSize)
+{
+	if(blockSize <= ((size_t)1 << poolMinOctave))
+		return noSizeClass;
+	uint64_t t = blockSize - 1;
+	uint32_t octave = poolMinOctave;
+	while(t >> (octave + 1))
+		octave++;
+	if(octave >= poolMinOctave + poolNumOctaves)
+		return noSizeClass;
+	uint32_t quarter = (uint32_t)(t >> (octave - 2)) - poolClassesPerOctave;
+
+	return (octave - poolMinOctave) * poolClassesPerOctave + quarter;
+}
+size_t SizeClassPool::classSize(uint32_t sizeClass)
+{
+	uint32_t octave = sizeClass / poolClassesPerOctave + poolMinOctave;
+	size_t quarter = sizeClass % poolClassesPerOctave + poolClassesPerOctave;
+
+	return (quarter + 1) << (octave - 2);
+}
+uint8_t* SizeClassPool::allocBlock(uint32_t sizeClass, size_t blockSize)
+{
+	size_t alignment = poolHeaderSize;
+	if(hugePages_ && blockSize >= hugePageSize)
+		alignment = hugePageSize;
+	// size must be a multiple of alignment
+	blockSize = ((blockSize + alignment - 1) / alignment) * alignment;
+#ifdef _WIN32
+	auto block = (uint8_t*)_aligned_malloc(blockSize, alignment);
+#else
+	auto block = (uint8_t*)std::aligned_alloc(alignment, blockSize);
+#endif
+	if(!block)
+		return nullptr;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	if(alignment == hugePageSize)
+		madvise(block, blockSize, MADV_HUGEPAGE);
+#endif
+	*(uint32_t*)block = sizeClass;
+
+	return block;
+}
+void SizeClassPool::freeBlock(uint8_t* block)
+{
+#ifdef _WIN32
+	_aligned_free(block);
+#else
+	free(block);
+#endif
+}
+void* SizeClassPool::alloc(size_t size)
+{
+	if(!size || size > SIZE_MAX - poolHeaderSize)
+		return nullptr;
+	size_t blockSize = size + poolHeaderSize;
+	uint32_t sc = sizeClass(blockSize);
+	if(sc == noSizeClass)
+	{
+		auto block = allocBlock(noSizeClass, blockSize);
+		return block ? block + poolHeaderSize : nullptr;
+	}
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		auto& bin = idle_[sc];
+		if(!bin.empty())
+		{
+			auto block = bin.back();
+			bin.pop_back();
+			idleBytes_ -= classSize(sc);
+			return block + poolHeaderSize;
+		}
+	}
+	auto block = allocBlock(sc, classSize(sc));
+
+	return block ? block + poolHeaderSize : nullptr;
+}
+void SizeClassPool::dealloc(void* ptr)
+{
+	if(!ptr)
+		return;
+	auto block = (uint8_t*)ptr - poolHeaderSize;
+	uint32_t sc = *(uint32_t*)block;
+	if(sc != noSizeClass)
+	{
+		size_t blockSize = classSize(sc);
+		std::unique_lock<std::mutex> lk(mutex_);
+		if(idleBytes_ + blockSize <= maxIdleBytes_)
+		{
+			idle_[sc].push_back(block);
+			idleBytes_ += blockSize;
+			return;
+		}
+	}
+	freeBlock(block);
+}
+void SizeClassPool::configure(uint64_t maxIdleBytes, bool hugePages)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	maxIdleBytes_ = maxIdleBytes;
+	hugePages_ = hugePages;
+	purge(maxIdleBytes_);
+}
+void SizeClassPool::purge(void)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	purge(0);
+}
+// free idle blocks, largest first, until idle bytes fit in maxIdleBytes
+// (mutex must be held by caller)
+void SizeClassPool::purge(uint64_t maxIdleBytes)
+{
+	for(size_t sc = idle_.size(); sc-- > 0 && idleBytes_ > maxIdleBytes;)
+	{
+		auto& bin = idle_[sc];
+		while(!bin.empty() && idleBytes_ > maxIdleBytes)
+		{
+			freeBlock(bin.back());
+			bin.pop_back();
+			idleBytes_ -= classSize((uint32_t)sc);
+		}
+	}
+}
+
+} // namespace grk
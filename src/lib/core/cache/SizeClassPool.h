@@ -0,0 +1,92 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace grk
+{
+/**
+ * Process-wide pool of aligned buffers, binned by size class.
+ *
+ * Tile component windows and sparse canvas blocks have the same handful of sizes
+ * for every tile of an image, so buffers released by one tile are handed back
+ * to the next one (from any codec) instead of going back to the system.
+ * Buffers are not cleared: callers must zero them if required.
+ *
+ * There are four size classes per power of two, so at most 25% of a buffer
+ * is wasted. Idle buffers are capped at a configurable number of bytes, and
+ * buffers that don't fit under the cap are freed. Optionally, transparent huge
+ * pages are requested for large buffers (Linux only).
+ */
+class SizeClassPool
+{
+  public:
+	~SizeClassPool();
+	static SizeClassPool* get(void);
+	/**
+	 * Allocate buffer aligned to 64 bytes
+	 *
+	 * @param size number of bytes
+	 * @return buffer, or nullptr if size is zero or there is insufficient memory
+	 */
+	void* alloc(size_t size);
+	/**
+	 * Return buffer allocated with alloc() to the pool
+	 */
+	void dealloc(void* ptr);
+	/**
+	 * Configure pool. Idle buffers that no longer fit are freed.
+	 *
+	 * @param maxIdleBytes maximum number of bytes held by idle buffers (0 disables pooling)
+	 * @param hugePages request transparent huge pages for large buffers
+	 */
+	void configure(uint64_t maxIdleBytes, bool hugePages);
+	/**
+	 * Free all idle buffers
+	 */
+	void purge(void);
+	/**
+	 * Get size class of block
+	 *
+	 * @param blockSize block size in bytes
+	 * @return size class, or noSizeClass if block is too small or too large to be pooled
+	 */
+	static uint32_t sizeClass(size_t blockSize);
+	/**
+	 * Get size in bytes of blocks in size class
+	 */
+	static size_t classSize(uint32_t sizeClass);
+	static const uint32_t numSizeClasses;
+	static const uint32_t noSizeClass;
+
+  private:
+	SizeClassPool(void);
+	uint8_t* allocBlock(uint32_t sizeClass, size_t blockSize);
+	void freeBlock(uint8_t* block);
+	void purge(uint64_t maxIdleBytes);
+
+	std::vector<std::vector<uint8_t*>> idle_;
+	uint64_t idleBytes_;
+	uint64_t maxIdleBytes_;
+	std::atomic<bool> hugePages_;
+	std::mutex mutex_;
+};
+
+} // namespace grk
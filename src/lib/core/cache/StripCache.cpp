@@ -13,8 +13,129 @@ static bool grkReclaimCallback(uint32_t threadId, grk_io_buf buffer, void* io_us
 	return true;
 }
 
+// buffers too small for the size class pool (at most 4 KiB) are binned in 64 byte steps
+const size_t smallBufStep = 64;
+const uint32_t numSmallBufClasses = 64;
+
+uint32_t BufPool::bufClass(size_t len)
+{
+	if(len <= smallBufStep * numSmallBufClasses)
+		return (uint32_t)((std::max<size_t>(len, 1) + smallBufStep - 1) / smallBufStep) - 1;
+	uint32_t sc = SizeClassPool::sizeClass(len);
+
+	return sc == SizeClassPool::noSizeClass ? noBufClass : numSmallBufClasses + sc;
+}
+size_t BufPool::bufClassSize(uint32_t bufClass)
+{
+	if(bufClass < numSmallBufClasses)
+		return (bufClass + 1) * smallBufStep;
+
+	return SizeClassPool::classSize(bufClass - numSmallBufClasses);
+}
+BufPool::BufPool(MemBudget* budget)
+	: freeLists_(numSmallBufClasses + SizeClassPool::numSizeClasses), returned_(nullptr),
+	  budget_(budget && budget->enabled() ? budget : nullptr), account_(MemAccount::current()),
+	  allocatedBytes_(0)
+{}
+BufPool::~BufPool(void)
+{
+	reclaim();
+	for(auto& list : freeLists_)
+	{
+		for(auto& b : list)
+		{
+			if(budget_)
+				budget_->release(b.allocLen_);
+			b.dealloc();
+		}
+	}
+	if(account_)
+		account_->sub(GRK_MEM_STRIP, allocatedBytes_);
+}
+GrkIOBuf BufPool::get(size_t len)
+{
+	size_t allocLen = len;
+	uint32_t sc = bufClass(len);
+	if(sc != noBufClass)
+	{
+		auto& list = freeLists_[sc];
+		if(list.empty())
+			reclaim();
+		if(!list.empty())
+		{
+			auto b = list.back();
+			list.pop_back();
+			b.len_ = len;
+			return b;
+		}
+		allocLen = bufClassSize(sc);
+	}
+	GrkIOBuf rc;
+	if(rc.alloc(allocLen))
+	{
+		rc.len_ = len;
+		allocatedBytes_ += allocLen;
+		if(account_)
+			account_->add(GRK_MEM_STRIP, allocLen);
+		if(budget_)
+			budget_->charge(allocLen);
+	}
+
+	return rc;
+}
+void BufPool::put(GrkIOBuf b)
+{
+	assert(b.data_);
+	uint32_t sc = bufClass(b.allocLen_);
+	if(sc == noBufClass || bufClassSize(sc) != b.allocLen_ ||
+	   (budget_ && !budget_->tryAcquire(b.allocLen_)))
+	{
+		dealloc(b);
+		return;
+	}
+	auto idle = (IdleBuf*)b.data_;
+	idle->allocLen = b.allocLen_;
+	idle->next = returned_.load(std::memory_order_relaxed);
+	while(!returned_.compare_exchange_weak(idle->next, idle, std::memory_order_release,
+										   std::memory_order_relaxed))
+	{
+	}
+}
+void BufPool::unget(GrkIOBuf b)
+{
+	uint32_t sc = bufClass(b.allocLen_);
+	if(sc != noBufClass && bufClassSize(sc) == b.allocLen_)
+	{
+		freeLists_[sc].push_back(b);
+		return;
+	}
+	if(budget_)
+		budget_->release(b.allocLen_);
+	dealloc(b);
+}
+// move buffers returned from any thread to free lists
+void BufPool::reclaim(void)
+{
+	auto idle = returned_.exchange(nullptr, std::memory_order_acquire);
+	while(idle)
+	{
+		auto next = idle->next;
+		GrkIOBuf b((uint8_t*)idle, 0, 0, idle->allocLen, false, 0);
+		freeLists_[bufClass(b.allocLen_)].push_back(b);
+		idle = next;
+	}
+}
+void BufPool::dealloc(GrkIOBuf& b)
+{
+	allocatedBytes_ -= b.allocLen_;
+	if(account_)
+		account_->sub(GRK_MEM_STRIP, b.allocLen_);
+	b.dealloc();
+}
+
 Strip::Strip(GrkImage* outputImage, uint16_t index, uint32_t nominalHeight, uint8_t reduce)
-	: stripImg(new GrkImage()), tileCounter(0), reduce_(reduce), allocatedInterleaved_(false)
+	: stripImg(new GrkImage()), tileCounter(0), reduce_(reduce), interleaved_(nullptr),
+	  isCompleted_(false)
 {
 	outputImage->copyHeader(stripImg);
 
@@ -25,23 +146,33 @@ Strip::Strip(GrkImage* outputImage, uint16_t index, uint32_t nominalHeight, uint
 }
 Strip::~Strip(void)
 {
+	// strip was completed, but never serialized
+	completed_.dealloc();
 	grk_object_unref(&stripImg->obj);
 }
 uint32_t Strip::reduceDim(uint32_t dim)
 {
 	return reduce_ ? ceildivpow2<uint32_t>(dim, reduce_) : dim;
 }
-bool Strip::allocInterleavedLocked(uint64_t len, BufPool* pool)
+uint8_t* Strip::allocInterleavedShared(uint64_t len, BufPool* pool)
 {
-	if(allocatedInterleaved_.load(std::memory_order_acquire))
-		return true;
-	std::unique_lock<std::mutex> lk(interleaveMutex_);
-	if(allocatedInterleaved_.load(std::memory_order_relaxed))
-		return true;
-	stripImg->interleavedData = pool->get(len);
-	allocatedInterleaved_.store(true, std::memory_order_release);
+	auto data = interleaved_.load(std::memory_order_acquire);
+	if(data)
+		return data;
+	auto b = pool->get(len);
+	if(!b.data_)
+		return nullptr;
+	if(!interleaved_.compare_exchange_strong(data, b.data_, std::memory_order_acq_rel))
+	{
+		// another tile got there first
+		pool->unget(b);
+		return data;
+	}
+	// only read by the strip's final tile, which synchronizes with
+	// this tile through tileCounter
+	stripImg->interleavedData = b;
 
-	return stripImg->interleavedData.data_;
+	return b.data_;
 }
 bool Strip::allocInterleaved(uint64_t len, BufPool* pool)
 {
@@ -51,11 +182,32 @@ bool Strip::allocInterleaved(uint64_t len, BufPool* pool)
 }
 StripCache::StripCache()
 	: strips(nullptr), numTiles_(0), numStrips_(0), nominalStripHeight_(0), imageY0_(0),
-	  packedRowBytes_(0), ioUserData_(nullptr), ioBufferCallback_(nullptr), initialized_(false),
-	  multiTile_(true)
+	  packedRowBytes_(0), ioUserData_(nullptr), ioBufferCallback_(nullptr), nextStrip_(0),
+	  draining_(false), serializeFailed_(false), initialized_(false), multiTile_(true),
+	  stats_(nullptr), memBudget_(nullptr), interleaver_(nullptr), numComps_(0), srcWidth_(0),
+	  planarRowBytes_(0), outWidth_(0), outHeight_(0), rowsPerStrip_(0), outRow_(0)
 {}
+void StripCache::setStats(Stats* stats)
+{
+	stats_ = stats;
+}
+void StripCache::setMemBudget(MemBudget* budget)
+{
+	memBudget_ = budget && budget->enabled() ? budget : nullptr;
+}
+// strip buffer has left the cache
+void StripCache::releaseFromBudget(const GrkIOBuf& buf)
+{
+	if(memBudget_)
+		memBudget_->release(buf.allocLen_);
+}
 StripCache::~StripCache()
 {
+	// output strip was partially resampled, but never serialized
+	outStrip_.dealloc();
+	for(auto& r : resamplers_)
+		delete r;
+	delete interleaver_;
 	for(auto& p : pools_)
 		delete p;
 	for(uint16_t i = 0; i < numStrips_; ++i)
@@ -85,7 +237,7 @@ void StripCache::init(uint32_t concurrency, uint16_t numTiles, uint32_t numStrip
 	// we can ignore subsampling since it is disabled for library-orchestrated encoding,
 	// which is the only case where maxPooledRequests_ is utilized
 	io_init.maxPooledRequests_ =
-		(outputImage->comps->h + outputImage->rowsPerStrip - 1) / outputImage->rowsPerStrip;
+		(outputImage->decompressHeight + outputImage->rowsPerStrip - 1) / outputImage->rowsPerStrip;
 	if(registerGrkReclaimCallback)
 		registerGrkReclaimCallback(io_init, grkReclaimCallback, ioUserData, this);
 	numTiles_ = numTiles;
@@ -93,12 +245,36 @@ void StripCache::init(uint32_t concurrency, uint16_t numTiles, uint32_t numStrip
 	imageY0_ = outputImage->y0;
 	nominalStripHeight_ = nominalStripHeight;
 	packedRowBytes_ = outputImage->packedRowBytes;
+	nextStrip_ = 0;
+	draining_ = false;
+	serializeFailed_ = false;
+	// resample strips if output size differs from decompressed size
+	auto comp = outputImage->comps;
+	if(outputImage->decompressWidth != comp->w || outputImage->decompressHeight != comp->h)
+	{
+		uint8_t prec = comp->prec;
+		if(outputImage->decompressFormat == GRK_FMT_PXM)
+			prec = prec > 8 ? packer16BitBE : 8;
+		interleaver_ = InterleaverFactory<int32_t>::makeInterleaver(prec);
+		if(!interleaver_)
+			return;
+		numComps_ = outputImage->numcomps;
+		srcWidth_ = comp->w;
+		planarRowBytes_ = (uint64_t)numComps_ * srcWidth_ * sizeof(int32_t);
+		outWidth_ = outputImage->decompressWidth;
+		outHeight_ = outputImage->decompressHeight;
+		rowsPerStrip_ = outputImage->rowsPerStrip;
+		outRow_ = 0;
+		resampledRow_.resize((size_t)numComps_ * outWidth_);
+		for(uint16_t compno = 0; compno < numComps_; ++compno)
+			resamplers_.push_back(new Resampler(srcWidth_, comp->h, outWidth_, outHeight_));
+	}
 	strips = new Strip*[numStrips];
 	for(uint16_t i = 0; i < numStrips_; ++i)
 		strips[i] = new Strip(outputImage, i, nominalStripHeight_, reduce);
 	initialized_ = true;
 	for(uint32_t i = 0; i < concurrency; ++i)
-		pools_.push_back(new BufPool());
+		pools_.push_back(new BufPool(memBudget_));
 }
 bool StripCache::ingestStrip(uint32_t threadId, Tile* src, uint32_t yBegin, uint32_t yEnd)
 {
@@ -112,10 +288,28 @@ bool StripCache::ingestStrip(uint32_t threadId, Tile* src, uint32_t yBegin, uint
 	// use height of first component, because no subsampling
 	uint64_t dataLen = packedRowBytes_ * (yEnd - yBegin);
 	uint64_t dataOffset = packedRowBytes_ * yBegin;
-	if(!strip->allocInterleaved(dataLen, pools_[threadId]))
-		return false;
-	if(!dest->compositeInterleaved(src, yBegin, yEnd))
-		return false;
+	if(!resamplers_.empty())
+	{
+		dataLen = planarRowBytes_ * (yEnd - yBegin);
+		if(!strip->allocInterleaved(dataLen, pools_[threadId]))
+			return false;
+		auto planes = (int32_t*)dest->interleavedData.data_;
+		for(uint16_t compno = 0; compno < numComps_; ++compno)
+		{
+			auto b = (src->comps + compno)->getWindow()->getResWindowBufferHighestSimple();
+			assert((src->comps + compno)->width() == srcWidth_);
+			for(uint32_t y = yBegin; y < yEnd; ++y)
+				memcpy(planes + ((uint64_t)compno * (yEnd - yBegin) + y - yBegin) * srcWidth_,
+					   b.buf_ + (uint64_t)y * b.stride_, srcWidth_ * sizeof(int32_t));
+		}
+	}
+	else
+	{
+		if(!strip->allocInterleaved(dataLen, pools_[threadId]))
+			return false;
+		if(!dest->compositeInterleaved(src, yBegin, yEnd))
+			return false;
+	}
 
 	auto buf = GrkIOBuf(dest->interleavedData);
 	buf.index_ = stripId;
@@ -141,11 +335,14 @@ bool StripCache::ingestTile(uint32_t threadId, GrkImage* src)
 	auto strip = strips[stripId];
 	auto dest = strip->stripImg;
 	// use height of first component, because no subsampling
-	uint64_t dataLen = packedRowBytes_ * dest->comps->h;
+	uint64_t dataLen =
+		(resamplers_.empty() ? packedRowBytes_ : planarRowBytes_) * dest->comps->h;
 	uint64_t offset = packedRowBytes_ * dest->comps->y0;
-	if(!strip->allocInterleavedLocked(dataLen, pools_[threadId]))
+	auto interleaved = strip->allocInterleavedShared(dataLen, pools_[threadId]);
+	if(!interleaved)
 		return false;
-	if(!dest->compositeInterleaved(src))
+	if(resamplers_.empty() ? !dest->compositeInterleaved(src, interleaved)
+						   : !dest->compositePlanar(src, (int32_t*)interleaved))
 		return false;
 
 	if(++strip->tileCounter == numTiles_)
@@ -156,7 +353,10 @@ bool StripCache::ingestTile(uint32_t threadId, GrkImage* src)
 		buf.len_ = dataLen;
 		dest->interleavedData.data_ = nullptr;
 		if(grokNewIO)
+		{
+			releaseFromBudget(buf);
 			return ioBufferCallback_(threadId, buf, ioUserData_);
+		}
 		if(!serialize(threadId, buf))
 			return false;
 	}
@@ -167,46 +367,111 @@ bool StripCache::ingestTile(uint32_t threadId, GrkImage* src)
 bool StripCache::serialize(uint32_t threadId, GrkIOBuf buf)
 {
 	if(grokNewIO)
+	{
+		releaseFromBudget(buf);
 		return ioBufferCallback_(threadId, buf, ioUserData_);
+	}
+	// 1. publish completed strip
+	auto strip = strips[buf.index_];
+	strip->completed_ = buf;
+	strip->isCompleted_.store(true);
 
-	std::queue<GrkIOBuf> buffersToSerialize;
+	// 2. serialize consecutive completed strips. Only one thread drains at a time:
+	// a thread that finds a drain in progress leaves its strip to the draining thread,
+	// which checks again for completed strips after it stops draining.
+	// (sequentially consistent ordering guarantees that either the draining thread sees
+	// the newly completed strip, or the completing thread sees that draining has stopped)
+	while(!draining_.exchange(true))
 	{
-		std::unique_lock<std::mutex> lk(heapMutex_);
-		// 1. push to heap
-		serializeHeap.push(buf);
-		// 2. get all sequential buffers in heap
-		buf = serializeHeap.pop();
-		while(buf.data_)
+		drain(threadId);
+		draining_.store(false);
+		uint32_t next = nextStrip_.load();
+		if(next == numStrips_ || !strips[next]->isCompleted_.load())
+			break;
+	}
+
+	return !serializeFailed_.load();
+}
+void StripCache::drain(uint32_t threadId)
+{
+	uint32_t next = nextStrip_.load(std::memory_order_relaxed);
+	if(next == numStrips_ || !strips[next]->isCompleted_.load())
+		return;
+	ScopedSpan ioSpan(stats_, GRK_STAGE_IO, 0);
+	for(; next < numStrips_ && strips[next]->isCompleted_.load(); ++next)
+	{
+		auto strip = strips[next];
+		auto b = strip->completed_;
+		strip->completed_.data_ = nullptr;
+		releaseFromBudget(b);
+		if(!resamplers_.empty())
+		{
+			// source strip is no longer needed once it has been resampled
+			if(!serializeFailed_.load(std::memory_order_relaxed) && !resample(threadId, b))
+				serializeFailed_.store(true);
+			pools_[threadId]->put(b);
+		}
+		// after a serialize failure, discard remaining strips
+		else if(serializeFailed_.load(std::memory_order_relaxed) ||
+				!ioBufferCallback_(threadId, b, ioUserData_))
 		{
-			buffersToSerialize.push(buf);
-			buf = serializeHeap.pop();
+			serializeFailed_.store(true);
+			pools_[threadId]->dealloc(b);
 		}
 	}
-	// 3. serialize buffers
-	if(!buffersToSerialize.empty())
+	nextStrip_.store(next);
+}
+bool StripCache::resample(uint32_t threadId, const GrkIOBuf& src)
+{
+	auto rows = (uint32_t)(src.len_ / planarRowBytes_);
+	auto planes = (const int32_t*)src.data_;
+	for(uint32_t y = 0; y < rows; ++y)
 	{
+		// all components complete their output rows on the same input row
+		bool rowComplete = false;
+		for(uint16_t compno = 0; compno < numComps_; ++compno)
 		{
-			std::unique_lock<std::mutex> lk(serializeMutex_);
-			while(!buffersToSerialize.empty())
-			{
-				auto b = buffersToSerialize.front();
-				if(!ioBufferCallback_(threadId, b, ioUserData_))
-					break;
-				buffersToSerialize.pop();
-			}
+			rowComplete = resamplers_[compno]->push(
+				planes + ((uint64_t)compno * rows + y) * srcWidth_,
+				resampledRow_.data() + (uint64_t)compno * outWidth_);
 		}
-		// if non empty, then there has been a serialize failure
-		if(!buffersToSerialize.empty())
-		{
-			// cleanup
-			while(!buffersToSerialize.empty())
-			{
-				auto b = buffersToSerialize.front();
-				b.dealloc();
-				buffersToSerialize.pop();
-			}
+		if(rowComplete && !serializeResampledRow(threadId))
 			return false;
-		}
+	}
+
+	return true;
+}
+bool StripCache::serializeResampledRow(uint32_t threadId)
+{
+	uint32_t stripIndex = outRow_ / rowsPerStrip_;
+	uint32_t stripRow = outRow_ % rowsPerStrip_;
+	uint32_t stripRows = std::min<uint32_t>(rowsPerStrip_, outHeight_ - stripIndex * rowsPerStrip_);
+	if(stripRow == 0)
+	{
+		outStrip_ = pools_[threadId]->get(packedRowBytes_ * stripRows);
+		if(!outStrip_.data_)
+			return false;
+	}
+	int32_t* planes[grk::maxNumPackComponents];
+	for(uint16_t compno = 0; compno < numComps_; ++compno)
+		planes[compno] = resampledRow_.data() + (uint64_t)compno * outWidth_;
+	interleaver_->interleave(planes, numComps_, outStrip_.data_ + packedRowBytes_ * stripRow,
+							 outWidth_, outWidth_, packedRowBytes_, 1, 0);
+	outRow_++;
+	if(stripRow + 1 < stripRows)
+		return true;
+
+	// output strip is complete
+	auto buf = outStrip_;
+	outStrip_ = GrkIOBuf();
+	buf.index_ = stripIndex;
+	buf.offset_ = packedRowBytes_ * stripIndex * rowsPerStrip_;
+	buf.len_ = packedRowBytes_ * stripRows;
+	releaseFromBudget(buf);
+	if(!ioBufferCallback_(threadId, buf, ioUserData_))
+	{
+		pools_[threadId]->dealloc(buf);
+		return false;
 	}
 
 	return true;
@@ -1,13 +1,12 @@
 #pragma once
 
 #include <vector>
-#include <mutex>
 #include <atomic>
 #include "grok.h"
-#include "MinHeap.h"
 
 namespace grk
 {
+class Resampler;
 
 struct GrkIOBuf : public grk_io_buf
 {
@@ -55,40 +54,61 @@ struct GrkIOBuf : public grk_io_buf
 	}
 };
 
+/**
+ * Pool of strip buffers, owned by a single worker thread, with a free list
+ * for each size class (see SizeClassPool). Buffers too small for the size
+ * classes are binned in 64 byte steps. Only the owner takes buffers from
+ * the pool, but buffers can be returned from any thread: they are pushed onto a
+ * lock-free list, which the owner moves to its free lists when they run dry.
+ * An idle buffer stores the list link in its own memory.
+ *
+ * Buffers allocated by the pool are charged to the codec's memory account until
+ * the pool is destroyed, since buffers handed to the I/O layer may be freed
+ * outside of the library.
+ *
+ * With a memory budget, idle buffers in the pool are charged to the budget, and a
+ * returned buffer is freed rather than pooled if it doesn't fit.
+ */
 class BufPool
 {
   public:
-	~BufPool(void)
-	{
-		for(auto& b : pool)
-			b.second.dealloc();
-	}
-	GrkIOBuf get(size_t len)
-	{
-		for(auto iter = pool.begin(); iter != pool.end(); ++iter)
-		{
-			if(iter->second.allocLen_ >= len)
-			{
-				auto b = iter->second;
-				b.len_ = len;
-				pool.erase(iter);
-				return b;
-			}
-		}
-		GrkIOBuf rc;
-		rc.alloc(len);
-
-		return rc;
-	}
-	void put(GrkIOBuf b)
-	{
-		assert(b.data_);
-		assert(pool.find(b.data_) == pool.end());
-		pool[b.data_] = b;
-	}
+	explicit BufPool(MemBudget* budget);
+	~BufPool(void);
+	/**
+	 * Get buffer of at least len bytes (owner thread only)
+	 */
+	GrkIOBuf get(size_t len);
+	/**
+	 * Return buffer to pool (any thread)
+	 */
+	void put(GrkIOBuf b);
+	/**
+	 * Return unused buffer obtained from get() (owner thread only)
+	 */
+	void unget(GrkIOBuf b);
+	/**
+	 * Free buffer obtained from a pool, releasing it from the memory account (any thread)
+	 */
+	void dealloc(GrkIOBuf& b);
 
   private:
-	std::map<uint8_t*, GrkIOBuf> pool;
+	struct IdleBuf
+	{
+		IdleBuf* next;
+		size_t allocLen;
+	};
+	/**
+	 * Get free list index for buffer length, or noBufClass if buffer is too large to be pooled
+	 */
+	static uint32_t bufClass(size_t len);
+	static size_t bufClassSize(uint32_t bufClass);
+	static const uint32_t noBufClass = 0xFFFFFFFF;
+	void reclaim(void);
+	std::vector<std::vector<GrkIOBuf>> freeLists_;
+	std::atomic<IdleBuf*> returned_;
+	MemBudget* budget_;
+	MemAccount* account_;
+	std::atomic<uint64_t> allocatedBytes_;
 };
 
 struct Strip
@@ -97,13 +117,21 @@ struct Strip
 	~Strip(void);
 	uint32_t getIndex(void);
 	uint32_t reduceDim(uint32_t dim);
-	bool allocInterleavedLocked(uint64_t len, BufPool* pool);
+	/**
+	 * Get interleaved buffer shared by all tiles in strip. The first tile to
+	 * publish its buffer wins, and the others return their buffers to their pools.
+	 *
+	 * @return shared buffer, or nullptr if allocation failed
+	 */
+	uint8_t* allocInterleavedShared(uint64_t len, BufPool* pool);
 	bool allocInterleaved(uint64_t len, BufPool* pool);
 	GrkImage* stripImg;
 	std::atomic<uint32_t> tileCounter; // count number of tiles added to strip
 	uint8_t reduce_; // resolution reduction
-	mutable std::mutex interleaveMutex_;
-	mutable std::atomic<bool> allocatedInterleaved_;
+	std::atomic<uint8_t*> interleaved_;
+	// completed strip waiting to be serialized in order
+	GrkIOBuf completed_;
+	std::atomic<bool> isCompleted_;
 };
 
 class StripCache
@@ -122,9 +150,19 @@ class StripCache
 	void returnBufferToPool(uint32_t threadId, GrkIOBuf b);
 	bool isInitialized(void);
 	bool isMultiTile(void);
+	void setStats(Stats* stats);
+	void setMemBudget(MemBudget* budget);
 
   private:
 	bool serialize(uint32_t threadId, GrkIOBuf buf);
+	void drain(uint32_t threadId);
+	/**
+	 * Resample strip of planar samples, and serialize the output strips it completes
+	 * (draining thread only)
+	 */
+	bool resample(uint32_t threadId, const GrkIOBuf& src);
+	bool serializeResampledRow(uint32_t threadId);
+	void releaseFromBudget(const GrkIOBuf& buf);
 	std::vector<BufPool*> pools_;
 	Strip** strips;
 	uint16_t numTiles_;
@@ -134,11 +172,29 @@ class StripCache
 	uint64_t packedRowBytes_;
 	void* ioUserData_;
 	grk_io_pixels_callback ioBufferCallback_;
-	mutable std::mutex serializeMutex_;
-	MinHeap<GrkIOBuf, uint32_t, MinHeapFakeLocker> serializeHeap;
-	mutable std::mutex heapMutex_;
+	// next strip to serialize: only modified by the draining thread
+	std::atomic<uint32_t> nextStrip_;
+	std::atomic<bool> draining_;
+	std::atomic<bool> serializeFailed_;
 	bool initialized_;
 	bool multiTile_;
+	Stats* stats_;
+	MemBudget* memBudget_;
+
+	// resampling to the output size: strips hold planar samples at the decompressed
+	// size, and are resampled in order by the draining thread into output strips
+	// of rowsPerStrip_ rows
+	std::vector<Resampler*> resamplers_;
+	PlanarToInterleaved<int32_t>* interleaver_;
+	std::vector<int32_t> resampledRow_;
+	uint16_t numComps_;
+	uint32_t srcWidth_;
+	uint64_t planarRowBytes_;
+	uint32_t outWidth_;
+	uint32_t outHeight_;
+	uint32_t rowsPerStrip_;
+	uint32_t outRow_;
+	GrkIOBuf outStrip_;
 };
 
 } // namespace grk
@@ -63,6 +63,12 @@ TileCacheEntry* TileCache::get(uint16_t tileIndex)
 
 	return nullptr;
 }
+void TileCache::clear(void)
+{
+	for(auto& proc : cache_)
+		delete proc.second;
+	cache_.clear();
+}
 void TileCache::setStrategy(GRK_TILE_CACHE_STRATEGY strategy)
 {
 	strategy_ = strategy;
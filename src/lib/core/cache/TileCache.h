@@ -46,6 +46,10 @@ class TileCache
 	GRK_TILE_CACHE_STRATEGY getStrategy(void);
 	TileCacheEntry* put(uint16_t tileIndex, TileProcessor* processor);
 	TileCacheEntry* get(uint16_t tileIndex);
+	/**
+	 * Delete all entries, keeping composite image
+	 */
+	void clear(void);
 	GrkImage* getComposite(void);
 	std::vector<GrkImage*> getAllImages(void);
 	std::vector<GrkImage*> getTileImages(void);
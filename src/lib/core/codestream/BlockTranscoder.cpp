@@ -0,0 +1,266 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+BlockTranscoder::BlockTranscoder(CodeStreamDecompress* codeStream, BufferedStream* dest,
+								 grk_transcode_params* params)
+	: codeStream_(codeStream), dest_(dest), maxLayers_(params ? params->max_layers : 0),
+	  reduce_(params ? params->reduce : 0),
+	  blockCoder_(params ? params->block_coder : GRK_BLOCK_CODER_KEEP), compressor_(nullptr),
+	  mct_(0), hasTLM_(false), hasPL_(false), hasRGN_(false), numTiles_(0), numTilesWritten_(0)
+{}
+BlockTranscoder::~BlockTranscoder()
+{
+	delete compressor_;
+}
+uint64_t BlockTranscoder::transcode(std::function<bool(void)> readHeader)
+{
+	if(!codeStream_->needsHeaderRead())
+	{
+		GRK_ERROR("Transcode: main header has already been read");
+		return 0;
+	}
+	if(reduce_)
+	{
+		GRK_ERROR("Transcode: resolutions cannot be discarded when changing block coder");
+		return 0;
+	}
+	uint64_t start = dest_->tell();
+	// number of decompressed layers is set when COD marker is read
+	codeStream_->getCodingParams()->coding_params_.dec_.layers_to_decompress_ = maxLayers_;
+	codeStream_->setMarkerListener(
+		[this]([[maybe_unused]] int32_t tileIndex, uint16_t id,
+			   [[maybe_unused]] const uint8_t* headerData,
+			   [[maybe_unused]] uint16_t header_size) { return onMarker(id); });
+	bool rc = readHeader() && initCompressor() &&
+			  codeStream_->decompressCoefficients([this](TileProcessor* tileProcessor) {
+				  return validateTile(tileProcessor) && compressTile(tileProcessor);
+			  });
+	codeStream_->setMarkerListener(nullptr);
+	if(rc && hasTLM_ && numTilesWritten_ != numTiles_)
+	{
+		GRK_ERROR("Transcode: TLM marker requires all %u tiles, but only %u tiles were found",
+				  numTiles_, numTilesWritten_);
+		rc = false;
+	}
+	rc = rc && compressor_->end();
+
+	return rc ? dest_->tell() - start : 0;
+}
+bool BlockTranscoder::onMarker(uint16_t id)
+{
+	switch(id)
+	{
+		case J2K_MS_TLM:
+			hasTLM_ = true;
+			break;
+		case J2K_MS_PLM:
+		case J2K_MS_PLT:
+			hasPL_ = true;
+			break;
+		case J2K_MS_RGN:
+			if(!hasRGN_)
+				GRK_WARN("Transcode: region of interest shift will not be preserved");
+			hasRGN_ = true;
+			break;
+		default:
+			break;
+	}
+
+	return true;
+}
+bool BlockTranscoder::initCompressor(void)
+{
+	auto cp = codeStream_->getCodingParams();
+	auto image = codeStream_->getHeaderImage();
+	// tile coding parameters are still equal to main header coding parameters
+	auto tcp = cp->tcps;
+	if(tcp->mct == 2)
+	{
+		GRK_ERROR("Transcode: custom multi component transform is not supported");
+		return false;
+	}
+	numTiles_ = (uint32_t)cp->t_grid_width * cp->t_grid_height;
+	tccps_.assign(tcp->tccps, tcp->tccps + image->numcomps);
+	mct_ = tcp->mct;
+
+	grk_cparameters params;
+	grk_compress_set_default_params(&params);
+	params.tile_size_on = true;
+	params.tx0 = cp->tx0;
+	params.ty0 = cp->ty0;
+	params.t_width = cp->t_width;
+	params.t_height = cp->t_height;
+	params.numlayers = 1;
+	params.layer_rate[0] = 0;
+	params.allocationByRateDistoration = true;
+	params.csty = tcp->csty;
+	params.prog_order = tcp->prg;
+	params.numresolution = tccps_[0].numresolutions;
+	params.cblockw_init = 1U << tccps_[0].cblkw;
+	params.cblockh_init = 1U << tccps_[0].cblkh;
+	params.cblk_sty = (blockCoder_ == GRK_BLOCK_CODER_HT) ? GRK_CBLKSTY_HT : 0;
+	params.irreversible = tccps_[0].qmfbid == 0;
+	params.numgbits = tccps_[0].numgbits;
+	params.mct = mct_;
+	params.rsiz = GRK_PROFILE_NONE;
+	params.writeTLM = hasTLM_;
+	compressor_ = new CodeStreamCompress(dest_);
+	if(!compressor_->init(&params, image))
+		return false;
+
+	// compressor must use the source's coding parameters, so that coefficients
+	// are quantized and bit plane coded exactly as they were in the source
+	auto destCp = compressor_->getCodingParams();
+	for(uint32_t tileno = 0; tileno < numTiles_; ++tileno)
+	{
+		auto destTcp = destCp->tcps + tileno;
+		destTcp->mct = mct_;
+		for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+		{
+			auto src = &tccps_[compno];
+			auto dest = destTcp->tccps + compno;
+			dest->csty = src->csty;
+			dest->numresolutions = src->numresolutions;
+			dest->cblkw = src->cblkw;
+			dest->cblkh = src->cblkh;
+			dest->qmfbid = src->qmfbid;
+			// step sizes of derived quantization have already been expanded to all bands
+			dest->qntsty =
+				(src->qntsty == J2K_CCP_QNTSTY_SIQNT) ? J2K_CCP_QNTSTY_SEQNT : src->qntsty;
+			std::copy(src->stepsizes, src->stepsizes + GRK_J2K_MAXBANDS, dest->stepsizes);
+			dest->numgbits = src->numgbits;
+			std::copy(src->precWidthExp, src->precWidthExp + GRK_J2K_MAXRLVLS,
+					  dest->precWidthExp);
+			std::copy(src->precHeightExp, src->precHeightExp + GRK_J2K_MAXRLVLS,
+					  dest->precHeightExp);
+		}
+		// CAP marker is generated from quantizer
+		destTcp->qcd_->push(destTcp->tccps->stepsizes);
+	}
+
+	return compressor_->start();
+}
+bool BlockTranscoder::validateTile(TileProcessor* tileProcessor)
+{
+	auto tcp = tileProcessor->getTileCodingParams();
+	bool valid = tcp->mct == mct_;
+	for(uint16_t compno = 0; compno < tileProcessor->headerImage->numcomps && valid; ++compno)
+	{
+		auto tccp = tcp->tccps + compno;
+		auto mainTccp = &tccps_[compno];
+		valid = tccp->numresolutions == mainTccp->numresolutions &&
+				tccp->qmfbid == mainTccp->qmfbid && tccp->numgbits == mainTccp->numgbits;
+		uint32_t numBands = tccp->numresolutions * 3U - 2U;
+		for(uint32_t bandno = 0; bandno < numBands && valid; ++bandno)
+		{
+			valid = tccp->stepsizes[bandno].expn == mainTccp->stepsizes[bandno].expn &&
+					tccp->stepsizes[bandno].mant == mainTccp->stepsizes[bandno].mant;
+		}
+	}
+	if(!valid)
+		GRK_ERROR("Transcode: coding parameters of tile %u are not supported, as they "
+				  "differ from main header coding parameters",
+				  tileProcessor->getIndex());
+
+	return valid;
+}
+bool BlockTranscoder::compressTile(TileProcessor* tileProcessor)
+{
+	compressor_->getCodingParams()->coding_params_.enc_.writePLT = hasPL_;
+	auto ingestTile = [this, tileProcessor](TileProcessor* destProcessor) {
+		return ingest(tileProcessor, destProcessor);
+	};
+	if(!compressor_->compressTile(tileProcessor->getIndex(), ingestTile))
+		return false;
+	numTilesWritten_++;
+
+	return true;
+}
+bool BlockTranscoder::ingest(TileProcessor* src, TileProcessor* dest)
+{
+	if(!src->cp_->wholeTileDecompress_)
+	{
+		GRK_ERROR("Transcode: tile %u was not fully decompressed", src->getIndex());
+		return false;
+	}
+	auto srcTile = src->getTile();
+	auto destTile = dest->getTile();
+	for(uint16_t compno = 0; compno < srcTile->numcomps_; ++compno)
+	{
+		auto srcComp = srcTile->comps + compno;
+		auto destComp = destTile->comps + compno;
+		if(srcComp->numresolutions != destComp->numresolutions ||
+		   srcComp->width() != destComp->width() || srcComp->height() != destComp->height())
+		{
+			GRK_ERROR("Transcode: tile %u component %u geometry mismatch", src->getIndex(),
+					  compno);
+			return false;
+		}
+		bool reversible = (src->getTileCodingParams()->tccps + compno)->qmfbid == 1;
+		// both windows hold the whole tile component, with bands of each resolution
+		// laid out as they are by the wavelet transform
+		auto srcBuf = srcComp->getWindow()->getResWindowBufferHighestSimple();
+		auto destBuf = destComp->getWindow()->getResWindowBufferHighestSimple();
+		for(uint8_t resno = 0; resno < srcComp->numresolutions; ++resno)
+		{
+			auto srcRes = srcComp->resolutions_ + resno;
+			auto destRes = destComp->resolutions_ + resno;
+			for(uint8_t bandIndex = 0; bandIndex < srcRes->numTileBandWindows; ++bandIndex)
+			{
+				auto srcBand = srcRes->tileBand + bandIndex;
+				auto destBand = destRes->tileBand + bandIndex;
+				uint32_t x = 0, y = 0;
+				if(resno > 0)
+				{
+					auto lowerRes = srcComp->resolutions_ + resno - 1;
+					if(srcBand->orientation & 1)
+						x = lowerRes->width();
+					if(srcBand->orientation & 2)
+						y = lowerRes->height();
+				}
+				uint32_t w = srcBand->width();
+				uint32_t h = srcBand->height();
+				// decompressor and compressor step sizes differ by the sub-band gain
+				float scale = destBand->stepsize / srcBand->stepsize;
+				for(uint32_t j = 0; j < h; ++j)
+				{
+					auto srcRow = srcBuf.buf_ + x + (uint64_t)(y + j) * srcBuf.stride_;
+					auto destRow = destBuf.buf_ + x + (uint64_t)(y + j) * destBuf.stride_;
+					if(reversible)
+					{
+						memcpy(destRow, srcRow, w * sizeof(int32_t));
+					}
+					else
+					{
+						auto srcRowF = (float*)srcRow;
+						auto destRowF = (float*)destRow;
+						for(uint32_t i = 0; i < w; ++i)
+							destRowF[i] = srcRowF[i] * scale;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+} // namespace grk
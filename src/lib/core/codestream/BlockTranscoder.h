@@ -0,0 +1,83 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace grk
+{
+/**
+ * Transcodes a code stream to a different block coder (Part-1 or HTJ2K).
+ *
+ * Code blocks are decompressed to wavelet coefficients, which are then
+ * re-compressed with the new block coder into a single lossless layer.
+ * Wavelet transform, multi component transform and DC level shift are skipped,
+ * so that the transcoded code stream decompresses to the same image as the source.
+ */
+class BlockTranscoder
+{
+  public:
+	BlockTranscoder(CodeStreamDecompress* codeStream, BufferedStream* dest,
+					grk_transcode_params* params);
+	~BlockTranscoder();
+	/**
+	 * Transcode code stream
+	 *
+	 * @param readHeader reads main header of source code stream
+	 * @return number of bytes written, or 0 on failure
+	 */
+	uint64_t transcode(std::function<bool(void)> readHeader);
+
+  private:
+	bool onMarker(uint16_t id);
+	bool initCompressor(void);
+	/**
+	 * Check that tile coding parameters are compatible with main header
+	 * coding parameters, which are the only ones written to transcoded code stream
+	 *
+	 * @param tileProcessor source tile processor
+	 * @return true if compatible
+	 */
+	bool validateTile(TileProcessor* tileProcessor);
+	bool compressTile(TileProcessor* tileProcessor);
+	/**
+	 * Copy wavelet coefficients from source tile to destination tile, scaling
+	 * irreversible coefficients from the decompressor's to the compressor's
+	 * quantization step sizes
+	 *
+	 * @param src source tile processor
+	 * @param dest destination tile processor
+	 * @return true if successful
+	 */
+	bool ingest(TileProcessor* src, TileProcessor* dest);
+
+	CodeStreamDecompress* codeStream_;
+	BufferedStream* dest_;
+	uint16_t maxLayers_;
+	uint8_t reduce_;
+	GRK_BLOCK_CODER blockCoder_;
+	CodeStreamCompress* compressor_;
+	// main header coding parameters of source
+	std::vector<TileComponentCodingParams> tccps_;
+	uint8_t mct_;
+	bool hasTLM_;
+	bool hasPL_;
+	bool hasRGN_;
+	uint32_t numTiles_;
+	uint32_t numTilesWritten_;
+};
+
+} // namespace grk
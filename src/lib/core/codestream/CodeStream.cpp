@@ -23,11 +23,13 @@
 namespace grk
 {
 CodeStream::CodeStream(BufferedStream* stream)
-	: codeStreamInfo(nullptr), headerImage_(nullptr), currentTileProcessor_(nullptr),
-	  stream_(stream), current_plugin_tile(nullptr)
+	: accountMemory_(false), codeStreamInfo(nullptr), headerImage_(nullptr),
+	  currentTileProcessor_(nullptr), stream_(stream), current_plugin_tile(nullptr),
+	  stats_(nullptr)
 {}
 CodeStream::~CodeStream()
 {
+	delete stats_;
 	if(headerImage_)
 		grk_object_unref(&headerImage_->obj);
 	delete codeStreamInfo;
@@ -60,6 +62,33 @@ BufferedStream* CodeStream::getStream()
 {
 	return stream_;
 }
+Stats* CodeStream::getStats(void)
+{
+	return stats_;
+}
+MemAccount* CodeStream::getMemAccount(void)
+{
+	return accountMemory_ ? &memAccount_ : nullptr;
+}
+CodecControl* CodeStream::getControl(void)
+{
+	return &control_;
+}
+SchedulerCache* CodeStream::getSchedulerCache(void)
+{
+	return &schedulerCache_;
+}
+PacketSequenceCache* CodeStream::getPacketSequenceCache(void)
+{
+	return &packetSequenceCache_;
+}
+void CodeStream::enableStats(uint32_t flags)
+{
+	if(flags & GRK_STATS_MEMORY)
+		accountMemory_ = true;
+	if(!stats_ && (flags & (GRK_STATS_ENABLE | GRK_STATS_TRACE)))
+		stats_ = new Stats(flags);
+}
 
 std::string CodeStream::markerString(uint16_t marker)
 {
@@ -102,6 +102,11 @@ void j2k_write(const void* p_src_data, void* p_dest_data, uint64_t nb_elem)
 const uint32_t MCT_ELEMENT_SIZE[] = {2, 4, 4, 8};
 typedef void (*j2k_mct_function)(const void* p_src_data, void* p_dest_data, uint64_t nb_elem);
 typedef std::function<bool(void)> PROCEDURE_FUNC;
+struct TileProcessor;
+/**
+ * Operates on a single tile
+ */
+typedef std::function<bool(TileProcessor* tileProcessor)> TILE_FUNC;
 
 struct ICodeStreamCompress
 {
@@ -109,22 +114,37 @@ struct ICodeStreamCompress
 	virtual bool init(grk_cparameters* p_param, GrkImage* p_image) = 0;
 	virtual bool start(void) = 0;
 	virtual uint64_t compress(grk_plugin_tile* tile) = 0;
+	virtual Stats* getStats(void) = 0;
+	virtual MemAccount* getMemAccount(void) = 0;
 };
 
+class Stitcher;
+
 struct ICodeStreamDecompress
 {
   public:
 	virtual ~ICodeStreamDecompress() = default;
 	virtual bool readHeader(grk_header_info* header_info) = 0;
+	virtual bool readSharedHeader(grk_header_info* header_info, const uint8_t* buf,
+								  uint64_t len) = 0;
+	virtual uint64_t getSharedHeader(uint8_t* buf, uint64_t len) = 0;
+	virtual bool readMetadata(grk_header_info* header_info) = 0;
 	virtual GrkImage* getImage(uint16_t tileIndex) = 0;
 	virtual GrkImage* getImage(void) = 0;
 	virtual void init(grk_decompress_core_params* p_param) = 0;
 	virtual bool setDecompressRegion(grk_rect_single region) = 0;
+	virtual bool setDecompressTiles(const uint16_t* tileIndices, uint16_t numTiles) = 0;
 	virtual bool decompress(grk_plugin_tile* tile) = 0;
 	virtual bool decompressTile(uint16_t tileIndex) = 0;
 	virtual bool preProcess(void) = 0;
 	virtual bool postProcess(void) = 0;
 	virtual void dump(uint32_t flag, FILE* outputFileStream) = 0;
+	virtual Stats* getStats(void) = 0;
+	virtual MemAccount* getMemAccount(void) = 0;
+	virtual void cancel(void) = 0;
+	virtual bool nextFrame(BufferedStream* stream) = 0;
+	virtual uint64_t transcode(BufferedStream* dest, grk_transcode_params* params) = 0;
+	virtual bool stitch(Stitcher* stitcher) = 0;
 };
 
 class TileCache;
@@ -141,9 +161,37 @@ class CodeStream
 	grk_plugin_tile* getCurrentPluginTile();
 	CodingParams* getCodingParams(void);
 	static std::string markerString(uint16_t marker);
+	/**
+	 * Get instrumentation statistics
+	 *
+	 * @return Stats, or nullptr if instrumentation is disabled
+	 */
+	Stats* getStats(void);
+	/**
+	 * Get memory account
+	 *
+	 * @return MemAccount, or nullptr if memory is not being accounted for
+	 */
+	MemAccount* getMemAccount(void);
+	/**
+	 * Get cancellation, deadline and progress control
+	 */
+	CodecControl* getControl(void);
+	/**
+	 * Get cache of reusable decompress schedulers
+	 */
+	SchedulerCache* getSchedulerCache(void);
+	/**
+	 * Get cache of decompress packet sequences
+	 */
+	PacketSequenceCache* getPacketSequenceCache(void);
 
   protected:
 	bool exec(std::vector<PROCEDURE_FUNC>& p_procedure_list);
+	void enableStats(uint32_t flags);
+	// declared before all other members, so that it outlives all accounted buffers
+	MemAccount memAccount_;
+	bool accountMemory_;
 	CodingParams cp_;
 	CodeStreamInfo* codeStreamInfo;
 	std::vector<PROCEDURE_FUNC> procedure_list_;
@@ -155,6 +203,10 @@ class CodeStream
 	BufferedStream* stream_;
 	std::map<uint32_t, TileProcessor*> processors_;
 	grk_plugin_tile* current_plugin_tile;
+	Stats* stats_;
+	CodecControl control_;
+	SchedulerCache schedulerCache_;
+	PacketSequenceCache packetSequenceCache_;
 };
 
 /** @name Exported functions */
@@ -96,6 +96,7 @@ bool CodeStreamCompress::mct_validation(void)
 
 bool CodeStreamCompress::start(void)
 {
+	MemAccountScope memScope(getMemAccount());
 	/* customization of the validation */
 	validation_list_.push_back(std::bind(&CodeStreamCompress::compressValidation, this));
 	// custom validation here
@@ -116,6 +117,7 @@ bool CodeStreamCompress::init(grk_cparameters* parameters, GrkImage* image)
 {
 	if(!parameters || !image)
 		return false;
+	enableStats(parameters->statsFlags);
 
 	bool isHT = (parameters->cblk_sty & 0X7F) == GRK_CBLKSTY_HT;
 
@@ -388,6 +390,23 @@ bool CodeStreamCompress::init(grk_cparameters* parameters, GrkImage* image)
 		cp_.t_width = image->x1 - cp_.tx0;
 		cp_.t_height = image->y1 - cp_.ty0;
 	}
+	uint16_t numTiles = (uint16_t)(cp_.t_grid_width * cp_.t_grid_height);
+	cp_.coding_params_.enc_.tileRangeBegin_ = 0;
+	cp_.coding_params_.enc_.tileRangeEnd_ = numTiles;
+	if(parameters->tileRangeEnd)
+	{
+		if(parameters->tileRangeBegin >= parameters->tileRangeEnd ||
+		   parameters->tileRangeEnd > numTiles)
+		{
+			GRK_ERROR("Invalid tile range [%u,%u) for %u tiles", parameters->tileRangeBegin,
+					  parameters->tileRangeEnd, numTiles);
+			return false;
+		}
+		cp_.coding_params_.enc_.tileRangeBegin_ = parameters->tileRangeBegin;
+		cp_.coding_params_.enc_.tileRangeEnd_ = parameters->tileRangeEnd;
+		// stitching locates the tile parts of a fragment with its TLM marker
+		cp_.coding_params_.enc_.writeTLM = true;
+	}
 	if(parameters->enableTilePartGeneration)
 	{
 		cp_.coding_params_.enc_.newTilePartProgressionDivider_ =
@@ -620,7 +639,7 @@ bool CodeStreamCompress::init(grk_cparameters* parameters, GrkImage* image)
 }
 uint64_t CodeStreamCompress::compress(grk_plugin_tile* tile)
 {
-	MinHeapPtr<TileProcessor, uint16_t, MinHeapLocker> heap;
+	MemAccountScope memScope(getMemAccount());
 	uint32_t numTiles = (uint32_t)cp_.t_grid_height * cp_.t_grid_width;
 	if(numTiles > maxNumTilesJ2K)
 	{
@@ -629,20 +648,26 @@ uint64_t CodeStreamCompress::compress(grk_plugin_tile* tile)
 				  numTiles, maxNumTilesJ2K);
 		return 0;
 	}
+	// a code stream fragment only holds the tiles in its tile range
+	uint16_t tileRangeBegin = cp_.coding_params_.enc_.tileRangeBegin_;
+	uint16_t tileRangeEnd = cp_.coding_params_.enc_.tileRangeEnd_;
+	uint32_t numRangeTiles = (uint32_t)(tileRangeEnd - tileRangeBegin);
+	MinHeapPtr<TileProcessor, uint16_t, MinHeapLocker> heap(tileRangeBegin);
 	auto numRequiredThreads =
-		std::min<uint32_t>((uint32_t)ExecSingleton::get()->num_workers(), numTiles);
+		std::min<uint32_t>((uint32_t)ExecSingleton::num_workers(), numRangeTiles);
 	std::atomic<bool> success(true);
 	if(numRequiredThreads > 1)
 	{
 		tf::Executor exec(numRequiredThreads);
 		tf::Taskflow taskflow;
-		auto node = new tf::Task[numTiles];
-		for(uint64_t i = 0; i < numTiles; i++)
+		auto node = new tf::Task[numRangeTiles];
+		for(uint64_t i = 0; i < numRangeTiles; i++)
 			node[i] = taskflow.placeholder();
-		for(uint16_t j = 0; j < numTiles; ++j)
+		for(uint32_t j = 0; j < numRangeTiles; ++j)
 		{
-			uint16_t tileIndex = j;
+			uint16_t tileIndex = (uint16_t)(tileRangeBegin + j);
 			node[j].work([this, tile, tileIndex, &heap, &success] {
+				MemAccountScope memScope(getMemAccount());
 				if(success)
 				{
 					auto tileProcessor = new TileProcessor(tileIndex, this, stream_, true, nullptr);
@@ -658,7 +683,7 @@ uint64_t CodeStreamCompress::compress(grk_plugin_tile* tile)
 	}
 	else
 	{
-		for(uint16_t i = 0; i < numTiles; ++i)
+		for(uint16_t i = tileRangeBegin; i < tileRangeEnd; ++i)
 		{
 			auto tileProcessor = new TileProcessor(i, this, stream_, true, nullptr);
 			tileProcessor->current_plugin_tile = tile;
@@ -691,9 +716,29 @@ cleanup:
 	}
 	if(success)
 		success = end();
+	if(success && stats_)
+		stats_->addCounter(GRK_COUNTER_BYTES, stream_->tell());
 
 	return success ? stream_->tell() : 0;
 }
+bool CodeStreamCompress::compressTile(uint16_t tileIndex, TILE_FUNC ingest)
+{
+	MemAccountScope memScope(getMemAccount());
+	auto tileProcessor = new TileProcessor(tileIndex, this, stream_, true, nullptr);
+	bool rc = tileProcessor->preCompressTile(ingest) && tileProcessor->doCompress() &&
+			  writeTileParts(tileProcessor);
+	delete tileProcessor;
+
+	return rc;
+}
+Stats* CodeStreamCompress::getStats(void)
+{
+	return CodeStream::getStats();
+}
+MemAccount* CodeStreamCompress::getMemAccount(void)
+{
+	return CodeStream::getMemAccount();
+}
 bool CodeStreamCompress::end(void)
 {
 	/* customization of the compressing */
@@ -957,31 +1002,27 @@ bool CodeStreamCompress::updateRates(void)
 			double* rates = tcp->rates;
 			auto tileBounds = cp->getTileBounds(image, tile_x, tile_y);
 			uint64_t numTilePixels = tileBounds.area();
-			// correction for header size is distributed amongst all tiles
+			// correction for header size is distributed amongst all tiles,
+			// and each tile also carries SOT and SOD markers for its first tile part
 			double sot_adjust =
-				((double)numTilePixels * (double)header_size) / ((double)width * height);
-			if(*rates > 0.0)
-			{
-				*rates -= sot_adjust;
-				if(*rates < 30.0f)
-					*rates = 30.0f;
-			}
-			++rates;
-			for(uint16_t k = 1; k < (uint16_t)(tcp->max_layers_ - 1); ++k)
+				((double)numTilePixels * (double)header_size) / ((double)width * height) + 14.0;
+			for(uint16_t k = 0; k < tcp->max_layers_; ++k)
 			{
-				if(*rates > 0.0)
+				if(rates[k] <= 0.0)
+					continue;
+				rates[k] -= sot_adjust;
+				// EOC marker
+				if(k == tcp->max_layers_ - 1)
+					rates[k] -= 2.0;
+				if(k == 0)
 				{
-					*rates -= sot_adjust;
-					if(*rates < *(rates - 1) + 10.0)
-						*rates = (*(rates - 1)) + 20.0;
+					if(rates[k] < 30.0f)
+						rates[k] = 30.0f;
+				}
+				else if(rates[k] < rates[k - 1] + 10.0)
+				{
+					rates[k] = rates[k - 1] + 20.0;
 				}
-				++rates;
-			}
-			if(*rates > 0.0)
-			{
-				*rates -= (sot_adjust + 2.0);
-				if(*rates < *(rates - 1) + 10.0)
-					*rates = (*(rates - 1)) + 20.0;
 			}
 		}
 	}
@@ -1939,9 +1980,9 @@ bool CodeStreamCompress::getNumTileParts(uint16_t* numTilePartsForAllTiles, GrkI
 	assert(numTilePartsForAllTiles != nullptr);
 	assert(image != nullptr);
 
-	uint32_t numTiles = (uint16_t)(cp_.t_grid_width * cp_.t_grid_height);
 	*numTilePartsForAllTiles = 0;
-	for(uint16_t tileno = 0; tileno < numTiles; ++tileno)
+	for(uint16_t tileno = cp_.coding_params_.enc_.tileRangeBegin_;
+		tileno < cp_.coding_params_.enc_.tileRangeEnd_; ++tileno)
 	{
 		auto tcp = cp_.tcps + tileno;
 		uint8_t totalTilePartsForTile = 0;
@@ -37,11 +37,23 @@ class CodeStreamCompress : public CodeStream, public ICodeStreamCompress
 	bool start(void);
 	bool init(grk_cparameters* p_param, GrkImage* p_image);
 	uint64_t compress(grk_plugin_tile* tile);
+	/**
+	 * Compress and write a single tile from wavelet coefficients.
+	 * Tiles may be compressed in any order, after the main header has been
+	 * written by start(); the code stream is completed by end()
+	 *
+	 * @param tileIndex tile index
+	 * @param ingest fills tile component windows with coefficients
+	 * @return true if successful
+	 */
+	bool compressTile(uint16_t tileIndex, TILE_FUNC ingest);
+	bool end(void);
+	Stats* getStats(void);
+	MemAccount* getMemAccount(void);
 
   private:
 	bool init_header_writing(void);
 	bool cacheEndOfHeader(void);
-	bool end(void);
 	bool writeTilePart(TileProcessor* tileProcessor);
 	bool writeTileParts(TileProcessor* tileProcessor);
 	bool updateRates(void);
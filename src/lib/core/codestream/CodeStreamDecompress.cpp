@@ -23,11 +23,25 @@
 
 namespace grk
 {
+// small image limits for inline decompression
+const uint64_t smallImageMaxSamples = 1 << 18;
+const uint64_t smallImageMaxCodeblocks = 64;
+
+static void appendMarkerSegment(std::vector<uint8_t>& signature, uint16_t id,
+								const uint8_t* data, uint16_t len)
+{
+	signature.push_back((uint8_t)(id >> 8));
+	signature.push_back((uint8_t)id);
+	signature.push_back((uint8_t)(len >> 8));
+	signature.push_back((uint8_t)len);
+	signature.insert(signature.end(), data, data + len);
+}
+
 CodeStreamDecompress::CodeStreamDecompress(BufferedStream* stream)
 	: CodeStream(stream), expectSOD_(false), curr_marker_(0), headerError_(false),
-	  headerRead_(false), marker_scratch_(nullptr), marker_scratch_size_(0), outputImage_(nullptr),
-	  tileCache_(new TileCache()), ioBufferCallback(nullptr), ioUserData(nullptr),
-	  grkRegisterReclaimCallback_(nullptr)
+	  headerRead_(false), sharedHeaderLength_(0), marker_scratch_(nullptr),
+	  marker_scratch_size_(0), outputImage_(nullptr), tileCache_(new TileCache()),
+	  ioBufferCallback(nullptr), ioUserData(nullptr), grkRegisterReclaimCallback_(nullptr)
 {
 	decompressorState_.default_tcp_ = new TileCodingParams();
 	decompressorState_.lastSotReadPosition = 0;
@@ -116,6 +130,42 @@ void CodeStreamDecompress::setExpectSOD()
 {
 	expectSOD_ = true;
 }
+uint64_t CodeStreamDecompress::transcode(BufferedStream* dest, grk_transcode_params* params)
+{
+	return transcode(dest, params, [this]() { return readHeader(nullptr); });
+}
+uint64_t CodeStreamDecompress::transcode(BufferedStream* dest, grk_transcode_params* params,
+										 std::function<bool(void)> readHeader)
+{
+	if(params && (params->crop_x1 || params->crop_y1))
+	{
+		if(params->max_layers || params->reduce || params->block_coder != GRK_BLOCK_CODER_KEEP)
+		{
+			GRK_ERROR("Transcode: cropping cannot be combined with other transcode options");
+			return 0;
+		}
+		TileCropper tileCropper(this, dest, params);
+
+		return tileCropper.crop(readHeader);
+	}
+	if(params && params->block_coder != GRK_BLOCK_CODER_KEEP)
+	{
+		BlockTranscoder blockTranscoder(this, dest, params);
+
+		return blockTranscoder.transcode(readHeader);
+	}
+	Transcoder transcoder(this, dest, params);
+
+	return transcoder.transcode(readHeader);
+}
+bool CodeStreamDecompress::stitch(Stitcher* stitcher)
+{
+	return stitcher->add(this, [this]() { return readHeader(nullptr); });
+}
+void CodeStreamDecompress::setMarkerListener(MARKER_LISTENER listener)
+{
+	markerListener_ = listener;
+}
 GrkImage* CodeStreamDecompress::getCompositeImage()
 {
 	return tileCache_->getComposite();
@@ -165,6 +215,7 @@ GrkImage* CodeStreamDecompress::getImage()
 }
 bool CodeStreamDecompress::readHeader(grk_header_info* header_info)
 {
+	MemAccountScope memScope(getMemAccount());
 	if(headerError_)
 		return false;
 
@@ -187,6 +238,13 @@ bool CodeStreamDecompress::readHeader(grk_header_info* header_info)
 		if(header_info)
 			headerImage_->hasMultipleTiles =
 				headerImage_->hasMultipleTiles && !header_info->singleTileDecompress;
+		selectTargetResolution();
+		if(cp_.coding_params_.dec_.floatOutput_)
+		{
+			auto tccps = decompressorState_.default_tcp_->tccps;
+			for(uint16_t compno = 0; compno < headerImage_->numcomps; ++compno)
+				headerImage_->comps[compno].float_data = tccps[compno].qmfbid == 0;
+		}
 		auto composite = getCompositeImage();
 		headerImage_->copyHeader(composite);
 		if(header_info)
@@ -241,6 +299,131 @@ bool CodeStreamDecompress::readHeader(grk_header_info* header_info)
 	}
 	return true;
 }
+/**
+ * Choose the lowest resolution that is at least as large as the target size,
+ * and the ratio with which it is resampled to the target size
+ */
+void CodeStreamDecompress::selectTargetResolution(void)
+{
+	auto dec = &cp_.coding_params_.dec_;
+	dec->resampleX_ = 0;
+	dec->resampleY_ = 0;
+	if(!dec->targetWidth_ && !dec->targetHeight_)
+		return;
+
+	auto image = headerImage_;
+	uint32_t w = image->x1 - image->x0;
+	uint32_t h = image->y1 - image->y0;
+	uint32_t targetWidth = dec->targetWidth_;
+	uint32_t targetHeight = dec->targetHeight_;
+	// preserve aspect ratio if only one dimension is set
+	if(!targetWidth)
+		targetWidth = (uint32_t)(((uint64_t)w * targetHeight + h / 2) / h);
+	if(!targetHeight)
+		targetHeight = (uint32_t)(((uint64_t)h * targetWidth + w / 2) / w);
+	targetWidth = std::max<uint32_t>(targetWidth, 1);
+	targetHeight = std::max<uint32_t>(targetHeight, 1);
+	if(targetWidth > w || targetHeight > h)
+	{
+		GRK_WARN("Target size %ux%u is larger than image size %ux%u: "
+				 "only downscaling is supported",
+				 targetWidth, targetHeight, w, h);
+		targetWidth = std::min<uint32_t>(targetWidth, w);
+		targetHeight = std::min<uint32_t>(targetHeight, h);
+	}
+	// reduced dimensions, as calculated for header image components
+	auto reducedWidth = [w](uint8_t reduce) { return ceildivpow2<uint32_t>(w, reduce); };
+	auto reducedHeight = [h](uint8_t reduce) { return ceildivpow2<uint32_t>(h, reduce); };
+	uint8_t maxReduce = GRK_J2K_MAX_DECOMP_LVLS;
+	auto tccps = decompressorState_.default_tcp_->tccps;
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+		maxReduce = std::min<uint8_t>(maxReduce, (uint8_t)(tccps[compno].numresolutions - 1));
+	uint8_t reduce = 0;
+	while(reduce < maxReduce && reducedWidth((uint8_t)(reduce + 1)) >= targetWidth &&
+		  reducedHeight((uint8_t)(reduce + 1)) >= targetHeight)
+		reduce++;
+	dec->reduce_ = reduce;
+	SIZMarker::subsampleAndReduceHeaderImageComponents(image, &cp_);
+	if(reducedWidth(reduce) != targetWidth || reducedHeight(reduce) != targetHeight)
+	{
+		dec->resampleX_ = (double)targetWidth / reducedWidth(reduce);
+		dec->resampleY_ = (double)targetHeight / reducedHeight(reduce);
+	}
+}
+bool CodeStreamDecompress::readSharedHeader(grk_header_info* header_info, const uint8_t* buf,
+											uint64_t len)
+{
+	return readSharedHeader(buf, len, [this, header_info]() { return readHeader(header_info); });
+}
+bool CodeStreamDecompress::readSharedHeader(const uint8_t* buf, uint64_t len,
+											std::function<bool(void)> readHeader)
+{
+	if(!buf || !len)
+		return false;
+	if(headerRead_ || headerError_)
+	{
+		GRK_ERROR("Shared header must be read instead of main header");
+		return false;
+	}
+	auto headerStream = create_mem_stream((uint8_t*)buf, (size_t)len, false, true);
+	if(!headerStream)
+		return false;
+	// parse shared header in place of code stream, then resume code stream
+	// at its first tile part, which immediately follows the shared header
+	auto sourceStream = stream_;
+	stream_ = BufferedStream::getImpl(headerStream);
+	bool rc = readHeader();
+	stream_ = sourceStream;
+	grk_object_unref(headerStream);
+	if(!rc)
+		return false;
+	if(sharedHeaderLength_ != len)
+	{
+		GRK_ERROR("Shared header length %" PRIu64 " does not match main header length %" PRIu64,
+				  len, sharedHeaderLength_);
+		headerError_ = true;
+		return false;
+	}
+	if(!stream_->seek(sharedHeaderLength_))
+	{
+		GRK_ERROR("Unable to seek to first tile part of code stream");
+		headerError_ = true;
+		return false;
+	}
+
+	return true;
+}
+uint64_t CodeStreamDecompress::getSharedHeader(uint8_t* buf, uint64_t len)
+{
+	if(!headerRead_ || headerError_)
+	{
+		GRK_ERROR("Main header must be read before getting shared header");
+		return 0;
+	}
+	if(!buf)
+		return sharedHeaderLength_;
+	if(len < sharedHeaderLength_)
+	{
+		GRK_ERROR("Buffer length %" PRIu64 " is less than shared header length %" PRIu64, len,
+				  sharedHeaderLength_);
+		return 0;
+	}
+	auto position = stream_->tell();
+	if(!stream_->seek(0) || stream_->read(buf, sharedHeaderLength_) != sharedHeaderLength_)
+	{
+		GRK_ERROR("Unable to read shared header");
+		stream_->seek(position);
+		return 0;
+	}
+	if(!stream_->seek(position))
+		return 0;
+
+	return sharedHeaderLength_;
+}
+bool CodeStreamDecompress::readMetadata([[maybe_unused]] grk_header_info* header_info)
+{
+	return true;
+}
 bool CodeStreamDecompress::setDecompressRegion(grk_rect_single region)
 {
 	auto image = headerImage_;
@@ -350,6 +533,50 @@ bool CodeStreamDecompress::setDecompressRegion(grk_rect_single region)
 
 	return true;
 }
+bool CodeStreamDecompress::setDecompressTiles(const uint16_t* tileIndices, uint16_t numTiles)
+{
+	if(decompressorState_.getState() != DECOMPRESS_STATE_TPH_SOT)
+	{
+		GRK_ERROR("Need to read the main header before setting tiles to decompress");
+		return false;
+	}
+	if(!tileIndices || !numTiles)
+	{
+		GRK_ERROR("No tiles to decompress");
+		return false;
+	}
+	uint32_t numTilesTotal = (uint32_t)cp_.t_grid_width * cp_.t_grid_height;
+	grk_rect16 bounds(UINT16_MAX, UINT16_MAX, 0, 0);
+	for(uint16_t i = 0; i < numTiles; ++i)
+	{
+		auto tileIndex = tileIndices[i];
+		if(tileIndex >= numTilesTotal)
+		{
+			GRK_ERROR("Tile index %u is greater than maximum tile index %u", tileIndex,
+					  numTilesTotal - 1);
+			return false;
+		}
+		auto tileX = (uint16_t)(tileIndex % cp_.t_grid_width);
+		auto tileY = (uint16_t)(tileIndex / cp_.t_grid_width);
+		bounds.x0 = std::min<uint16_t>(bounds.x0, tileX);
+		bounds.y0 = std::min<uint16_t>(bounds.y0, tileY);
+		bounds.x1 = std::max<uint16_t>(bounds.x1, (uint16_t)(tileX + 1));
+		bounds.y1 = std::max<uint16_t>(bounds.y1, (uint16_t)(tileY + 1));
+	}
+	// decompress region is the bounding box of the tiles; tiles inside the box
+	// that are not in the set are skipped, using TLM marker if present
+	auto image = headerImage_;
+	auto first = cp_.getTileBounds(image, bounds.x0, bounds.y0);
+	auto last = cp_.getTileBounds(image, bounds.x1 - 1U, bounds.y1 - 1U);
+	if(!setDecompressRegion(grk_rect_single((float)(first.x0 - image->x0),
+											(float)(first.y0 - image->y0),
+											(float)(last.x1 - image->x0),
+											(float)(last.y1 - image->y0))))
+		return false;
+	decompressorState_.tilesToDecompress_.schedule(tileIndices, numTiles);
+
+	return true;
+}
 void CodeStreamDecompress::init(grk_decompress_core_params* parameters)
 {
 	assert(parameters);
@@ -357,14 +584,45 @@ void CodeStreamDecompress::init(grk_decompress_core_params* parameters)
 	cp_.coding_params_.dec_.layers_to_decompress_ = parameters->layers_to_decompress_;
 	cp_.coding_params_.dec_.reduce_ = parameters->reduce;
 	cp_.coding_params_.dec_.randomAccessFlags_ = parameters->randomAccessFlags_;
+	cp_.coding_params_.dec_.floatOutput_ = parameters->float_output;
+	cp_.coding_params_.dec_.targetWidth_ = parameters->target_width;
+	cp_.coding_params_.dec_.targetHeight_ = parameters->target_height;
 	tileCache_->setStrategy(parameters->tileCacheStrategy);
 
 	ioBufferCallback = parameters->io_buffer_callback;
 	ioUserData = parameters->io_user_data;
 	grkRegisterReclaimCallback_ = parameters->io_register_client_callback;
+	enableStats(parameters->statsFlags_);
+	stripCache_.setStats(stats_);
+	memBudget_.setLimit(parameters->max_memory);
+	control_.init(parameters->deadline_ms, parameters->progress_callback,
+				  parameters->progress_user_data);
+	stripCache_.setMemBudget(&memBudget_);
+}
+bool CodeStreamDecompress::isSmallImage(void)
+{
+	auto image = getCompositeImage();
+	auto tcp = decompressorState_.default_tcp_;
+	if(!image || !tcp || !tcp->tccps)
+		return false;
+	uint64_t samples = 0;
+	uint64_t codeblocks = 0;
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		auto tccp = tcp->tccps + compno;
+		uint64_t cblkw = (uint64_t)1 << tccp->cblkw;
+		uint64_t cblkh = (uint64_t)1 << tccp->cblkh;
+		samples += (uint64_t)comp->w * comp->h;
+		codeblocks += ((comp->w + cblkw - 1) / cblkw) * ((comp->h + cblkh - 1) / cblkh);
+	}
+
+	return samples <= smallImageMaxSamples && codeblocks <= smallImageMaxCodeblocks;
 }
 bool CodeStreamDecompress::decompress(grk_plugin_tile* tile)
 {
+	MemAccountScope memScope(getMemAccount());
+	InlineExecScope inlineScope(isSmallImage());
 	procedure_list_.push_back(std::bind(&CodeStreamDecompress::decompressTiles, this));
 	current_plugin_tile = tile;
 
@@ -372,6 +630,7 @@ bool CodeStreamDecompress::decompress(grk_plugin_tile* tile)
 }
 bool CodeStreamDecompress::decompressTile(uint16_t tileIndex)
 {
+	MemAccountScope memScope(getMemAccount());
 	// 1. check if tile has already been decompressed
 	auto entry = tileCache_->get(tileIndex);
 	if(entry && entry->processor && entry->processor->getImage())
@@ -443,6 +702,7 @@ bool CodeStreamDecompress::decompressTile(uint16_t tileIndex)
 
 	/* customization of the decoding */
 	procedure_list_.push_back([this] { return decompressTile(); });
+	InlineExecScope inlineScope(isSmallImage());
 
 	return decompressExec();
 }
@@ -461,9 +721,10 @@ bool CodeStreamDecompress::decompressTiles(void)
 	}
 	if(!createOutputImage())
 		return false;
+	control_.start(decompressorState_.tilesToDecompress_.numScheduled());
 
 	auto numRequiredThreads =
-		std::min<uint32_t>((uint32_t)ExecSingleton::get()->num_workers(), numTilesToDecompress);
+		std::min<uint32_t>((uint32_t)ExecSingleton::num_workers(), numTilesToDecompress);
 	if(outputImage_->supportsStripCache(&cp_))
 	{
 		uint32_t numStrips = cp_.t_grid_height;
@@ -472,7 +733,7 @@ bool CodeStreamDecompress::decompressTiles(void)
 			numStrips = (outputImage_->height() + outputImage_->rowsPerStrip - 1) /
 						outputImage_->rowsPerStrip;
 		}
-		stripCache_.init((uint32_t)ExecSingleton::get()->num_workers(), cp_.t_grid_width, numStrips,
+		stripCache_.init((uint32_t)ExecSingleton::num_workers(), cp_.t_grid_width, numStrips,
 						 numTilesToDecompress > 1 ? cp_.t_height : outputImage_->rowsPerStrip,
 						 cp_.coding_params_.dec_.reduce_, outputImage_, ioBufferCallback,
 						 ioUserData, grkRegisterReclaimCallback_);
@@ -496,7 +757,13 @@ bool CodeStreamDecompress::decompressTiles(void)
 	uint16_t tileCount = 0;
 	while(!endOfCodeStream() && !breakAfterT1)
 	{
+		if(control_.isCancelled())
+		{
+			success = false;
+			goto cleanup;
+		}
 		// 1. parse tile
+		uint64_t parseStart = stats_ ? Stats::now() : 0;
 		try
 		{
 			if(!parseTileParts(&canDecompress))
@@ -536,13 +803,24 @@ bool CodeStreamDecompress::decompressTiles(void)
 		{
 			breakAfterT1 = true;
 		}
+		if(stats_)
+			stats_->addSpan(GRK_STAGE_MARKER_PARSE, processor->getIndex(), parseStart,
+							Stats::now());
 		// 3. T2 + T1 decompress
 		// once we schedule a processor for T1 compression, we will destroy it
 		// regardless of success or not
 		auto exec = [this, executor, processor, numTilesToDecompress, &numTilesDecompressed,
 					 &success] {
+			MemAccountScope memScope(getMemAccount());
+			if(success && control_.isCancelled())
+				success = false;
 			if(success)
 			{
+				// wait until tile fits into memory budget
+				uint64_t estimate =
+					memBudget_.enabled() ? processor->getDecompressMemoryEstimate() : 0;
+				MemReservation reservation(&memBudget_, estimate);
+				ScopedSpan tileSpan(stats_, GRK_STAGE_TILE, processor->getIndex());
 				if(!processor->decompressT2T1(outputImage_))
 				{
 					GRK_ERROR("Failed to decompress tile %u/%u", processor->getIndex(),
@@ -552,9 +830,13 @@ bool CodeStreamDecompress::decompressTiles(void)
 				else
 				{
 					numTilesDecompressed++;
+					control_.tileDone();
+					if(stats_)
+						stats_->addCounter(GRK_COUNTER_TILES, 1);
 					auto img = processor->getImage();
 					if(outputImage_->hasMultipleTiles && img)
 					{
+						ScopedSpan outputSpan(stats_, GRK_STAGE_OUTPUT, processor->getIndex());
 						if(outputImage_->supportsStripCache(&cp_))
 						{
 							if(executor)
@@ -635,8 +917,96 @@ cleanup:
 		delete executor;
 		delete[] node;
 	}
+	if(!success && control_.isCancelled())
+		control_.logCancel();
+
 	return success;
 }
+bool CodeStreamDecompress::scanTiles(TILE_PACKETS_FUNC callback)
+{
+	std::vector<PacketSpan> packets;
+
+	return parseTiles([&packets, callback](TileProcessor* tileProcessor) {
+		packets.clear();
+		return tileProcessor->scanPackets(&packets) && callback(tileProcessor, packets);
+	});
+}
+bool CodeStreamDecompress::decompressCoefficients(TILE_FUNC callback)
+{
+	return parseTiles([this, callback](TileProcessor* tileProcessor) {
+		return tileProcessor->decompressCoefficients(getHeaderImage()) && callback(tileProcessor);
+	});
+}
+bool CodeStreamDecompress::parseTiles(TILE_FUNC callback)
+{
+	MemAccountScope memScope(getMemAccount());
+	uint16_t numTiles = (uint16_t)(cp_.t_grid_height * cp_.t_grid_width);
+	if(codeStreamInfo && !codeStreamInfo->allocTileInfo(numTiles))
+	{
+		headerError_ = true;
+		return false;
+	}
+	uint16_t numTilesParsed = 0;
+	bool lastTile = false;
+	bool canDecompress = true;
+	while(!endOfCodeStream() && !lastTile)
+	{
+		// 1. parse tile
+		try
+		{
+			if(!parseTileParts(&canDecompress))
+				return false;
+		}
+		catch(InvalidMarkerException& ime)
+		{
+			GRK_ERROR("Found invalid marker : 0x%x", ime.marker_);
+			return false;
+		}
+		if(!canDecompress)
+			continue;
+		if(!currentTileProcessor_)
+		{
+			GRK_ERROR("Missing SOT marker");
+			return false;
+		}
+		// 2. find next tile (or EOC)
+		auto processor = currentTileProcessor_;
+		currentTileProcessor_ = nullptr;
+		try
+		{
+			if(!endOfCodeStream() && !findNextSOT(processor))
+			{
+				GRK_ERROR("Failed to find next SOT marker or EOC after tile %u/%u",
+						  processor->getIndex(), numTiles);
+				return false;
+			}
+		}
+		catch([[maybe_unused]] DecodeUnknownMarkerAtEndOfTileException& e)
+		{
+			lastTile = true;
+		}
+		// 3. process tile, then discard its compressed data
+		bool rc = callback(processor);
+		cp_.tcps[processor->getIndex()].releaseCompressedData();
+		processor->release(GRK_TILE_CACHE_NONE);
+		if(!rc)
+			return false;
+		numTilesParsed++;
+		if(decompressorState_.tilesToDecompress_.allComplete())
+			break;
+	}
+	if(numTilesParsed == 0)
+	{
+		GRK_ERROR("No tiles were found.");
+		return false;
+	}
+	else if(numTilesParsed < numTiles)
+	{
+		GRK_WARN("Only %u out of %u tiles were found", numTilesParsed, numTiles);
+	}
+
+	return true;
+}
 bool CodeStreamDecompress::copy_default_tcp(void)
 {
 	for(uint16_t i = 0; i < cp_.t_grid_height * cp_.t_grid_width; ++i)
@@ -663,6 +1033,7 @@ GrkImage* CodeStreamDecompress::getHeaderImage(void)
 }
 bool CodeStreamDecompress::readHeaderProcedure(void)
 {
+	ScopedSpan span(stats_, GRK_STAGE_MARKER_PARSE, 0);
 	bool rc = false;
 	try
 	{
@@ -741,6 +1112,9 @@ bool CodeStreamDecompress::readHeaderProcedureImpl(void)
 		// 3. handle marker
 		if(!process_marker(marker_handler, markerParametersLength))
 			return false;
+		if(isFrameSignatureMarker(marker_handler->id))
+			appendMarkerSegment(frameSignature_, marker_handler->id, marker_scratch_,
+								markerParametersLength);
 
 		// 4. add the marker to code stream index
 		uint16_t markerSegmentLength = MARKER_PLUS_MARKER_LENGTH_BYTES + markerParametersLength;
@@ -773,6 +1147,7 @@ bool CodeStreamDecompress::readHeaderProcedureImpl(void)
 	// subtract bytes for already-read SOT marker
 	if(codeStreamInfo)
 		codeStreamInfo->setMainHeaderEnd(stream_->tell() - MARKER_BYTES);
+	sharedHeaderLength_ = stream_->tell();
 
 	// rewind TLM marker if present
 	if(cp_.tlm_markers)
@@ -783,6 +1158,180 @@ bool CodeStreamDecompress::readHeaderProcedureImpl(void)
 
 	return true;
 }
+bool CodeStreamDecompress::isFrameSignatureMarker(uint16_t id)
+{
+	switch(id)
+	{
+		case J2K_MS_TLM:
+		case J2K_MS_PLM:
+		case J2K_MS_CRG:
+		case J2K_MS_COM:
+			return false;
+		default:
+			return true;
+	}
+}
+bool CodeStreamDecompress::nextFrame(BufferedStream* stream)
+{
+	MemAccountScope memScope(getMemAccount());
+	if(!headerRead_ || headerError_)
+	{
+		GRK_ERROR("Main header of first frame must be read before moving to next frame");
+		return false;
+	}
+	if(stream->getFormat() != GRK_CODEC_J2K)
+	{
+		GRK_ERROR("Next frame must be a JPEG 2000 code stream");
+		return false;
+	}
+	auto previousStream = stream_;
+	auto previousInfo = codeStreamInfo;
+	auto previousState = decompressorState_.getState();
+	stream_ = stream;
+	codeStreamInfo = new CodeStreamInfo(stream);
+	bool rc = false;
+	try
+	{
+		rc = readFrameHeader();
+	}
+	catch(InvalidMarkerException& ime)
+	{
+		GRK_ERROR("Found invalid marker : 0x%x", ime.marker_);
+		rc = false;
+	}
+	if(!rc)
+	{
+		// previous frame is left intact
+		delete codeStreamInfo;
+		codeStreamInfo = previousInfo;
+		stream_ = previousStream;
+		decompressorState_.setState(previousState);
+		return false;
+	}
+	delete previousInfo;
+
+	return resetFrame();
+}
+bool CodeStreamDecompress::readFrameHeader(void)
+{
+	ScopedSpan span(stats_, GRK_STAGE_MARKER_PARSE, 0);
+	if(!read_soc())
+	{
+		GRK_ERROR("Code stream must begin with SOC marker ");
+		return false;
+	}
+	if(!readMarker())
+		return false;
+	std::vector<uint8_t> signature;
+	// length markers are only applied once the header has been validated
+	std::vector<std::pair<const marker_handler*, std::vector<uint8_t>>> lengthMarkers;
+	while(curr_marker_ != J2K_MS_SOT)
+	{
+		auto marker_handler = get_marker_handler(curr_marker_);
+		if(!marker_handler)
+		{
+			if(!read_unk())
+				return false;
+			if(curr_marker_ == J2K_MS_SOT)
+				break;
+			marker_handler = get_marker_handler(curr_marker_);
+		}
+		if(!(decompressorState_.getState() & marker_handler->states))
+		{
+			GRK_ERROR("Marker %u is not compliant with its position", curr_marker_);
+			return false;
+		}
+		if(marker_handler->id == J2K_MS_PPM)
+		{
+			GRK_ERROR("PPM marker is not supported for frame sequences");
+			return false;
+		}
+		uint16_t markerParametersLength;
+		if(!read_short(&markerParametersLength))
+			return false;
+		else if(markerParametersLength == MARKER_LENGTH_BYTES)
+		{
+			GRK_ERROR("Zero-size marker in header.");
+			return false;
+		}
+		markerParametersLength = (uint16_t)(markerParametersLength - MARKER_LENGTH_BYTES);
+		if(!readMarkerSegment(markerParametersLength))
+			return false;
+		if(isFrameSignatureMarker(marker_handler->id))
+		{
+			appendMarkerSegment(signature, marker_handler->id, marker_scratch_,
+								markerParametersLength);
+			// SIZ handler is not run, so advance state here
+			if(marker_handler->id == J2K_MS_SIZ)
+				decompressorState_.setState(DECOMPRESS_STATE_MH);
+		}
+		else if(marker_handler->id == J2K_MS_TLM || marker_handler->id == J2K_MS_PLM)
+		{
+			lengthMarkers.push_back(std::make_pair(
+				marker_handler, std::vector<uint8_t>(marker_scratch_,
+													 marker_scratch_ + markerParametersLength)));
+		}
+		uint16_t markerSegmentLength = MARKER_PLUS_MARKER_LENGTH_BYTES + markerParametersLength;
+		addMarker(marker_handler->id, stream_->tell() - markerSegmentLength, markerSegmentLength);
+		if(!readMarker())
+			return false;
+	}
+	if(signature != frameSignature_)
+	{
+		GRK_ERROR("Main header of next frame does not match main header of first frame");
+		return false;
+	}
+	// parse length markers into new objects: previous frame's markers
+	// are only replaced once all of them have been read successfully
+	auto previousTLM = cp_.tlm_markers;
+	auto previousPLM = cp_.plm_markers;
+	cp_.tlm_markers = nullptr;
+	cp_.plm_markers = nullptr;
+	for(auto& m : lengthMarkers)
+	{
+		if(!m.first->func(m.second.data(), (uint16_t)m.second.size()))
+		{
+			delete cp_.tlm_markers;
+			cp_.tlm_markers = previousTLM;
+			delete cp_.plm_markers;
+			cp_.plm_markers = previousPLM;
+			return false;
+		}
+	}
+	delete previousTLM;
+	delete previousPLM;
+	if(cp_.tlm_markers)
+		cp_.tlm_markers->rewind();
+	codeStreamInfo->setMainHeaderEnd(stream_->tell() - MARKER_BYTES);
+	sharedHeaderLength_ = stream_->tell();
+	decompressorState_.setState(DECOMPRESS_STATE_TPH_SOT);
+
+	return true;
+}
+bool CodeStreamDecompress::resetFrame(void)
+{
+	// tile part headers may override main header coding parameters,
+	// so tile coding parameters are regenerated from the defaults
+	uint16_t numTiles = (uint16_t)(cp_.t_grid_width * cp_.t_grid_height);
+	delete[] cp_.tcps;
+	cp_.tcps = new TileCodingParams[numTiles];
+	for(uint16_t i = 0; i < numTiles; ++i)
+		(cp_.tcps + i)->tccps = new TileComponentCodingParams[headerImage_->numcomps];
+	if(!copy_default_tcp())
+		return false;
+	tileCache_->clear();
+	currentTileProcessor_ = nullptr;
+	expectSOD_ = false;
+	decompressorState_.tilesToDecompress_.resetComplete();
+	decompressorState_.lastSotReadPosition = 0;
+	decompressorState_.lastTilePartInCodeStream = false;
+	// recycle previous frame's composite buffers: every scheduled tile is
+	// fully overwritten by the next frame
+	if(outputImage_ && outputImage_->hasMultipleTiles)
+		getCompositeImage()->transferDataTo(outputImage_);
+
+	return true;
+}
 bool CodeStreamDecompress::decompressExec(void)
 {
 	if(!exec(procedure_list_))
@@ -841,6 +1390,7 @@ bool CodeStreamDecompress::decompressTile(void)
 		return false;
 	}
 	outputImage_->hasMultipleTiles = false;
+	control_.start(1);
 	uint16_t tileIndex = decompressorState_.tilesToDecompress_.getSingle();
 	auto tileCache = tileCache_->get(tileIndex);
 	auto tileProcessor = tileCache ? tileCache->processor : nullptr;
@@ -869,6 +1419,7 @@ bool CodeStreamDecompress::decompressTile(void)
 			decompressorState_.setState(DECOMPRESS_STATE_TPH_SOT);
 
 		bool canDecompress = true;
+		uint64_t parseStart = stats_ ? Stats::now() : 0;
 		try
 		{
 			if(!parseTileParts(&canDecompress))
@@ -880,18 +1431,31 @@ bool CodeStreamDecompress::decompressTile(void)
 			return false;
 		}
 		tileProcessor = currentTileProcessor_;
+		if(stats_ && tileProcessor)
+			stats_->addSpan(GRK_STAGE_MARKER_PARSE, tileProcessor->getIndex(), parseStart,
+							Stats::now());
 		if(outputImage_->supportsStripCache(&cp_))
 		{
 			uint32_t numStrips = (outputImage_->height() + outputImage_->rowsPerStrip - 1) /
 								 outputImage_->rowsPerStrip;
-			stripCache_.init((uint32_t)ExecSingleton::get()->num_workers(), 1, numStrips,
+			stripCache_.init((uint32_t)ExecSingleton::num_workers(), 1, numStrips,
 							 outputImage_->rowsPerStrip, cp_.coding_params_.dec_.reduce_,
 							 outputImage_, ioBufferCallback, ioUserData,
 							 grkRegisterReclaimCallback_);
 		}
 
-		if(!tileProcessor->decompressT2T1(outputImage_))
-			return false;
+		{
+			ScopedSpan tileSpan(stats_, GRK_STAGE_TILE, tileProcessor->getIndex());
+			if(control_.isCancelled() || !tileProcessor->decompressT2T1(outputImage_))
+			{
+				if(control_.isCancelled())
+					control_.logCancel();
+				return false;
+			}
+		}
+		control_.tileDone();
+		if(stats_)
+			stats_->addCounter(GRK_COUNTER_TILES, 1);
 
 		// check for corrupt Adobe images where a final tile part is not parsed
 		// due to incorrectly-signalled number of tile parts
@@ -957,6 +1521,20 @@ bool CodeStreamDecompress::decompressValidation(void)
 }
 bool CodeStreamDecompress::process_marker(const marker_handler* marker_handler,
 										  uint16_t marker_size)
+{
+	if(!readMarkerSegment(marker_size))
+		return false;
+	if(!marker_handler->func(marker_scratch_, marker_size))
+		return false;
+	if(markerListener_)
+	{
+		int32_t tileIndex = isDecodingTilePartHeader() ? currentTileProcessor_->getIndex() : -1;
+		return markerListener_(tileIndex, marker_handler->id, marker_scratch_, marker_size);
+	}
+
+	return true;
+}
+bool CodeStreamDecompress::readMarkerSegment(uint16_t marker_size)
 {
 	if(!marker_scratch_)
 	{
@@ -980,7 +1558,7 @@ bool CodeStreamDecompress::process_marker(const marker_handler* marker_handler,
 		return false;
 	}
 
-	return marker_handler->func(marker_scratch_, marker_size);
+	return true;
 }
 bool CodeStreamDecompress::read_short(uint16_t* val)
 {
@@ -1040,14 +1618,25 @@ bool CodeStreamDecompress::postProcess(void)
 	}
 
 	auto img = getCompositeImage();
-	img->applyColourManagement();
-	if(!img->convertToRGB(cp_.wholeTileDecompress_))
-		return false;
+	// colour and precision conversions need integer samples
+	bool floatData = img->hasFloatData();
+	if(!floatData)
+	{
+		img->applyColourManagement();
+		if(!img->convertToRGB(cp_.wholeTileDecompress_))
+			return false;
+	}
 	if(!img->greyToRGB())
 		return false;
-	img->convertPrecision();
+	if(!floatData)
+		img->convertPrecision();
+	if(!img->execUpsample())
+		return false;
+	// strip cache resamples strips as they are serialized
+	if(stripCache_.isInitialized())
+		return true;
 
-	return img->execUpsample();
+	return img->resample(cp_.coding_params_.dec_.resampleX_, cp_.coding_params_.dec_.resampleY_);
 }
 
 void CodeStreamDecompress::dump_tile_info(TileCodingParams* default_tile, uint32_t numcomps,
@@ -1109,6 +1698,18 @@ void CodeStreamDecompress::dump_tile_info(TileCodingParams* default_tile, uint32
 	}
 }
 
+Stats* CodeStreamDecompress::getStats(void)
+{
+	return CodeStream::getStats();
+}
+MemAccount* CodeStreamDecompress::getMemAccount(void)
+{
+	return CodeStream::getMemAccount();
+}
+void CodeStreamDecompress::cancel(void)
+{
+	control_.cancel();
+}
 void CodeStreamDecompress::dump(uint32_t flag, FILE* outputFileStream)
 {
 	/* Check if the flag is compatible with j2k file*/
@@ -23,7 +23,21 @@
 
 namespace grk
 {
+struct PacketSpan;
+
 typedef std::function<bool(uint8_t* headerData, uint16_t header_size)> MARKER_FUNC;
+/**
+ * Receives marker segments as they are read: tile index is -1 for main header
+ * marker segments
+ */
+typedef std::function<bool(int32_t tileIndex, uint16_t id, const uint8_t* headerData,
+						   uint16_t header_size)>
+	MARKER_LISTENER;
+/**
+ * Receives all packets of a tile
+ */
+typedef std::function<bool(TileProcessor* tileProcessor, std::vector<PacketSpan>& packets)>
+	TILE_PACKETS_FUNC;
 struct marker_handler
 {
 	marker_handler(uint16_t ID, uint32_t flags, MARKER_FUNC f) : id(ID), states(flags), func(f) {}
@@ -44,11 +58,40 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	TileCodingParams* get_current_decode_tcp(void);
 	bool isDecodingTilePartHeader();
 	bool readHeader(grk_header_info* header_info);
+	bool readSharedHeader(grk_header_info* header_info, const uint8_t* buf, uint64_t len);
+	/**
+	 * Read main header from a shared header rather than from the code stream,
+	 * then position the code stream at its first tile part
+	 *
+	 * @param buf shared header
+	 * @param len length of shared header
+	 * @param readHeader reads main header, along with any enclosing file format boxes
+	 * @return true if successful
+	 */
+	bool readSharedHeader(const uint8_t* buf, uint64_t len, std::function<bool(void)> readHeader);
+	/**
+	 * Get shared header : all bytes of the stream preceding the first tile part,
+	 * including the SOT marker of the first tile part
+	 *
+	 * @param buf buffer to copy shared header into (may be null)
+	 * @param len length of buffer
+	 * @return length of shared header, or 0 if main header has not been read
+	 */
+	uint64_t getSharedHeader(uint8_t* buf, uint64_t len);
+	/**
+	 * Read deferred metadata boxes. Code streams have no file format boxes,
+	 * so there is nothing to read
+	 *
+	 * @param header_info header info
+	 * @return true
+	 */
+	bool readMetadata(grk_header_info* header_info);
 	GrkImage* getImage(uint16_t tileIndex);
 	GrkImage* getImage(void);
 	std::vector<GrkImage*> getAllImages(void);
 	void init(grk_decompress_core_params* p_param);
 	bool setDecompressRegion(grk_rect_single region);
+	bool setDecompressTiles(const uint16_t* tileIndices, uint16_t numTiles);
 	bool decompress(grk_plugin_tile* tile);
 	bool decompressTile(uint16_t tileIndex);
 	bool preProcess(void);
@@ -60,8 +103,61 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	GrkImage* getHeaderImage(void);
 	uint16_t getCurrentMarker(void);
 	void dump(uint32_t flag, FILE* outputFileStream);
+	Stats* getStats(void);
+	MemAccount* getMemAccount(void);
+	void cancel(void);
+	/**
+	 * Move to next frame of a code stream sequence, reusing all state derived
+	 * from the main header
+	 *
+	 * @param stream stream for next frame
+	 * @return true if next frame's main header matches the first frame's
+	 */
+	bool nextFrame(BufferedStream* stream);
 	bool needsHeaderRead(void);
 	void setExpectSOD();
+	uint64_t transcode(BufferedStream* dest, grk_transcode_params* params);
+	/**
+	 * Transcode code stream
+	 *
+	 * @param dest destination stream
+	 * @param params transcode parameters
+	 * @param readHeader reads main header, along with any enclosing file format boxes
+	 * @return number of bytes written, or 0 on failure
+	 */
+	uint64_t transcode(BufferedStream* dest, grk_transcode_params* params,
+					   std::function<bool(void)> readHeader);
+	/**
+	 * Add code stream to stitcher as a fragment
+	 *
+	 * @param stitcher stitcher
+	 * @return true if successful
+	 */
+	bool stitch(Stitcher* stitcher);
+	/**
+	 * Set listener for main header and tile part header marker segments
+	 *
+	 * @param listener listener
+	 */
+	void setMarkerListener(MARKER_LISTENER listener);
+	/**
+	 * Parse all tiles in code stream order, locating the packets of each tile
+	 * without decompressing them
+	 *
+	 * @param callback receives each tile's packets
+	 * @return true if successful
+	 */
+	bool scanTiles(TILE_PACKETS_FUNC callback);
+	/**
+	 * Parse all tiles in code stream order, decompressing each tile's code blocks
+	 * into wavelet coefficients, without applying inverse wavelet transform,
+	 * multi component transform or DC level shift
+	 *
+	 * @param callback receives each tile, whose tile component windows
+	 * hold the coefficients
+	 * @return true if successful
+	 */
+	bool decompressCoefficients(TILE_FUNC callback);
 
   protected:
 	void dump_MH_info(FILE* outputFileStream);
@@ -86,6 +182,14 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	void dump_image_comp_header(grk_image_comp* comp, bool dev_dump_flag, FILE* outputFileStream);
 
   private:
+	/**
+	 * Parse all tiles in code stream order, releasing each tile's compressed data
+	 * after it has been processed
+	 *
+	 * @param callback processes each tile
+	 * @return true if successful
+	 */
+	bool parseTiles(TILE_FUNC callback);
 	bool readCurrentMarkerBody(uint16_t* markerSize);
 	bool endOfCodeStream(void);
 	bool read_short(uint16_t* val);
@@ -93,6 +197,20 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	bool readSOTorEOC(void);
 	bool parseTileParts(bool* can_decode_tile_data);
 	bool readHeaderProcedureImpl(void);
+	void selectTargetResolution(void);
+	/**
+	 * Read main header of next frame, and validate it against the first frame's
+	 */
+	bool readFrameHeader(void);
+	/**
+	 * Reset state that is specific to a frame's tile parts
+	 */
+	bool resetFrame(void);
+	bool readMarkerSegment(uint16_t markerSize);
+	/**
+	 * Check if main header marker must be identical for all frames in a sequence
+	 */
+	static bool isFrameSignatureMarker(uint16_t id);
 	bool decompressExec();
 	bool decompressTile();
 	bool findNextSOT(TileProcessor* tileProcessor);
@@ -100,6 +218,11 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	bool hasTLM(void);
 	void nextTLM(void);
 	bool decompressTiles(void);
+	/**
+	 * Check if image is small enough to be decompressed inline on the calling thread,
+	 * where fixed executor and task graph overhead would outweigh parallelism
+	 */
+	bool isSmallImage(void);
 	bool decompressValidation(void);
 	bool copy_default_tcp(void);
 	bool read_unk(void);
@@ -323,10 +446,17 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	uint16_t curr_marker_;
 	bool headerError_;
 	bool headerRead_;
+	// length of stream up to and including SOT marker of first tile part
+	uint64_t sharedHeaderLength_;
 	uint8_t* marker_scratch_;
 	uint16_t marker_scratch_size_;
+	// main header marker segments shared by all frames of a sequence
+	std::vector<uint8_t> frameSignature_;
+	MARKER_LISTENER markerListener_;
 	GrkImage* outputImage_;
 	TileCache* tileCache_;
+	// declared before strip cache, which releases its pooled buffers from the budget
+	MemBudget memBudget_;
 	StripCache stripCache_;
 	grk_io_pixels_callback ioBufferCallback;
 	void* ioUserData;
@@ -554,14 +554,19 @@ bool CodeStreamDecompress::read_plt(uint8_t* headerData, uint16_t header_size)
 {
 	assert(headerData != nullptr);
 	auto tileProcessor = currentProcessor();
+	auto markers = tileProcessor->packetLengthCache.createMarkers(nullptr);
+	if((cp_.coding_params_.dec_.randomAccessFlags_ & GRK_RANDOM_ACCESS_PLT) == 0)
+		markers->disable();
+	// memory streams hold the whole code stream, so marker is recorded as a byte range
+	// of the stream, and packet lengths are decoded from it in place
+	if(stream_->supportsZeroCopy())
+	{
+		auto data = stream_->getZeroCopyPtr() - header_size;
+		assert(memcmp(data, headerData, header_size) == 0);
+		return markers->readPLT(data, header_size, true);
+	}
 
-	bool rc =
-		tileProcessor->packetLengthCache.createMarkers(nullptr)->readPLT(headerData, header_size);
-	// disable
-	if(rc && (cp_.coding_params_.dec_.randomAccessFlags_ & GRK_RANDOM_ACCESS_PLT) == 0)
-		tileProcessor->packetLengthCache.getMarkers()->disable();
-
-	return rc;
+	return markers->readPLT(headerData, header_size, false);
 }
 /**
  * Reads a PPM marker (Packed packet headers, main header)
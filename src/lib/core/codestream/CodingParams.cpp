@@ -231,6 +231,11 @@ bool TileCodingParams::hasPoc(void)
 {
 	return numpocs > 0;
 }
+void TileCodingParams::releaseCompressedData(void)
+{
+	delete compressedTileData_;
+	compressedTileData_ = nullptr;
+}
 TileComponentCodingParams::TileComponentCodingParams()
 	: csty(0), numresolutions(0), cblkw(0), cblkh(0), cblk_sty(0), qmfbid(0),
 	  quantizationMarkerSet(false), fromQCC(false), fromTileHeader(false), qntsty(0),
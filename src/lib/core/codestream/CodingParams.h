@@ -129,6 +129,8 @@ struct TileCodingParams
 	bool isHT(void);
 	uint32_t getNumProgressions(void);
 	bool hasPoc(void);
+	/** discard compressed tile data once it is no longer needed */
+	void releaseCompressedData(void);
 
 	/** coding style */
 	uint8_t csty;
@@ -222,6 +224,10 @@ struct EncodingParams
 	bool writePLT;
 	/* write TLM marker */
 	bool writeTLM;
+	/* first tile to compress */
+	uint16_t tileRangeBegin_;
+	/* one past last tile to compress */
+	uint16_t tileRangeEnd_;
 	/* rate control algorithm */
 	uint32_t rateControlAlgorithm;
 };
@@ -236,6 +242,15 @@ struct DecodingParams
 	uint16_t layers_to_decompress_;
 
 	uint32_t randomAccessFlags_;
+	/** if true, irreversible components are output as floating point samples */
+	bool floatOutput_;
+	/** requested output size of full image, or 0 if not set */
+	uint32_t targetWidth_;
+	uint32_t targetHeight_;
+	/** ratio of output size to size of decompressed resolution, or 0 if there is
+	 * no resampling */
+	double resampleX_;
+	double resampleY_;
 };
 
 /**
@@ -61,6 +61,9 @@ const uint8_t IPTC_UUID[16] = {0x33, 0xC7, 0xA4, 0xD2, 0xB8, 0x1D, 0x47, 0x23,
 							   0xA0, 0xBA, 0xF1, 0xA3, 0xE0, 0x97, 0xAD, 0x38};
 const uint8_t XMP_UUID[16] = {0xBE, 0x7A, 0xCF, 0xCB, 0x97, 0xA9, 0x42, 0xE8,
 							  0x9C, 0x71, 0x99, 0x94, 0x91, 0xE3, 0xAF, 0xAC};
+// "JpgTiffExif->JP2"
+const uint8_t EXIF_UUID[16] = {0x4A, 0x70, 0x67, 0x54, 0x69, 0x66, 0x66, 0x45,
+							   0x78, 0x69, 0x66, 0x2D, 0x3E, 0x4A, 0x50, 0x32};
 
 #define GRK_BOX_SIZE 1024
 #define GRK_RESOLUTION_BOX_SIZE (4 + 4 + 10)
@@ -829,6 +829,10 @@ bool FileFormatCompress::init(grk_cparameters* parameters, GrkImage* image)
 		if(inputImage_->meta->xmp_len && inputImage_->meta->xmp_buf)
 			uuids[numUuids++] =
 				UUIDBox(XMP_UUID, inputImage_->meta->xmp_buf, inputImage_->meta->xmp_len);
+
+		if(inputImage_->meta->exif_len && inputImage_->meta->exif_buf)
+			uuids[numUuids++] =
+				UUIDBox(EXIF_UUID, inputImage_->meta->exif_buf, inputImage_->meta->exif_len);
 	}
 	/* Channel Definition box */
 	for(i = 0; i < inputImage_->numcomps; i++)
@@ -925,6 +929,14 @@ uint64_t FileFormatCompress::compress(grk_plugin_tile* tile)
 
 	return rc;
 }
+Stats* FileFormatCompress::getStats(void)
+{
+	return codeStream->getStats();
+}
+MemAccount* FileFormatCompress::getMemAccount(void)
+{
+	return codeStream->getMemAccount();
+}
 bool FileFormatCompress::end(void)
 {
 	/* write header */
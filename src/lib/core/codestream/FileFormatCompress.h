@@ -31,6 +31,8 @@ class FileFormatCompress : public FileFormat, public ICodeStreamCompress
 	bool init(grk_cparameters* p_param, GrkImage* p_image);
 	bool start(void);
 	uint64_t compress(grk_plugin_tile* tile);
+	Stats* getStats(void);
+	MemAccount* getMemAccount(void);
 
   private:
 	bool end(void);
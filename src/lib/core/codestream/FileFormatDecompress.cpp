@@ -24,7 +24,8 @@
 namespace grk
 {
 FileFormatDecompress::FileFormatDecompress(BufferedStream* stream)
-	: FileFormat(), headerError_(false), codeStream(new CodeStreamDecompress(stream)), jp2_state(0)
+	: FileFormat(), headerError_(false), codeStream(new CodeStreamDecompress(stream)), jp2_state(0),
+	  lazyMetadata_(false)
 {
 	header = {{JP2_JP, [this](uint8_t* data, uint32_t len) { return read_jp(data, len); }},
 			  {JP2_FTYP, [this](uint8_t* data, uint32_t len) { return read_ftyp(data, len); }},
@@ -131,17 +132,13 @@ bool FileFormatDecompress::readHeader(grk_header_info* header_info)
 			headerError_ = true;
 			return false;
 		}
+		// palette indices must stay integral
+		if(getColour()->palette)
+			codeStream->getCodingParams()->coding_params_.dec_.floatOutput_ = false;
 	}
 	// set file format fields in header info
 	if(header_info)
-	{
-		// retrieve ASOCs
-		header_info->num_asocs = 0;
-		if(!root_asoc.children.empty())
-			serializeAsoc(&root_asoc, header_info->asocs, &header_info->num_asocs, 0);
-		header_info->xml_data = xml.buf;
-		header_info->xml_data_len = xml.len;
-	}
+		getMetadata(header_info);
 	if(!codeStream->readHeader(header_info))
 	{
 		headerError_ = true;
@@ -226,50 +223,142 @@ bool FileFormatDecompress::readHeader(grk_header_info* header_info)
 			image->capture_resolution[i] = capture_resolution[i];
 			image->display_resolution[i] = display_resolution[i];
 		}
-		// retrieve special uuids
-		for(uint32_t i = 0; i < numUuids; ++i)
+		setImageMetadata(image);
+	}
+
+	return true;
+}
+void FileFormatDecompress::getMetadata(grk_header_info* header_info)
+{
+	// retrieve ASOCs
+	header_info->num_asocs = 0;
+	if(!root_asoc.children.empty())
+		serializeAsoc(&root_asoc, header_info->asocs, &header_info->num_asocs, 0);
+	header_info->xml_data = xml.buf;
+	header_info->xml_data_len = xml.len;
+}
+void FileFormatDecompress::setImageMetadata(GrkImage* image)
+{
+	// retrieve special uuids
+	for(uint32_t i = 0; i < numUuids; ++i)
+	{
+		auto uuid = uuids + i;
+		if(memcmp(uuid->uuid, IPTC_UUID, 16) == 0)
 		{
-			auto uuid = uuids + i;
-			if(memcmp(uuid->uuid, IPTC_UUID, 16) == 0)
+			if(image->meta->iptc_buf)
 			{
-				if(image->meta->iptc_buf)
-				{
-					GRK_WARN("Attempt to set a second IPTC buffer. Ignoring");
-				}
-				else if(uuid->len)
-				{
-					image->meta->iptc_len = uuid->len;
-					image->meta->iptc_buf = new uint8_t[uuid->len];
-					memcpy(image->meta->iptc_buf, uuid->buf, uuid->len);
-				}
+				GRK_WARN("Attempt to set a second IPTC buffer. Ignoring");
 			}
-			else if(memcmp(uuid->uuid, XMP_UUID, 16) == 0)
+			else if(uuid->len)
 			{
-				if(image->meta->xmp_buf)
-				{
-					GRK_WARN("Attempt to set a second XMP buffer. Ignoring");
-				}
-				else if(uuid->len)
+				image->meta->iptc_len = uuid->len;
+				image->meta->iptc_buf = new uint8_t[uuid->len];
+				memcpy(image->meta->iptc_buf, uuid->buf, uuid->len);
+			}
+		}
+		else if(memcmp(uuid->uuid, XMP_UUID, 16) == 0)
+		{
+			if(image->meta->xmp_buf)
+			{
+				GRK_WARN("Attempt to set a second XMP buffer. Ignoring");
+			}
+			else if(uuid->len)
+			{
+				image->meta->xmp_len = uuid->len;
+				image->meta->xmp_buf = new uint8_t[uuid->len];
+				memcpy(image->meta->xmp_buf, uuid->buf, uuid->len);
+			}
+		}
+		else if(memcmp(uuid->uuid, EXIF_UUID, 16) == 0)
+		{
+			if(image->meta->exif_buf)
+			{
+				GRK_WARN("Attempt to set a second Exif buffer. Ignoring");
+			}
+			else if(uuid->len)
+			{
+				// some writers keep the JPEG APP1 identifier in front of the TIFF header
+				const uint8_t exifId[6] = {'E', 'x', 'i', 'f', 0, 0};
+				auto buf = uuid->buf;
+				auto len = uuid->len;
+				if(len > sizeof(exifId) && memcmp(buf, exifId, sizeof(exifId)) == 0)
 				{
-					image->meta->xmp_len = uuid->len;
-					image->meta->xmp_buf = new uint8_t[uuid->len];
-					memcpy(image->meta->xmp_buf, uuid->buf, uuid->len);
+					buf += sizeof(exifId);
+					len -= sizeof(exifId);
 				}
+				image->meta->exif_len = len;
+				image->meta->exif_buf = new uint8_t[len];
+				memcpy(image->meta->exif_buf, buf, len);
+			}
+		}
+	}
+}
+bool FileFormatDecompress::readMetadata(grk_header_info* header_info)
+{
+	if(headerError_ || codeStream->needsHeaderRead())
+	{
+		GRK_ERROR("Header must be read before reading metadata");
+		return false;
+	}
+	if(!deferredBoxes_.empty())
+	{
+		auto stream = codeStream->getStream();
+		auto position = stream->tell();
+		auto numUuidsBefore = numUuids;
+		bool rc = true;
+		std::vector<uint8_t> data;
+		for(auto& box : deferredBoxes_)
+		{
+			data.resize(box.length_);
+			if(!box.length_ || !stream->seek(box.position_) ||
+			   stream->read(data.data(), box.length_) != box.length_)
+			{
+				GRK_ERROR("Problem with reading JPEG2000 box, stream error");
+				rc = false;
+				break;
+			}
+			if(!find_handler(box.type_)(data.data(), box.length_))
+			{
+				rc = false;
+				break;
 			}
 		}
+		deferredBoxes_.clear();
+		if(!stream->seek(position) || !rc)
+			return false;
+		if(numUuids != numUuidsBefore)
+			setImageMetadata(codeStream->getCompositeImage());
 	}
+	if(header_info)
+		getMetadata(header_info);
 
 	return true;
 }
+bool FileFormatDecompress::readSharedHeader(grk_header_info* header_info, const uint8_t* buf,
+										   uint64_t len)
+{
+	// shared header holds file format boxes preceding the code stream box
+	return codeStream->readSharedHeader(buf, len,
+										[this, header_info]() { return readHeader(header_info); });
+}
+uint64_t FileFormatDecompress::getSharedHeader(uint8_t* buf, uint64_t len)
+{
+	return codeStream->getSharedHeader(buf, len);
+}
 bool FileFormatDecompress::setDecompressRegion(grk_rect_single region)
 {
 	return codeStream->setDecompressRegion(region);
 }
+bool FileFormatDecompress::setDecompressTiles(const uint16_t* tileIndices, uint16_t numTiles)
+{
+	return codeStream->setDecompressTiles(tileIndices, numTiles);
+}
 /** Set up decompressor function handler */
 void FileFormatDecompress::init(grk_decompress_core_params* parameters)
 {
 	/* set up the J2K codec */
 	codeStream->init(parameters);
+	lazyMetadata_ = parameters->lazy_metadata;
 }
 bool FileFormatDecompress::decompress(grk_plugin_tile* tile)
 {
@@ -398,6 +487,33 @@ void FileFormatDecompress::dump(uint32_t flag, FILE* outputFileStream)
 {
 	codeStream->dump(flag, outputFileStream);
 }
+Stats* FileFormatDecompress::getStats(void)
+{
+	return codeStream->getStats();
+}
+MemAccount* FileFormatDecompress::getMemAccount(void)
+{
+	return codeStream->getMemAccount();
+}
+void FileFormatDecompress::cancel(void)
+{
+	codeStream->cancel();
+}
+bool FileFormatDecompress::nextFrame(BufferedStream* stream)
+{
+	// file format boxes are only read for the first frame: following frames are code streams
+	return codeStream->nextFrame(stream);
+}
+uint64_t FileFormatDecompress::transcode(BufferedStream* dest, grk_transcode_params* params)
+{
+	// file format boxes are read with the header, but are not transcoded
+	return codeStream->transcode(dest, params, [this]() { return readHeader(nullptr); });
+}
+bool FileFormatDecompress::stitch(Stitcher* stitcher)
+{
+	// file format boxes are read with the header, but are not stitched
+	return stitcher->add(codeStream, [this]() { return readHeader(nullptr); });
+}
 bool FileFormatDecompress::readHeaderProcedureImpl(void)
 {
 	FileFormatBox box;
@@ -475,6 +591,18 @@ bool FileFormatDecompress::readHeaderProcedureImpl(void)
 							  stream->numBytesLeft());
 					goto cleanup;
 				}
+				// only locate metadata boxes: payload is read on demand
+				if(lazyMetadata_ &&
+				   (box.type == JP2_XML || box.type == JP2_UUID || box.type == JP2_ASOC))
+				{
+					deferredBoxes_.push_back({box.type, stream->tell(), current_data_size});
+					if(!stream->skip(current_data_size))
+					{
+						GRK_ERROR("Problem with skipping JPEG2000 box, stream error");
+						goto cleanup;
+					}
+					continue;
+				}
 				if(current_data_size > last_data_size)
 				{
 					uint8_t* new_current_data =
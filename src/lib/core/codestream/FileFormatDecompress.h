@@ -25,22 +25,43 @@ namespace grk
 {
 typedef std::function<bool(uint8_t* headerData, uint32_t header_size)> BOX_FUNC;
 
+/**
+ * Metadata box whose payload has not been read yet
+ */
+struct DeferredBox
+{
+	uint32_t type_;
+	// stream position of payload
+	uint64_t position_;
+	uint32_t length_;
+};
+
 class FileFormatDecompress : public FileFormat, public ICodeStreamDecompress
 {
   public:
 	FileFormatDecompress(BufferedStream* stream);
 	virtual ~FileFormatDecompress();
 	bool readHeader(grk_header_info* header_info);
+	bool readSharedHeader(grk_header_info* header_info, const uint8_t* buf, uint64_t len);
+	uint64_t getSharedHeader(uint8_t* buf, uint64_t len);
+	bool readMetadata(grk_header_info* header_info);
 	GrkImage* getImage(uint16_t tileIndex);
 	GrkImage* getImage(void);
 	void init(grk_decompress_core_params* p_param);
 	bool setDecompressRegion(grk_rect_single region);
+	bool setDecompressTiles(const uint16_t* tileIndices, uint16_t numTiles);
 	bool decompress(grk_plugin_tile* tile);
 	bool decompressTile(uint16_t tileIndex);
 	bool end(void);
 	bool postProcess(void);
 	bool preProcess(void);
 	void dump(uint32_t flag, FILE* outputFileStream);
+	Stats* getStats(void);
+	MemAccount* getMemAccount(void);
+	void cancel(void);
+	bool nextFrame(BufferedStream* stream);
+	uint64_t transcode(BufferedStream* dest, grk_transcode_params* params);
+	bool stitch(Stitcher* stitcher);
 
   private:
 	grk_color* getColour(void);
@@ -70,6 +91,8 @@ class FileFormatDecompress : public FileFormat, public ICodeStreamDecompress
 				  uint64_t p_box_max_size);
 	bool read_asoc(uint8_t* header_data, uint32_t header_data_size);
 	void serializeAsoc(AsocBox* asoc, grk_asoc* serial_asocs, uint32_t* num_asocs, uint32_t level);
+	void getMetadata(grk_header_info* header_info);
+	void setImageMetadata(GrkImage* image);
 	std::map<uint32_t, BOX_FUNC> header;
 	std::map<uint32_t, BOX_FUNC> img_header;
 
@@ -77,6 +100,9 @@ class FileFormatDecompress : public FileFormat, public ICodeStreamDecompress
 	AsocBox root_asoc;
 	CodeStreamDecompress* codeStream;
 	uint32_t jp2_state;
+	// XML, UUID and ASOC boxes are only located while reading header
+	bool lazyMetadata_;
+	std::vector<DeferredBox> deferredBoxes_;
 };
 
 } // namespace grk
@@ -0,0 +1,126 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+const uint32_t noFragment = UINT_MAX;
+
+Stitcher::Stitcher(BufferedStream* dest)
+	: dest_(dest), numTileParts_(0), tileLengthMarkers_(nullptr)
+{}
+Stitcher::~Stitcher()
+{
+	for(auto& fragment : fragments_)
+		delete fragment;
+	delete tileLengthMarkers_;
+}
+bool Stitcher::add(CodeStreamDecompress* codeStream, std::function<bool(void)> readHeader)
+{
+	auto fragment = new TilePartCopier(codeStream, dest_);
+	uint32_t fragmentIndex = (uint32_t)fragments_.size();
+	fragments_.push_back(fragment);
+	if(!fragment->readMainHeader(readHeader))
+		return false;
+	if(fragmentIndex == 0)
+	{
+		auto cp = codeStream->getCodingParams();
+		tileFragments_.resize((size_t)cp->t_grid_width * cp->t_grid_height, noFragment);
+	}
+	else if(fragment->getMainHeader() != fragments_.front()->getMainHeader())
+	{
+		GRK_ERROR("Stitch: main header of fragment %u differs from main header of fragment 0",
+				  fragmentIndex);
+		return false;
+	}
+	if(!fragment->locate([]([[maybe_unused]] uint16_t tileIndex) { return true; }))
+		return false;
+	for(auto& tilePart : fragment->getTileParts())
+	{
+		auto& tileFragment = tileFragments_[tilePart.tileIndex_];
+		if(tileFragment != noFragment && tileFragment != fragmentIndex)
+		{
+			GRK_ERROR("Stitch: tile %u is held by both fragment %u and fragment %u",
+					  tilePart.tileIndex_, tileFragment, fragmentIndex);
+			return false;
+		}
+		tileFragment = fragmentIndex;
+	}
+	numTileParts_ += (uint32_t)fragment->getTileParts().size();
+
+	return true;
+}
+uint64_t Stitcher::stitch(void)
+{
+	if(fragments_.empty())
+	{
+		GRK_ERROR("Stitch: no fragments");
+		return 0;
+	}
+	for(uint32_t i = 0; i < tileFragments_.size(); ++i)
+	{
+		if(tileFragments_[i] == noFragment)
+		{
+			GRK_ERROR("Stitch: tile %u is missing from all fragments", i);
+			return 0;
+		}
+	}
+	uint64_t start = dest_->tell();
+	if(!writeMainHeader())
+		return 0;
+	for(auto& fragment : fragments_)
+	{
+		for(auto& tilePart : fragment->getTileParts())
+		{
+			if(!fragment->copy(tilePart, tilePart.tileIndex_))
+				return 0;
+			if(tileLengthMarkers_)
+				tileLengthMarkers_->push(tilePart.tileIndex_, tilePart.length_);
+		}
+	}
+	if(!writeEnd())
+		return 0;
+
+	return dest_->tell() - start;
+}
+bool Stitcher::writeMainHeader(void)
+{
+	if(!fragments_.front()->writeMainHeader())
+		return false;
+	if(numTileParts_ > maxTLMTileParts)
+	{
+		GRK_WARN("Stitch: %u tile parts do not fit into a single TLM marker; "
+				 "TLM will not be written",
+				 numTileParts_);
+		return true;
+	}
+	tileLengthMarkers_ = new TileLengthMarkers(dest_);
+
+	return tileLengthMarkers_->writeBegin((uint16_t)numTileParts_);
+}
+bool Stitcher::writeEnd(void)
+{
+	if(tileLengthMarkers_ && !tileLengthMarkers_->writeEnd())
+		return false;
+	if(!dest_->writeShort(J2K_MS_EOC))
+		return false;
+
+	return dest_->flush();
+}
+
+} // namespace grk
@@ -0,0 +1,63 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace grk
+{
+/**
+ * Stitches code stream fragments, each holding the tiles of a different tile range
+ * of the same image, into a single code stream, without decoding packets.
+ *
+ * Fragments must share the same main header, apart from their TLM and PLM markers.
+ * Tile parts are copied unchanged, fragment by fragment, and a single TLM marker
+ * is written for all of them.
+ */
+class Stitcher
+{
+  public:
+	explicit Stitcher(BufferedStream* dest);
+	~Stitcher();
+	/**
+	 * Add fragment
+	 *
+	 * @param codeStream fragment code stream
+	 * @param readHeader reads main header of fragment, along with any enclosing
+	 * file format boxes
+	 * @return true if successful
+	 */
+	bool add(CodeStreamDecompress* codeStream, std::function<bool(void)> readHeader);
+	/**
+	 * Write stitched code stream
+	 *
+	 * @return number of bytes written, or 0 on failure
+	 */
+	uint64_t stitch(void);
+
+  private:
+	bool writeMainHeader(void);
+	bool writeEnd(void);
+
+	BufferedStream* dest_;
+	std::vector<TilePartCopier*> fragments_;
+	// index of fragment holding each tile, or noFragment
+	std::vector<uint32_t> tileFragments_;
+	uint32_t numTileParts_;
+	TileLengthMarkers* tileLengthMarkers_;
+};
+
+} // namespace grk
@@ -0,0 +1,164 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+TileCropper::TileCropper(CodeStreamDecompress* codeStream, BufferedStream* dest,
+						 grk_transcode_params* params)
+	: codeStream_(codeStream), dest_(dest), copier_(codeStream, dest),
+	  region_(params->crop_x0, params->crop_y0, params->crop_x1, params->crop_y1),
+	  tileLengthMarkers_(nullptr)
+{}
+TileCropper::~TileCropper()
+{
+	delete tileLengthMarkers_;
+}
+uint64_t TileCropper::crop(std::function<bool(void)> readHeader)
+{
+	if(region_.empty())
+	{
+		GRK_ERROR("Crop: empty region (%u,%u,%u,%u)", region_.x0, region_.y0, region_.x1,
+				  region_.y1);
+		return 0;
+	}
+	uint64_t start = dest_->tell();
+	bool rc = copier_.readMainHeader(readHeader) && selectTiles() &&
+			  copier_.locate([this](uint16_t tileIndex) { return isSelected(tileIndex); }) &&
+			  writeMainHeader();
+	if(rc)
+	{
+		for(auto& tilePart : copier_.getTileParts())
+		{
+			uint16_t tileIndex = mapTileIndex(tilePart.tileIndex_);
+			if(!copier_.copy(tilePart, tileIndex))
+			{
+				rc = false;
+				break;
+			}
+			if(tileLengthMarkers_)
+				tileLengthMarkers_->push(tileIndex, tilePart.length_);
+		}
+	}
+	rc = rc && writeEnd();
+
+	return rc ? dest_->tell() - start : 0;
+}
+bool TileCropper::selectTiles(void)
+{
+	auto cp = codeStream_->getCodingParams();
+	auto image = codeStream_->getHeaderImage();
+	auto region = region_.intersection(grk_rect32(image->x0, image->y0, image->x1, image->y1));
+	if(region.empty())
+	{
+		GRK_ERROR("Crop: region (%u,%u,%u,%u) does not intersect image (%u,%u,%u,%u)",
+				  region_.x0, region_.y0, region_.x1, region_.y1, image->x0, image->y0,
+				  image->x1, image->y1);
+		return false;
+	}
+	tiles_ = grk_rect32((region.x0 - cp->tx0) / cp->t_width, (region.y0 - cp->ty0) / cp->t_height,
+						ceildiv<uint32_t>(region.x1 - cp->tx0, cp->t_width),
+						ceildiv<uint32_t>(region.y1 - cp->ty0, cp->t_height));
+
+	return true;
+}
+bool TileCropper::rewriteSIZ(std::vector<uint8_t>& segment)
+{
+	if(segment.size() < sizCsizOffset + 2)
+	{
+		GRK_ERROR("Crop: malformed SIZ marker segment");
+		return false;
+	}
+	auto cp = codeStream_->getCodingParams();
+	auto image = codeStream_->getHeaderImage();
+	auto data = segment.data();
+	uint16_t rsiz;
+	grk_read<uint16_t>(data, &rsiz);
+	// profiles constrain image dimensions, so only Part 2 and HT capabilities are kept
+	if(!GRK_IS_PART2(rsiz))
+		rsiz &= GRK_JPH_RSIZ_FLAG;
+	// tile grid origin moves to the first kept tile, so tiles keep their
+	// reference grid coordinates
+	uint64_t tx0 = (uint64_t)cp->tx0 + (uint64_t)tiles_.x0 * cp->t_width;
+	uint64_t ty0 = (uint64_t)cp->ty0 + (uint64_t)tiles_.y0 * cp->t_height;
+	uint64_t tx1 = (uint64_t)cp->tx0 + (uint64_t)tiles_.x1 * cp->t_width;
+	uint64_t ty1 = (uint64_t)cp->ty0 + (uint64_t)tiles_.y1 * cp->t_height;
+	uint32_t grid[8] = {(uint32_t)std::min<uint64_t>(image->x1, tx1),
+						(uint32_t)std::min<uint64_t>(image->y1, ty1),
+						(uint32_t)std::max<uint64_t>(image->x0, tx0),
+						(uint32_t)std::max<uint64_t>(image->y0, ty0),
+						cp->t_width,
+						cp->t_height,
+						(uint32_t)tx0,
+						(uint32_t)ty0};
+	grk_write<uint16_t>(data, rsiz);
+	for(uint32_t i = 0; i < 8; ++i)
+		grk_write<uint32_t>(data + 2 + 4 * i, grid[i]);
+
+	return true;
+}
+bool TileCropper::isSelected(uint16_t tileIndex)
+{
+	auto cp = codeStream_->getCodingParams();
+	uint32_t x = tileIndex % cp->t_grid_width;
+	uint32_t y = tileIndex / cp->t_grid_width;
+
+	return x >= tiles_.x0 && x < tiles_.x1 && y >= tiles_.y0 && y < tiles_.y1;
+}
+uint16_t TileCropper::mapTileIndex(uint16_t tileIndex)
+{
+	auto cp = codeStream_->getCodingParams();
+	uint32_t x = tileIndex % cp->t_grid_width;
+	uint32_t y = tileIndex / cp->t_grid_width;
+
+	return (uint16_t)((y - tiles_.y0) * tiles_.width() + x - tiles_.x0);
+}
+bool TileCropper::writeMainHeader(void)
+{
+	for(auto& marker : copier_.getMainHeader())
+	{
+		if(marker.first == J2K_MS_SIZ && !rewriteSIZ(marker.second))
+			return false;
+	}
+	if(!copier_.writeMainHeader())
+		return false;
+	if(!copier_.hasTLM())
+		return true;
+	auto numTileParts = copier_.getTileParts().size();
+	if(numTileParts > maxTLMTileParts)
+	{
+		GRK_WARN("Crop: %u tile parts do not fit into a single TLM marker; "
+				 "TLM will not be written",
+				 (uint32_t)numTileParts);
+		return true;
+	}
+	tileLengthMarkers_ = new TileLengthMarkers(dest_);
+
+	return tileLengthMarkers_->writeBegin((uint16_t)numTileParts);
+}
+bool TileCropper::writeEnd(void)
+{
+	if(tileLengthMarkers_ && !tileLengthMarkers_->writeEnd())
+		return false;
+	if(!dest_->writeShort(J2K_MS_EOC))
+		return false;
+
+	return dest_->flush();
+}
+
+} // namespace grk
@@ -0,0 +1,62 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace grk
+{
+/**
+ * Crops a code stream to the tiles intersecting a region of the reference grid,
+ * without decoding packets.
+ *
+ * Tile parts are copied unchanged apart from their tile index.
+ * SIZ is rewritten so that the reference grid coordinates of the kept tiles,
+ * and therefore their precinct partitions, do not change.
+ */
+class TileCropper
+{
+  public:
+	TileCropper(CodeStreamDecompress* codeStream, BufferedStream* dest,
+				grk_transcode_params* params);
+	~TileCropper();
+	/**
+	 * Crop code stream
+	 *
+	 * @param readHeader reads main header of source code stream
+	 * @return number of bytes written, or 0 on failure
+	 */
+	uint64_t crop(std::function<bool(void)> readHeader);
+
+  private:
+	bool selectTiles(void);
+	bool rewriteSIZ(std::vector<uint8_t>& segment);
+	bool isSelected(uint16_t tileIndex);
+	uint16_t mapTileIndex(uint16_t tileIndex);
+	bool writeMainHeader(void);
+	bool writeEnd(void);
+
+	CodeStreamDecompress* codeStream_;
+	BufferedStream* dest_;
+	TilePartCopier copier_;
+	// cropping region on reference grid
+	grk_rect32 region_;
+	// kept tiles, in tile grid coordinates
+	grk_rect32 tiles_;
+	TileLengthMarkers* tileLengthMarkers_;
+};
+
+} // namespace grk
@@ -0,0 +1,246 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+// SOT marker, Lsot, Isot and Psot
+const uint32_t sotPsotEnd = 10;
+// tile parts are copied in chunks of this size
+const size_t copyBufferSize = 1024 * 1024;
+
+TilePartCopier::TilePartCopier(CodeStreamDecompress* codeStream, BufferedStream* dest)
+	: codeStream_(codeStream), src_(codeStream->getStream()), dest_(dest), firstTilePart_(0),
+	  hasTLM_(false), buffer_(nullptr)
+{}
+TilePartCopier::~TilePartCopier()
+{
+	delete[] buffer_;
+}
+CodeStreamDecompress* TilePartCopier::getCodeStream(void)
+{
+	return codeStream_;
+}
+std::vector<std::pair<uint16_t, std::vector<uint8_t>>>& TilePartCopier::getMainHeader(void)
+{
+	return mainHeader_;
+}
+std::vector<TilePartSpan>& TilePartCopier::getTileParts(void)
+{
+	return tileParts_;
+}
+bool TilePartCopier::hasTLM(void)
+{
+	return hasTLM_;
+}
+bool TilePartCopier::readMainHeader(std::function<bool(void)> readHeader)
+{
+	if(!codeStream_->needsHeaderRead())
+	{
+		GRK_ERROR("Main header has already been read");
+		return false;
+	}
+	codeStream_->setMarkerListener(
+		[this](int32_t tileIndex, uint16_t id, const uint8_t* headerData, uint16_t header_size) {
+			return onMarker(tileIndex, id, headerData, header_size);
+		});
+	bool rc = readHeader();
+	codeStream_->setMarkerListener(nullptr);
+	if(!rc)
+		return false;
+	// main header has been read up to and including the first SOT marker
+	firstTilePart_ = src_->tell() - MARKER_BYTES;
+
+	return true;
+}
+bool TilePartCopier::onMarker(int32_t tileIndex, uint16_t id, const uint8_t* headerData,
+							  uint16_t header_size)
+{
+	// only main header is read
+	if(tileIndex >= 0)
+		return true;
+	switch(id)
+	{
+		case J2K_MS_PPM:
+			GRK_ERROR("Packed packet headers in main header are not supported");
+			return false;
+		case J2K_MS_TLM:
+			hasTLM_ = true;
+			return true;
+		case J2K_MS_PLM:
+			GRK_WARN("PLM marker will not be written");
+			return true;
+		case J2K_MS_SOT:
+			return true;
+		default:
+			break;
+	}
+	mainHeader_.emplace_back(id, std::vector<uint8_t>(headerData, headerData + header_size));
+
+	return true;
+}
+bool TilePartCopier::locate(std::function<bool(uint16_t)> select)
+{
+	auto tlm = codeStream_->getCodingParams()->tlm_markers;
+	if(tlm && tlm->valid())
+	{
+		try
+		{
+			if(locateTLM(select))
+				return true;
+		}
+		catch([[maybe_unused]] CorruptTLMException& cte)
+		{}
+		GRK_WARN("Unable to locate tile parts with TLM marker; scanning SOT markers");
+		tileParts_.clear();
+	}
+
+	return locateSOT(select);
+}
+bool TilePartCopier::locateTLM(std::function<bool(uint16_t)> select)
+{
+	auto tlm = codeStream_->getCodingParams()->tlm_markers;
+	tlm->rewind();
+	uint64_t position = firstTilePart_;
+	for(auto tilePart = tlm->next(); tilePart; tilePart = tlm->next())
+	{
+		if(!tilePart->length_)
+			return false;
+		if(select(tilePart->tileIndex_))
+			tileParts_.emplace_back(tilePart->tileIndex_, position, tilePart->length_);
+		position += tilePart->length_;
+	}
+
+	return true;
+}
+bool TilePartCopier::locateSOT(std::function<bool(uint16_t)> select)
+{
+	auto cp = codeStream_->getCodingParams();
+	uint64_t position = firstTilePart_;
+	// reads stop at end of stream, so that the stream can still seek back to located tile parts
+	uint64_t end = src_->tell() + src_->numBytesLeft();
+	uint8_t sot[sotPsotEnd];
+	while(position < end)
+	{
+		if(!src_->seek(position))
+			return false;
+		// a truncated code stream ends without EOC
+		size_t bytesRead = src_->read(sot, (size_t)std::min<uint64_t>(sotPsotEnd, end - position));
+		if(bytesRead >= MARKER_BYTES)
+		{
+			uint16_t marker;
+			grk_read<uint16_t>(sot, &marker);
+			if(marker == J2K_MS_EOC)
+				break;
+			if(marker != J2K_MS_SOT)
+			{
+				GRK_ERROR("Expected SOT marker at offset %" PRIu64, position);
+				return false;
+			}
+		}
+		if(bytesRead != sotPsotEnd)
+		{
+			if(bytesRead)
+				GRK_WARN("Code stream truncated at offset %" PRIu64, position);
+			break;
+		}
+		uint16_t tileIndex;
+		grk_read<uint16_t>(sot + 4, &tileIndex);
+		uint32_t length;
+		grk_read<uint32_t>(sot + 6, &length);
+		// last tile part extends to EOC
+		if(!length)
+		{
+			if(end < position + sotPsotEnd + MARKER_BYTES)
+				return false;
+			length = (uint32_t)(end - MARKER_BYTES - position);
+		}
+		if(tileIndex >= (uint32_t)cp->t_grid_width * cp->t_grid_height)
+		{
+			GRK_ERROR("Invalid tile index %u at offset %" PRIu64, tileIndex, position);
+			return false;
+		}
+		if(select(tileIndex))
+			tileParts_.emplace_back(tileIndex, position, length);
+		position += length;
+	}
+
+	return true;
+}
+bool TilePartCopier::writeMainHeader(void)
+{
+	if(!dest_->writeShort(J2K_MS_SOC))
+		return false;
+	for(auto& marker : mainHeader_)
+	{
+		auto& segment = marker.second;
+		uint16_t len = (uint16_t)(segment.size() + MARKER_LENGTH_BYTES);
+		if(!dest_->writeShort(marker.first) || !dest_->writeShort(len))
+			return false;
+		if(dest_->writeBytes(segment.data(), segment.size()) != segment.size())
+			return false;
+	}
+
+	return true;
+}
+bool TilePartCopier::copy(const TilePartSpan& tilePart, uint16_t tileIndex)
+{
+	if(!buffer_)
+		buffer_ = new uint8_t[copyBufferSize];
+	if(!src_->seek(tilePart.position_))
+		return false;
+	uint64_t remaining = tilePart.length_;
+	bool first = true;
+	while(remaining)
+	{
+		size_t len = (size_t)std::min<uint64_t>(remaining, copyBufferSize);
+		if(src_->read(buffer_, len) != len)
+		{
+			GRK_ERROR("Tile %u: truncated tile part at offset %" PRIu64, tilePart.tileIndex_,
+					  tilePart.position_);
+			return false;
+		}
+		if(first)
+		{
+			// validate SOT against tile part location, then rewrite Isot and Psot
+			uint16_t marker, sourceTileIndex;
+			uint32_t length;
+			grk_read<uint16_t>(buffer_, &marker);
+			grk_read<uint16_t>(buffer_ + 4, &sourceTileIndex);
+			grk_read<uint32_t>(buffer_ + 6, &length);
+			if(len < sotPsotEnd || marker != J2K_MS_SOT || sourceTileIndex != tilePart.tileIndex_ ||
+			   (length && length != tilePart.length_))
+			{
+				GRK_ERROR("Tile %u: tile part at offset %" PRIu64 " does not match its "
+						  "signalled location",
+						  tilePart.tileIndex_, tilePart.position_);
+				return false;
+			}
+			grk_write<uint16_t>(buffer_ + 4, tileIndex);
+			grk_write<uint32_t>(buffer_ + 6, tilePart.length_);
+			first = false;
+		}
+		if(dest_->writeBytes(buffer_, len) != len)
+			return false;
+		remaining -= len;
+	}
+
+	return true;
+}
+
+} // namespace grk
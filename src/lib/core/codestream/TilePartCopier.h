@@ -0,0 +1,98 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace grk
+{
+/**
+ * Location of a tile part in the source code stream
+ */
+struct TilePartSpan
+{
+	TilePartSpan(uint16_t tileIndex, uint64_t position, uint32_t length)
+		: tileIndex_(tileIndex), position_(position), length_(length)
+	{}
+	uint16_t tileIndex_;
+	// position of SOT marker
+	uint64_t position_;
+	// length of tile part, including SOT marker
+	uint32_t length_;
+};
+
+/**
+ * Copies tile parts of a source code stream to a destination stream,
+ * without decoding packets.
+ *
+ * Tile parts are located with the TLM marker if present, and by skipping from SOT
+ * to SOT otherwise, and are copied unchanged apart from their tile index.
+ */
+class TilePartCopier
+{
+  public:
+	TilePartCopier(CodeStreamDecompress* codeStream, BufferedStream* dest);
+	~TilePartCopier();
+	/**
+	 * Read main header of source code stream, keeping its marker segments
+	 * apart from TLM and PLM
+	 *
+	 * @param readHeader reads main header of source code stream
+	 * @return true if successful
+	 */
+	bool readMainHeader(std::function<bool(void)> readHeader);
+	/**
+	 * Locate tile parts of selected tiles
+	 *
+	 * @param select returns true if tile with given index is selected
+	 * @return true if successful
+	 */
+	bool locate(std::function<bool(uint16_t)> select);
+	/**
+	 * Write SOC and kept main header marker segments to destination
+	 */
+	bool writeMainHeader(void);
+	/**
+	 * Copy tile part to destination
+	 *
+	 * @param tilePart located tile part
+	 * @param tileIndex tile index written to SOT marker
+	 * @return true if successful
+	 */
+	bool copy(const TilePartSpan& tilePart, uint16_t tileIndex);
+	CodeStreamDecompress* getCodeStream(void);
+	std::vector<std::pair<uint16_t, std::vector<uint8_t>>>& getMainHeader(void);
+	std::vector<TilePartSpan>& getTileParts(void);
+	bool hasTLM(void);
+
+  private:
+	bool onMarker(int32_t tileIndex, uint16_t id, const uint8_t* headerData, uint16_t header_size);
+	bool locateTLM(std::function<bool(uint16_t)> select);
+	bool locateSOT(std::function<bool(uint16_t)> select);
+
+	CodeStreamDecompress* codeStream_;
+	BufferedStream* src_;
+	BufferedStream* dest_;
+	// marker segments of main header, in code stream order
+	std::vector<std::pair<uint16_t, std::vector<uint8_t>>> mainHeader_;
+	std::vector<TilePartSpan> tileParts_;
+	// position of first SOT marker
+	uint64_t firstTilePart_;
+	bool hasTLM_;
+	uint8_t* buffer_;
+};
+
+} // namespace grk
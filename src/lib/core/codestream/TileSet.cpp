@@ -36,6 +36,14 @@ void TileSet::schedule(uint16_t tileIndex)
 	tilesToDecompress_.insert(tileIndex);
 	lastTileToDecompress_ = tileIndex;
 }
+void TileSet::schedule(const uint16_t* tileIndices, uint16_t numTiles)
+{
+	tilesToDecompress_.clear();
+	assert(numTiles);
+	for(uint16_t i = 0; i < numTiles; ++i)
+		tilesToDecompress_.insert(tileIndices[i]);
+	lastTileToDecompress_ = *tilesToDecompress_.rbegin();
+}
 bool TileSet::isScheduled(uint16_t tileIndex)
 {
 	return tilesToDecompress_.contains(tileIndex);
@@ -74,4 +82,8 @@ bool TileSet::allComplete(void)
 {
 	return tilesDecompressed_.size() == tilesToDecompress_.size();
 }
+void TileSet::resetComplete(void)
+{
+	tilesDecompressed_.clear();
+}
 } // namespace grk
@@ -15,11 +15,16 @@ class TileSet
 	void schedule(grk_rect16 tiles);
 	void schedule(grk_pt16 tile);
 	void schedule(uint16_t tileIndex);
+	void schedule(const uint16_t* tileIndices, uint16_t numTiles);
 	bool isScheduled(uint16_t tileIndex);
 	bool isScheduled(grk_pt16 tile);
 	void setComplete(uint16_t tileIndex);
 	bool isComplete(uint16_t tileIndex);
 	bool allComplete(void);
+	/**
+	 * Clear completed tiles, keeping scheduled tiles
+	 */
+	void resetComplete(void);
 	uint16_t getSingle(void);
 
   private:
@@ -0,0 +1,419 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+// Lsot + Isot + Psot + TPsot + TNsot
+const uint16_t sotLength = 10;
+const uint32_t sopLength = 6;
+
+Transcoder::Transcoder(CodeStreamDecompress* codeStream, BufferedStream* dest,
+					   grk_transcode_params* params)
+	: codeStream_(codeStream), dest_(dest), maxLayers_(params ? params->max_layers : 0),
+	  reduce_(params ? params->reduce : 0), hasTLM_(false), hasPL_(false),
+	  tileLengthMarkers_(nullptr), packetLengthMarkers_(new PLMarkerMgr(dest)), numComps_(0),
+	  numTiles_(0), numTilesWritten_(0), alignedTiles_(true)
+{}
+Transcoder::~Transcoder()
+{
+	delete tileLengthMarkers_;
+	delete packetLengthMarkers_;
+}
+uint64_t Transcoder::transcode(std::function<bool(void)> readHeader)
+{
+	if(!codeStream_->needsHeaderRead())
+	{
+		GRK_ERROR("Transcode: main header has already been read");
+		return 0;
+	}
+	if(reduce_ >= GRK_J2K_MAXRLVLS)
+	{
+		GRK_ERROR("Transcode: cannot discard %u resolutions", reduce_);
+		return 0;
+	}
+	uint64_t start = dest_->tell();
+	codeStream_->setMarkerListener(
+		[this](int32_t tileIndex, uint16_t id, const uint8_t* headerData, uint16_t header_size) {
+			return onMarker(tileIndex, id, headerData, header_size);
+		});
+	bool rc = readHeader() && writeMainHeader() &&
+			  codeStream_->scanTiles(
+				  [this](TileProcessor* tileProcessor, std::vector<PacketSpan>& packets) {
+					  return writeTile(tileProcessor, packets);
+				  }) &&
+			  writeEnd();
+	codeStream_->setMarkerListener(nullptr);
+
+	return rc ? dest_->tell() - start : 0;
+}
+bool Transcoder::onMarker(int32_t tileIndex, uint16_t id, const uint8_t* headerData,
+						  uint16_t header_size)
+{
+	switch(id)
+	{
+		case J2K_MS_PPM:
+		case J2K_MS_PPT:
+			GRK_ERROR("Transcode: packed packet headers are not supported");
+			return false;
+		case J2K_MS_TLM:
+			hasTLM_ = true;
+			return true;
+		case J2K_MS_PLM:
+		case J2K_MS_PLT:
+			hasPL_ = true;
+			return true;
+		case J2K_MS_SOT:
+			return true;
+		default:
+			break;
+	}
+	std::vector<uint8_t> segment(headerData, headerData + header_size);
+	if(!rewrite(id, segment))
+		return false;
+	auto& header = tileIndex < 0 ? mainHeader_ : tileHeaders_[(uint16_t)tileIndex];
+	uint16_t len = (uint16_t)(segment.size() + MARKER_LENGTH_BYTES);
+	header.push_back((uint8_t)(id >> 8));
+	header.push_back((uint8_t)id);
+	header.push_back((uint8_t)(len >> 8));
+	header.push_back((uint8_t)len);
+	header.insert(header.end(), segment.begin(), segment.end());
+
+	return true;
+}
+bool Transcoder::rewrite(uint16_t id, std::vector<uint8_t>& segment)
+{
+	switch(id)
+	{
+		case J2K_MS_SIZ:
+			return rewriteSIZ(segment);
+		case J2K_MS_COD:
+			return rewriteCOD(segment);
+		case J2K_MS_COC:
+			return rewriteCOC(segment);
+		case J2K_MS_QCD:
+			return rewriteQuantization(segment, 0);
+		case J2K_MS_QCC:
+			return rewriteQuantization(segment, numComponentBytes());
+		case J2K_MS_POC:
+			return rewritePOC(segment);
+		default:
+			return true;
+	}
+}
+uint32_t Transcoder::numComponentBytes(void)
+{
+	return numComps_ <= 256 ? 1 : 2;
+}
+bool Transcoder::rewriteSIZ(std::vector<uint8_t>& segment)
+{
+	if(segment.size() < sizCsizOffset + 2)
+	{
+		GRK_ERROR("Transcode: malformed SIZ marker segment");
+		return false;
+	}
+	auto data = segment.data();
+	uint16_t rsiz;
+	grk_read<uint16_t>(data, &rsiz);
+	// Xsiz, Ysiz, XOsiz, YOsiz, XTsiz, YTsiz, XTOsiz, YTOsiz
+	uint32_t grid[8];
+	for(uint32_t i = 0; i < 8; ++i)
+		grk_read<uint32_t>(data + 2 + 4 * i, grid + i);
+	grk_read<uint16_t>(data + sizCsizOffset, &numComps_);
+	uint32_t gridWidth = ceildiv<uint32_t>(grid[0] - grid[6], grid[4]);
+	uint32_t gridHeight = ceildiv<uint32_t>(grid[1] - grid[7], grid[5]);
+	numTiles_ = gridWidth * gridHeight;
+	if(!reduce_)
+		return true;
+
+	// profiles constrain number of resolutions, so only Part 2 and HT capabilities are kept
+	if(!GRK_IS_PART2(rsiz))
+		rsiz &= GRK_JPH_RSIZ_FLAG;
+	uint32_t scale = 1U << reduce_;
+	alignedTiles_ = (grid[2] % scale) == 0 && (grid[3] % scale) == 0 && (grid[6] % scale) == 0 &&
+					(grid[7] % scale) == 0;
+	uint32_t reduced[8];
+	for(uint32_t i = 0; i < 8; ++i)
+		reduced[i] = ceildiv<uint32_t>(grid[i], scale);
+	// interior tile boundaries must land on reduced tile boundaries
+	for(uint32_t i = 0; i < 2; ++i)
+	{
+		uint32_t numTiles = i == 0 ? gridWidth : gridHeight;
+		uint32_t tileDim = grid[4 + i];
+		if(numTiles > 1)
+		{
+			if(tileDim % scale)
+			{
+				GRK_ERROR("Transcode: tile %s %u is not divisible by %u",
+						  i == 0 ? "width" : "height", tileDim, scale);
+				return false;
+			}
+			reduced[4 + i] = tileDim / scale;
+		}
+		else
+		{
+			uint64_t tileEnd = (uint64_t)grid[6 + i] + tileDim;
+			reduced[4 + i] = (uint32_t)ceildiv<uint64_t>(tileEnd, scale) - reduced[6 + i];
+		}
+		if(ceildiv<uint32_t>(reduced[i] - reduced[6 + i], reduced[4 + i]) != numTiles)
+		{
+			GRK_ERROR("Transcode: discarding %u resolutions changes the tile grid", reduce_);
+			return false;
+		}
+	}
+	grk_write<uint16_t>(data, rsiz);
+	for(uint32_t i = 0; i < 8; ++i)
+		grk_write<uint32_t>(data + 2 + 4 * i, reduced[i]);
+
+	return true;
+}
+bool Transcoder::validateProgression(uint8_t progression)
+{
+	// position-driven progressions visit precincts in reference grid order,
+	// which is only preserved if tile origins scale exactly
+	if(!reduce_ || alignedTiles_ || progression == GRK_LRCP || progression == GRK_RLCP)
+		return true;
+	GRK_ERROR("Transcode: discarding resolutions from a position-driven progression requires "
+			  "image and tile origins divisible by %u",
+			  1U << reduce_);
+
+	return false;
+}
+bool Transcoder::rewriteCOD(std::vector<uint8_t>& segment)
+{
+	// Scod, progression, layers, MCT, then SPcod
+	if(segment.size() < 5)
+	{
+		GRK_ERROR("Transcode: malformed COD marker segment");
+		return false;
+	}
+	auto data = segment.data();
+	if(!validateProgression(data[1]))
+		return false;
+	uint16_t numLayers;
+	grk_read<uint16_t>(data + 2, &numLayers);
+	if(maxLayers_ && numLayers > maxLayers_)
+		grk_write<uint16_t>(data + 2, maxLayers_);
+
+	return rewriteSPcod(segment, 5, data[0] & J2K_CP_CSTY_PRT);
+}
+bool Transcoder::rewriteCOC(std::vector<uint8_t>& segment)
+{
+	// Ccoc, Scoc, then SPcoc
+	size_t offset = numComponentBytes();
+	if(segment.size() < offset + 1)
+	{
+		GRK_ERROR("Transcode: malformed COC marker segment");
+		return false;
+	}
+
+	return rewriteSPcod(segment, offset + 1, segment[offset] & J2K_CP_CSTY_PRT);
+}
+bool Transcoder::rewriteSPcod(std::vector<uint8_t>& segment, size_t offset, bool hasPrecincts)
+{
+	// decomposition levels, code block width, height and style, transform,
+	// then one precinct size per resolution
+	if(segment.size() < offset + 5)
+	{
+		GRK_ERROR("Transcode: malformed coding style marker segment");
+		return false;
+	}
+	uint8_t numDecomps = segment[offset];
+	if(reduce_ > numDecomps)
+	{
+		GRK_ERROR("Transcode: cannot discard %u resolutions from %u decomposition levels",
+				  reduce_, numDecomps);
+		return false;
+	}
+	numDecomps = (uint8_t)(numDecomps - reduce_);
+	segment[offset] = numDecomps;
+	if(hasPrecincts)
+	{
+		size_t len = offset + 5 + numDecomps + 1U;
+		if(segment.size() < len)
+		{
+			GRK_ERROR("Transcode: malformed coding style marker segment");
+			return false;
+		}
+		segment.resize(len);
+	}
+
+	return true;
+}
+bool Transcoder::rewriteQuantization(std::vector<uint8_t>& segment, size_t offset)
+{
+	if(segment.size() < offset + 1)
+	{
+		GRK_ERROR("Transcode: malformed quantization marker segment");
+		return false;
+	}
+	uint8_t style = segment[offset] & 0x1f;
+	// derived step sizes only signal the LL band, and are unaffected
+	if(!reduce_ || style == J2K_CCP_QNTSTY_SIQNT)
+		return true;
+	// sub-bands are ordered from lowest to highest resolution, three per decomposition level
+	size_t bytesPerBand = style == J2K_CCP_QNTSTY_NOQNT ? 1 : 2;
+	size_t numBands = (segment.size() - offset - 1) / bytesPerBand;
+	size_t numDiscarded = 3U * reduce_;
+	if(numBands <= numDiscarded)
+	{
+		GRK_ERROR("Transcode: quantization marker segment signals %u sub-bands; "
+				  "cannot discard %u resolutions",
+				  (uint32_t)numBands, reduce_);
+		return false;
+	}
+	segment.resize(offset + 1 + (numBands - numDiscarded) * bytesPerBand);
+
+	return true;
+}
+bool Transcoder::rewritePOC(std::vector<uint8_t>& segment)
+{
+	// RSpoc, CSpoc, LYEpoc, REpoc, CEpoc, Ppoc: decompressor clamps
+	// REpoc to the reduced number of resolutions
+	uint32_t compBytes = numComponentBytes();
+	uint32_t entryBytes = 5 + 2 * compBytes;
+	if(segment.size() % entryBytes)
+	{
+		GRK_ERROR("Transcode: malformed POC marker segment");
+		return false;
+	}
+	for(auto entry = segment.data(); entry < segment.data() + segment.size(); entry += entryBytes)
+	{
+		if(!validateProgression(entry[4 + 2 * compBytes]))
+			return false;
+		uint16_t layerEnd;
+		grk_read<uint16_t>(entry + 1 + compBytes, &layerEnd);
+		if(maxLayers_ && layerEnd > maxLayers_)
+			grk_write<uint16_t>(entry + 1 + compBytes, maxLayers_);
+	}
+
+	return true;
+}
+bool Transcoder::writeMainHeader(void)
+{
+	if(!dest_->writeShort(J2K_MS_SOC))
+		return false;
+	if(dest_->writeBytes(mainHeader_.data(), mainHeader_.size()) != mainHeader_.size())
+		return false;
+	if(!hasTLM_)
+		return true;
+	if(numTiles_ > maxTLMTileParts)
+	{
+		GRK_WARN("Transcode: %u tiles do not fit into a single TLM marker; TLM will not be written",
+				 numTiles_);
+		return true;
+	}
+	tileLengthMarkers_ = new TileLengthMarkers(dest_);
+
+	return tileLengthMarkers_->writeBegin((uint16_t)numTiles_);
+}
+bool Transcoder::writeTile(TileProcessor* tileProcessor, std::vector<PacketSpan>& packets)
+{
+	auto tileIndex = tileProcessor->getIndex();
+	auto tile = tileProcessor->getTile();
+	bool hasSOP = tileProcessor->getTileCodingParams()->csty & J2K_CP_CSTY_SOP;
+
+	// 1. select packets: their relative order is preserved
+	uint64_t numPacketBytes = 0;
+	auto last = std::remove_if(packets.begin(), packets.end(), [&](const PacketSpan& packet) {
+		return (maxLayers_ && packet.id.layno >= maxLayers_) ||
+			   packet.id.resno + reduce_ >= tile->comps[packet.id.compno].numresolutions;
+	});
+	packets.erase(last, packets.end());
+	for(auto& packet : packets)
+		numPacketBytes += packet.len;
+
+	// 2. tile part length
+	std::vector<uint8_t> empty;
+	auto headerIter = tileHeaders_.find(tileIndex);
+	auto& header = headerIter != tileHeaders_.end() ? headerIter->second : empty;
+	uint64_t tilePartLength =
+		MARKER_BYTES + sotLength + header.size() + MARKER_BYTES + numPacketBytes;
+	if(hasPL_)
+	{
+		packetLengthMarkers_->pushInit(true);
+		for(auto& packet : packets)
+		{
+			if(!packetLengthMarkers_->pushPL(packet.len))
+				return false;
+		}
+		tilePartLength += packetLengthMarkers_->getTotalBytesWritten();
+	}
+	if(tilePartLength > UINT_MAX)
+	{
+		GRK_ERROR("Transcode: tile %u length %" PRIu64 " exceeds maximum tile part length",
+				  tileIndex, tilePartLength);
+		return false;
+	}
+
+	// 3. tile part header
+	if(!dest_->writeShort(J2K_MS_SOT) || !dest_->writeShort(sotLength) ||
+	   !dest_->writeShort(tileIndex) || !dest_->writeInt((uint32_t)tilePartLength) ||
+	   !dest_->writeByte(0) || !dest_->writeByte(1))
+		return false;
+	if(dest_->writeBytes(header.data(), header.size()) != header.size())
+		return false;
+	if(hasPL_ && !packetLengthMarkers_->write())
+		return false;
+	if(!dest_->writeShort(J2K_MS_SOD))
+		return false;
+
+	// 4. packets, with SOP sequence numbers renumbered
+	uint16_t packetIndex = 0;
+	for(auto& packet : packets)
+	{
+		auto data = packet.data;
+		auto len = packet.len;
+		if(hasSOP && len >= sopLength && data[0] == 0xFF && data[1] == (J2K_MS_SOP & 0xFF))
+		{
+			if(dest_->writeBytes(data, 4) != 4 || !dest_->writeShort(packetIndex))
+				return false;
+			data += sopLength;
+			len -= sopLength;
+		}
+		if(dest_->writeBytes(data, len) != len)
+			return false;
+		packetIndex++;
+	}
+	if(tileLengthMarkers_)
+		tileLengthMarkers_->push(tileIndex, (uint32_t)tilePartLength);
+	tileHeaders_.erase(tileIndex);
+	numTilesWritten_++;
+
+	return true;
+}
+bool Transcoder::writeEnd(void)
+{
+	if(tileLengthMarkers_)
+	{
+		if(numTilesWritten_ != numTiles_)
+		{
+			GRK_ERROR("Transcode: TLM marker requires all %u tiles, but only %u tiles were found",
+					  numTiles_, numTilesWritten_);
+			return false;
+		}
+		if(!tileLengthMarkers_->writeEnd())
+			return false;
+	}
+	if(!dest_->writeShort(J2K_MS_EOC))
+		return false;
+
+	return dest_->flush();
+}
+
+} // namespace grk
@@ -0,0 +1,82 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace grk
+{
+/**
+ * Transcodes a code stream in the compressed domain, keeping its first
+ * quality layers and/or discarding its highest resolutions.
+ *
+ * Packets are located without being decoded, and are copied unchanged:
+ * only marker segments are rewritten. Each tile is written as a single tile part.
+ */
+class Transcoder
+{
+  public:
+	Transcoder(CodeStreamDecompress* codeStream, BufferedStream* dest,
+			   grk_transcode_params* params);
+	~Transcoder();
+	/**
+	 * Transcode code stream
+	 *
+	 * @param readHeader reads main header of source code stream
+	 * @return number of bytes written, or 0 on failure
+	 */
+	uint64_t transcode(std::function<bool(void)> readHeader);
+
+  private:
+	bool onMarker(int32_t tileIndex, uint16_t id, const uint8_t* headerData, uint16_t header_size);
+	bool rewrite(uint16_t id, std::vector<uint8_t>& segment);
+	bool rewriteSIZ(std::vector<uint8_t>& segment);
+	bool rewriteCOD(std::vector<uint8_t>& segment);
+	bool rewriteCOC(std::vector<uint8_t>& segment);
+	bool rewriteSPcod(std::vector<uint8_t>& segment, size_t offset, bool hasPrecincts);
+	bool rewriteQuantization(std::vector<uint8_t>& segment, size_t offset);
+	bool rewritePOC(std::vector<uint8_t>& segment);
+	/**
+	 * Check that a progression order can be preserved when resolutions are discarded
+	 *
+	 * @param progression progression order
+	 * @return true if progression order can be preserved
+	 */
+	bool validateProgression(uint8_t progression);
+	bool writeMainHeader(void);
+	bool writeTile(TileProcessor* tileProcessor, std::vector<PacketSpan>& packets);
+	bool writeEnd(void);
+	uint32_t numComponentBytes(void);
+
+	CodeStreamDecompress* codeStream_;
+	BufferedStream* dest_;
+	uint16_t maxLayers_;
+	uint8_t reduce_;
+	std::vector<uint8_t> mainHeader_;
+	// rewritten marker segments of each tile's tile part headers
+	std::map<uint16_t, std::vector<uint8_t>> tileHeaders_;
+	bool hasTLM_;
+	bool hasPL_;
+	TileLengthMarkers* tileLengthMarkers_;
+	PLMarkerMgr* packetLengthMarkers_;
+	uint16_t numComps_;
+	uint32_t numTiles_;
+	uint32_t numTilesWritten_;
+	// true if reduced tile origins map onto the original tile origins
+	bool alignedTiles_;
+};
+
+} // namespace grk
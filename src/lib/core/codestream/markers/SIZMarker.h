@@ -26,6 +26,9 @@ namespace grk
 class CodeStreamDecompress;
 class CodeStreamCompress;
 
+// SIZ fields preceding Csiz: Rsiz, then eight 32-bit grid parameters
+const uint32_t sizCsizOffset = 2 + 8 * 4;
+
 class SIZMarker
 {
   public:
@@ -47,8 +50,14 @@ class SIZMarker
 	 */
 	bool write(CodeStreamCompress* codeStream, BufferedStream* stream);
 
-  private:
-	void subsampleAndReduceHeaderImageComponents(GrkImage* headerImage, const CodingParams* p_cp);
+	/**
+	 * Apply sub-sampling and resolution reduction to header image components
+	 *
+	 * @param       headerImage   header image
+	 * @param       p_cp          coding parameters
+	 */
+	static void subsampleAndReduceHeaderImageComponents(GrkImage* headerImage,
+														const CodingParams* p_cp);
 };
 
 } // namespace grk
@@ -46,6 +46,7 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <deque>
 #include <algorithm>
 #include <numeric>
 /*
@@ -89,6 +90,7 @@
 #include "CodeStreamLimits.h"
 #include "geometry.h"
 #include "MemManager.h"
+#include "SizeClassPool.h"
 #include "buffer.h"
 #include "minpf_plugin_manager.h"
 #include "plugin_interface.h"
@@ -97,6 +99,10 @@
 #include "GrkObjectWrapper.h"
 #include "logger.h"
 #include "ChronoTimer.h"
+#include "Stats.h"
+#include "CodecControl.h"
+#include "SchedulerCache.h"
+#include "PacketSequence.h"
 #include "testing.h"
 #include "MemStream.h"
 #include "GrkMappedFile.h"
@@ -122,6 +128,7 @@
 #include "FileFormatCompress.h"
 #include "FileFormatDecompress.h"
 #include "BitIO.h"
+#include "PacketHeaderReader.h"
 #include "TagTree.h"
 #include "t1_common.h"
 #include "T1Interface.h"
@@ -144,10 +151,16 @@
 #include "ImageComponentFlow.h"
 #include "TileComponent.h"
 #include "mct.h"
+#include "Resampler.h"
 #include "TileProcessor.h"
 #include "TileCache.h"
 #include "T2Compress.h"
 #include "T2Decompress.h"
+#include "Transcoder.h"
+#include "BlockTranscoder.h"
+#include "TilePartCopier.h"
+#include "TileCropper.h"
+#include "Stitcher.h"
 #include "grk_intmath.h"
 #include "plugin_bridge.h"
 #include "RateControl.h"
@@ -155,6 +168,8 @@
 #include "T1Factory.h"
 #include "DecompressScheduler.h"
 #include "CompressScheduler.h"
+#include "AsyncJob.h"
+#include "FramePipeline.h"
 
 #if(defined(__aarch64__) || defined(_M_ARM64)) && !defined(__ARM_FEATURE_SVE2) && \
 	!defined(__ARM_FEATURE_SVE2)
@@ -44,10 +44,16 @@ struct GrkCodec
 	{
 		return &obj;
 	}
+	void setStream(grk_stream* stream)
+	{
+		grk_object_unref(stream_);
+		stream_ = stream;
+	}
 
 	grk_object obj;
 	ICodeStreamCompress* compressor_;
 	ICodeStreamDecompress* decompressor_;
+	AsyncJob async_;
 
   private:
 	grk_stream* stream_;
@@ -61,6 +67,8 @@ GrkCodec::GrkCodec(grk_stream* stream)
 
 GrkCodec::~GrkCodec()
 {
+	// asynchronous call in flight must finish before codec is destroyed
+	async_.wait(nullptr);
 	delete compressor_;
 	delete decompressor_;
 	grk_object_unref(stream_);
@@ -125,6 +133,12 @@ GRK_API void GRK_CALLCONV grk_deinitialize()
 {
 	grk_plugin_cleanup();
 	ExecSingleton::release();
+	SizeClassPool::get()->purge();
+}
+
+GRK_API void GRK_CALLCONV grk_set_buffer_pool(uint64_t max_idle_bytes, bool huge_pages)
+{
+	SizeClassPool::get()->configure(max_idle_bytes, huge_pages);
 }
 
 GRK_API grk_object* GRK_CALLCONV grk_object_ref(grk_object* obj)
@@ -355,6 +369,42 @@ bool GRK_CALLCONV grk_decompress_read_header(grk_codec* codecWrapper, grk_header
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_read_metadata(grk_codec* codecWrapper,
+											   grk_header_info* header_info)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->decompressor_ ? codec->decompressor_->readMetadata(header_info) : false;
+	}
+	return false;
+}
+uint64_t GRK_CALLCONV grk_decompress_get_shared_header(grk_codec* codecWrapper, uint8_t* buf,
+													   uint64_t len)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->decompressor_ ? codec->decompressor_->getSharedHeader(buf, len) : 0;
+	}
+	return 0;
+}
+bool GRK_CALLCONV grk_decompress_read_shared_header(grk_codec* codecWrapper,
+													grk_header_info* header_info,
+													const uint8_t* buf, uint64_t len)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		if(!codec->decompressor_)
+			return false;
+		if(!codec->decompressor_->readSharedHeader(header_info, buf, len))
+			return false;
+
+		return codec->decompressor_->preProcess();
+	}
+	return false;
+}
 bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codecWrapper, float start_x, float start_y,
 											float end_x, float end_y)
 {
@@ -367,6 +417,18 @@ bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codecWrapper, float start
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_set_tiles(grk_codec* codecWrapper, const uint16_t* tileIndices,
+										   uint16_t numTiles)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->decompressor_
+				   ? codec->decompressor_->setDecompressTiles(tileIndices, numTiles)
+				   : false;
+	}
+	return false;
+}
 bool GRK_CALLCONV grk_decompress(grk_codec* codecWrapper, grk_plugin_tile* tile)
 {
 	if(codecWrapper)
@@ -390,6 +452,74 @@ bool GRK_CALLCONV grk_decompress_tile(grk_codec* codecWrapper, uint16_t tileInde
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_next_frame(grk_codec* codecWrapper,
+											 grk_stream_params* stream_params)
+{
+	if(!codecWrapper || !stream_params)
+		return false;
+	auto codec = GrkCodec::getImpl(codecWrapper);
+	if(!codec->decompressor_)
+		return false;
+	if(codec->async_.status(nullptr) == GRK_ASYNC_PENDING)
+	{
+		GRK_ERROR("Unable to move to next frame while asynchronous decompress is in progress");
+		return false;
+	}
+	grk_stream* stream = nullptr;
+	if(stream_params->file)
+		stream = create_mapped_file_read_stream(stream_params->file);
+	else if(stream_params->buf)
+		stream = create_mem_stream(stream_params->buf, stream_params->len, false, true);
+	if(!stream)
+	{
+		GRK_ERROR("Unable to create stream for next frame.");
+		return false;
+	}
+	if(!codec->decompressor_->nextFrame(BufferedStream::getImpl(stream)))
+	{
+		grk_object_unref(stream);
+		return false;
+	}
+	codec->setStream(stream);
+
+	return true;
+}
+void GRK_CALLCONV grk_decompress_cancel(grk_codec* codecWrapper)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		if(codec->decompressor_)
+			codec->decompressor_->cancel();
+	}
+}
+bool GRK_CALLCONV grk_decompress_async(grk_codec* codecWrapper, grk_plugin_tile* tile,
+									   grk_async_params* params)
+{
+	if(!codecWrapper)
+		return false;
+	auto codec = GrkCodec::getImpl(codecWrapper);
+	if(!codec->decompressor_)
+		return false;
+
+	return codec->async_.launch(codecWrapper, params, [codecWrapper, tile]() {
+		return (uint64_t)grk_decompress(codecWrapper, tile);
+	});
+}
+GRK_ASYNC_STATUS GRK_CALLCONV grk_async_status(grk_codec* codecWrapper, uint64_t* result)
+{
+	if(!codecWrapper)
+		return GRK_ASYNC_NONE;
+
+	return GrkCodec::getImpl(codecWrapper)->async_.status(result);
+}
+GRK_ASYNC_STATUS GRK_CALLCONV grk_async_wait(grk_codec* codecWrapper, uint64_t* result)
+{
+	if(!codecWrapper)
+		return GRK_ASYNC_NONE;
+
+	return GrkCodec::getImpl(codecWrapper)->async_.wait(result);
+}
 void GRK_CALLCONV grk_dump_codec(grk_codec* codecWrapper, uint32_t info_flag, FILE* output_stream)
 {
 	assert(codecWrapper);
@@ -400,6 +530,72 @@ void GRK_CALLCONV grk_dump_codec(grk_codec* codecWrapper, uint32_t info_flag, FI
 			codec->decompressor_->dump(info_flag, output_stream);
 	}
 }
+static Stats* getStats(grk_codec* codecWrapper)
+{
+	if(!codecWrapper)
+		return nullptr;
+	auto codec = GrkCodec::getImpl(codecWrapper);
+	if(codec->decompressor_)
+		return codec->decompressor_->getStats();
+	if(codec->compressor_)
+		return codec->compressor_->getStats();
+
+	return nullptr;
+}
+bool GRK_CALLCONV grk_get_stats(grk_codec* codecWrapper, grk_stats* stats)
+{
+	if(!stats)
+		return false;
+	auto impl = getStats(codecWrapper);
+	if(!impl)
+		return false;
+	impl->get(stats);
+
+	return true;
+}
+const char* GRK_CALLCONV grk_get_stage_name(GRK_STAGE stage)
+{
+	return statsStageName(stage);
+}
+const char* GRK_CALLCONV grk_get_counter_name(GRK_COUNTER counter)
+{
+	return statsCounterName(counter);
+}
+bool GRK_CALLCONV grk_dump_trace(grk_codec* codecWrapper, const char* fileName)
+{
+	auto impl = getStats(codecWrapper);
+	if(!impl || !impl->isTracing())
+		return false;
+
+	return impl->dumpTrace(fileName);
+}
+static MemAccount* getMemAccount(grk_codec* codecWrapper)
+{
+	if(!codecWrapper)
+		return nullptr;
+	auto codec = GrkCodec::getImpl(codecWrapper);
+	if(codec->decompressor_)
+		return codec->decompressor_->getMemAccount();
+	if(codec->compressor_)
+		return codec->compressor_->getMemAccount();
+
+	return nullptr;
+}
+bool GRK_CALLCONV grk_get_mem_stats(grk_codec* codecWrapper, grk_mem_stats* stats)
+{
+	if(!stats)
+		return false;
+	auto account = getMemAccount(codecWrapper);
+	if(!account)
+		return false;
+	account->get(stats);
+
+	return true;
+}
+const char* GRK_CALLCONV grk_get_mem_category_name(GRK_MEM_CATEGORY category)
+{
+	return memCategoryName(category);
+}
 
 bool GRK_CALLCONV grk_set_MCT(grk_cparameters* parameters, float* pEncodingMatrix,
 							  int32_t* p_dc_shift, uint32_t pNbComp)
@@ -572,6 +768,135 @@ uint64_t GRK_CALLCONV grk_compress(grk_codec* codecWrapper, grk_plugin_tile* til
 	}
 	return 0;
 }
+bool GRK_CALLCONV grk_compress_async(grk_codec* codecWrapper, grk_plugin_tile* tile,
+									 grk_async_params* params)
+{
+	if(!codecWrapper)
+		return false;
+	auto codec = GrkCodec::getImpl(codecWrapper);
+	if(!codec->compressor_)
+		return false;
+
+	return codec->async_.launch(codecWrapper, params,
+								[codecWrapper, tile]() { return grk_compress(codecWrapper, tile); });
+}
+grk_object* GRK_CALLCONV grk_compress_pipeline_create(grk_cparameters* parameters,
+													   uint32_t max_frames_in_flight,
+													   grk_pipeline_callback callback,
+													   void* user_data)
+{
+	if(!parameters || !callback)
+		return nullptr;
+	if(parameters->cod_format != GRK_FMT_J2K && parameters->cod_format != GRK_FMT_JP2)
+	{
+		GRK_ERROR("Unknown stream format.");
+		return nullptr;
+	}
+	auto pipeline = new FramePipeline(parameters, max_frames_in_flight, callback, user_data);
+
+	return pipeline->getWrapper();
+}
+bool GRK_CALLCONV grk_compress_pipeline_push(grk_object* pipeline, grk_image* image,
+											  void* user_data)
+{
+	if(!pipeline || !image)
+		return false;
+
+	return FramePipeline::getImpl(pipeline)->push(image, user_data);
+}
+bool GRK_CALLCONV grk_compress_pipeline_flush(grk_object* pipeline)
+{
+	if(!pipeline)
+		return false;
+
+	return FramePipeline::getImpl(pipeline)->flush();
+}
+uint64_t GRK_CALLCONV grk_transcode(grk_stream_params* src_params,
+									grk_stream_params* dest_params,
+									grk_transcode_params* params)
+{
+	if(!src_params || !dest_params || !params)
+		return 0;
+	grk_decompress_core_params core_params;
+	memset(&core_params, 0, sizeof(grk_decompress_core_params));
+	core_params.tileCacheStrategy = GRK_TILE_CACHE_NONE;
+	core_params.randomAccessFlags_ =
+		GRK_RANDOM_ACCESS_TLM | GRK_RANDOM_ACCESS_PLM | GRK_RANDOM_ACCESS_PLT;
+	auto codecWrapper = grk_decompress_init(src_params, &core_params);
+	if(!codecWrapper)
+	{
+		GRK_ERROR("Failed to initialize transcode source.");
+		return 0;
+	}
+	grk_stream* stream = nullptr;
+	if(dest_params->buf)
+		stream = create_mem_stream(dest_params->buf, dest_params->len, false, false);
+	else
+		stream = grk_stream_create_file_stream(dest_params->file, 1024 * 1024, false);
+	if(!stream)
+	{
+		GRK_ERROR("failed to create stream");
+		grk_object_unref(codecWrapper);
+		return 0;
+	}
+	auto codec = GrkCodec::getImpl(codecWrapper);
+	uint64_t bytesWritten =
+		codec->decompressor_->transcode(BufferedStream::getImpl(stream), params);
+	if(dest_params->buf)
+		dest_params->buf_compressed_len = bytesWritten;
+	grk_object_unref(stream);
+	grk_object_unref(codecWrapper);
+
+	return bytesWritten;
+}
+uint64_t GRK_CALLCONV grk_stitch(grk_stream_params* fragments, uint32_t numFragments,
+								 grk_stream_params* dest_params)
+{
+	if(!fragments || !numFragments || !dest_params)
+		return 0;
+	grk_decompress_core_params core_params;
+	memset(&core_params, 0, sizeof(grk_decompress_core_params));
+	core_params.tileCacheStrategy = GRK_TILE_CACHE_NONE;
+	core_params.randomAccessFlags_ = GRK_RANDOM_ACCESS_TLM;
+	grk_stream* stream = nullptr;
+	if(dest_params->buf)
+		stream = create_mem_stream(dest_params->buf, dest_params->len, false, false);
+	else
+		stream = grk_stream_create_file_stream(dest_params->file, 1024 * 1024, false);
+	if(!stream)
+	{
+		GRK_ERROR("failed to create stream");
+		return 0;
+	}
+	uint64_t bytesWritten = 0;
+	// fragments stay open until all of their tile parts have been copied
+	std::vector<grk_object*> codecWrappers;
+	{
+		Stitcher stitcher(BufferedStream::getImpl(stream));
+		bool rc = true;
+		for(uint32_t i = 0; i < numFragments && rc; ++i)
+		{
+			auto codecWrapper = grk_decompress_init(fragments + i, &core_params);
+			if(!codecWrapper)
+			{
+				GRK_ERROR("Failed to initialize stitch fragment %u.", i);
+				rc = false;
+				break;
+			}
+			codecWrappers.push_back(codecWrapper);
+			rc = GrkCodec::getImpl(codecWrapper)->decompressor_->stitch(&stitcher);
+		}
+		if(rc)
+			bytesWritten = stitcher.stitch();
+	}
+	if(dest_params->buf)
+		dest_params->buf_compressed_len = bytesWritten;
+	for(auto codecWrapper : codecWrappers)
+		grk_object_unref(codecWrapper);
+	grk_object_unref(stream);
+
+	return bytesWritten;
+}
 static void grkFree_file(void* p_user_data)
 {
 	if(p_user_data)
@@ -472,6 +472,25 @@ typedef struct _grk_stream_params
 	size_t buf_compressed_len;
 } grk_stream_params;
 
+/**
+ * Decompression progress
+ */
+typedef struct _grk_progress
+{
+	uint16_t tiles_decompressed;
+	/* number of tiles scheduled for decompression */
+	uint16_t num_tiles;
+	uint64_t blocks_decompressed;
+} grk_progress;
+
+/**
+ * Progress callback. It may be called from any library thread, but is never
+ * called concurrently for the same codec.
+ *
+ * @return false to cancel decompression, otherwise true
+ */
+typedef bool (*grk_progress_callback)(const grk_progress* progress, void* user_data);
+
 typedef enum _GRK_TILE_CACHE_STRATEGY
 {
 	GRK_TILE_CACHE_NONE, /* no tile caching */
@@ -505,6 +524,47 @@ typedef struct _grk_decompress_core_params
 	grk_io_pixels_callback io_buffer_callback;
 	void* io_user_data;
 	grk_io_register_reclaim_callback io_register_client_callback;
+	/* instrumentation flags: combination of GRK_STATS_* values */
+	uint32_t statsFlags_;
+	/**
+	 Maximum memory in bytes used for decompressing tiles and buffering output strips.
+	 Tiles are only decompressed concurrently while their estimated footprint fits
+	 into this budget, and pooled strip buffers are freed rather than kept when over
+	 budget. A single tile is always decompressed, even if it doesn't fit.
+	 0 means no limit
+	 */
+	uint64_t max_memory;
+	/**
+	 Maximum duration in milliseconds of each decompress call. Once it has passed,
+	 decompression stops and fails. 0 means no deadline
+	 */
+	uint32_t deadline_ms;
+	/* progress callback (may be null) */
+	grk_progress_callback progress_callback;
+	void* progress_user_data;
+	/**
+	 Only locate XML, UUID and ASOC boxes while reading the JP2 header, skipping
+	 their payloads, which are then read by grk_decompress_read_metadata.
+	 Speeds up header reads of files with large metadata, for callers that only
+	 need pixels
+	 */
+	bool lazy_metadata;
+	/**
+	 Keep irreversible (9/7) components in floating point, without the final rounding to
+	 integer. The dc level shift is applied and samples are clamped to the nominal range
+	 of the component, but colour and precision conversions are skipped. Components are
+	 flagged with grk_image_comp::float_data
+	 */
+	bool float_output;
+	/**
+	 Output size of the full image. The lowest resolution at least this large is
+	 decompressed, in place of the reduce setting, and then resampled to this size with
+	 an area filter. A decompress window is scaled by the same factor. If only one
+	 dimension is non-zero, the aspect ratio is preserved. Only downscaling is supported.
+	 0 means no resampling
+	 */
+	uint32_t target_width;
+	uint32_t target_height;
 } grk_decompress_core_params;
 
 #define GRK_DECOMPRESS_COMPRESSION_LEVEL_DEFAULT (UINT_MAX)
@@ -545,6 +605,10 @@ typedef struct _grk_decompress_params
 	/** tile number of the decompressed tile*/
 	uint16_t tileIndex;
 	bool singleTileDecompress;
+	/** decompress only tiles tileRangeBegin to tileRangeEnd - 1.
+	 tileRangeEnd = 0 decompresses all tiles */
+	uint16_t tileRangeBegin;
+	uint16_t tileRangeEnd;
 	grk_precision* precision;
 	uint32_t numPrecision;
 	/* force output colorspace to RGB */
@@ -602,9 +666,12 @@ typedef struct _grk_image_comp
 	uint16_t Xcrg, Ycrg;
 	/** image component data */
 	int32_t* data;
+	/** data holds 32 bit IEEE floating point samples instead of integers,
+	 * and should be accessed as float* (see float_output decompress parameter) */
+	bool float_data;
 } grk_image_comp;
 
-/* Image meta data: colour, IPTC and XMP */
+/* Image meta data: colour, IPTC, XMP and Exif */
 typedef struct _grk_image_meta
 {
 	grk_object obj;
@@ -613,6 +680,10 @@ typedef struct _grk_image_meta
 	size_t iptc_len;
 	uint8_t* xmp_buf;
 	size_t xmp_len;
+	/** TIFF-structured Exif block (byte order mark, IFD0 and sub-IFDs),
+	 * without the JPEG "Exif\0\0" identifier */
+	uint8_t* exif_buf;
+	size_t exif_len;
 } grk_image_meta;
 
 typedef struct _grk_image
@@ -751,6 +822,103 @@ typedef struct _grk_plugin_tile
 /* opaque codec object */
 typedef grk_object grk_codec;
 
+/**
+ * Status of asynchronous decompress/compress
+ */
+typedef enum _GRK_ASYNC_STATUS
+{
+	GRK_ASYNC_NONE, /* no asynchronous call has been made */
+	GRK_ASYNC_PENDING,
+	GRK_ASYNC_SUCCEEDED,
+	GRK_ASYNC_FAILED
+} GRK_ASYNC_STATUS;
+
+/**
+ * Asynchronous completion callback. Called on a library thread.
+ * The call is still in flight while the callback runs, so the codec must not be
+ * destroyed, waited on with grk_async_wait, or used to launch another asynchronous
+ * call from inside the callback.
+ *
+ * @param codec			codec
+ * @param success		true if call succeeded
+ * @param result		compress: number of bytes written; decompress: 1 on success
+ * @param user_data		user data
+ */
+typedef void (*grk_async_callback)(grk_codec* codec, bool success, uint64_t result,
+								   void* user_data);
+
+/**
+ * Asynchronous completion parameters
+ */
+typedef struct _grk_async_params
+{
+	/* completion callback (may be null) */
+	grk_async_callback callback;
+	void* user_data;
+	/* file descriptor (i.e. eventfd or pipe) that an 8 byte value of 1 is written to
+	 * on completion, so that it can be polled by an event loop. -1 if unused.
+	 * Not supported on Windows */
+	int notify_fd;
+} grk_async_params;
+
+/**
+ * Frame delivered by a compress pipeline
+ */
+typedef struct _grk_pipeline_frame
+{
+	/* index of frame in submission order, starting from zero */
+	uint64_t frame_index;
+	/* image submitted for this frame */
+	grk_image* image;
+	/* user data submitted for this frame */
+	void* user_data;
+	/* true if frame was compressed successfully */
+	bool success;
+	/* compressed code stream; only valid for the duration of the callback */
+	const uint8_t* data;
+	/* length of compressed code stream in bytes */
+	uint64_t len;
+} grk_pipeline_frame;
+
+/**
+ * Compress pipeline delivery callback. Frames are delivered one at a time,
+ * in submission order, on a library thread. The pipeline must not be
+ * pushed to, flushed or destroyed from inside the callback.
+ *
+ * @param frame			compressed frame
+ * @param user_data		pipeline user data
+ */
+typedef void (*grk_pipeline_callback)(grk_pipeline_frame* frame, void* user_data);
+
+/**
+ * Block coder of transcoded code stream
+ */
+typedef enum _GRK_BLOCK_CODER
+{
+	GRK_BLOCK_CODER_KEEP, /**< keep source block coder: packets are copied unchanged */
+	GRK_BLOCK_CODER_PART1, /**< JPEG 2000 Part-1 (EBCOT) block coder */
+	GRK_BLOCK_CODER_HT /**< High Throughput (HTJ2K) block coder */
+} GRK_BLOCK_CODER;
+
+/**
+ * Compressed-domain transcode parameters
+ */
+typedef struct _grk_transcode_params
+{
+	/* number of quality layers to keep; 0 keeps all layers */
+	uint16_t max_layers;
+	/* number of highest resolutions to discard */
+	uint8_t reduce;
+	/* block coder of transcoded code stream */
+	GRK_BLOCK_CODER block_coder;
+	/* crop to the tiles intersecting region (crop_x0,crop_y0,crop_x1,crop_y1)
+	 * of the reference grid; crop_x1 = crop_y1 = 0 keeps all tiles */
+	uint32_t crop_x0;
+	uint32_t crop_y0;
+	uint32_t crop_x1;
+	uint32_t crop_y1;
+} grk_transcode_params;
+
 /**
  * Library version
  */
@@ -769,6 +937,19 @@ GRK_API void GRK_CALLCONV grk_initialize(const char* pluginPath, uint32_t numthr
  */
 GRK_API void GRK_CALLCONV grk_deinitialize();
 
+/**
+ * Configure buffer pool shared by all codecs
+ *
+ * Tile windows, sparse canvas blocks and image component data are recycled
+ * through a process-wide pool of size-binned buffers. Idle buffers are freed
+ * by grk_deinitialize.
+ *
+ * @param max_idle_bytes 	maximum number of bytes held by idle buffers
+ * 							(default 256 MiB; 0 disables pooling)
+ * @param huge_pages 		request transparent huge pages for large buffers (Linux only)
+ */
+GRK_API void GRK_CALLCONV grk_set_buffer_pool(uint64_t max_idle_bytes, bool huge_pages);
+
 /**
  * Increment ref count
  */
@@ -855,6 +1036,59 @@ GRK_API grk_codec* GRK_CALLCONV grk_decompress_init(grk_stream_params* stream_pa
 GRK_API bool GRK_CALLCONV grk_decompress_read_header(grk_codec* codec,
 													 grk_header_info* header_info);
 
+/**
+ * Read JP2 metadata boxes (XML, UUID and ASOC) that were skipped while reading
+ * the header, because lazy_metadata was set in the core decompress parameters.
+ * XML and ASOC boxes are returned in header_info, and IPTC and XMP UUID boxes
+ * are attached to the composite image's meta data. This function should be called
+ * after grk_decompress_read_header is called, and before grk_decompress is called.
+ *
+ * @param	codec				decompression codec
+ * @param	header_info			header info to store XML and ASOC boxes in (may be NULL)
+ *
+ * @return true					if all skipped boxes were correctly read
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_read_metadata(grk_codec* codec,
+													   grk_header_info* header_info);
+
+/**
+ * Get shared header: all bytes of the source up to and including the SOT marker
+ * of its first tile part, i.e. any JP2 boxes preceding the code stream box, followed
+ * by the code stream main header and the first SOT marker. Another codec reading
+ * the same source may read the shared header with grk_decompress_read_shared_header,
+ * rather than reading the main header from the source, so that independent processes
+ * can each decompress a subset of the tiles (see grk_decompress_set_tiles) without
+ * reading the source header.
+ * This function should be called after grk_decompress_read_header is called.
+ *
+ * @param	codec				decompression codec
+ * @param	buf					buffer to store shared header in, or NULL to query length
+ * @param	len					length of buffer
+ *
+ * @return length of shared header, or 0 if header has not been read or buffer
+ * is too small
+ */
+GRK_API uint64_t GRK_CALLCONV grk_decompress_get_shared_header(grk_codec* codec, uint8_t* buf,
+															   uint64_t len);
+
+/**
+ * Decompress JPEG 2000 header from a shared header, in place of
+ * grk_decompress_read_header. The shared header must have been retrieved
+ * with grk_decompress_get_shared_header from a codec reading the same source.
+ * Once read, the codec's source is positioned just after the SOT marker of
+ * its first tile part.
+ *
+ * @param	codec				decompression codec
+ * @param	header_info			information read from JPEG 2000 header.
+ * @param	buf					shared header
+ * @param	len					length of shared header
+ *
+ * @return true					if the shared header is correctly read.
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_read_shared_header(grk_codec* codec,
+															grk_header_info* header_info,
+															const uint8_t* buf, uint64_t len);
+
 /**
  * Get decompressed tile image
  *
@@ -890,6 +1124,22 @@ GRK_API grk_image* GRK_CALLCONV grk_decompress_get_composited_image(grk_codec* c
 GRK_API bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codec, float start_x, float start_y,
 													float end_x, float end_y);
 
+/**
+ * Set the tiles to be decompressed. The decompressed area is set to the bounding box
+ * of the tiles: tiles inside this box that are not in the set are skipped, using
+ * TLM markers to seek past them when present. This function should be called
+ * right after grk_decompress_read_header or grk_decompress_read_shared_header
+ * is called, and before any tile header is read.
+ *
+ * @param	codec			decompression codec
+ * @param	tileIndices		indices of tiles to decompress
+ * @param	numTiles		number of tiles
+ *
+ * @return	true			if the tiles could be set.
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_set_tiles(grk_codec* codec, const uint16_t* tileIndices,
+												   uint16_t numTiles);
+
 /**
  * Decompress image from a JPEG 2000 code stream
  *
@@ -910,6 +1160,69 @@ GRK_API bool GRK_CALLCONV grk_decompress(grk_codec* codec, grk_plugin_tile* tile
  */
 GRK_API bool GRK_CALLCONV grk_decompress_tile(grk_codec* codec, uint16_t tileIndex);
 
+/**
+ * Move codec to the next frame of a code stream sequence, such as Motion JPEG 2000
+ * or DCP frames. The next frame must be a JPEG 2000 code stream whose main header
+ * has the same coding parameters (SIZ, COD, COC, QCD, QCC etc.) as the first frame;
+ * only TLM, PLM, CRG and COM marker segments may differ. PPM is not supported.
+ *
+ * Coding parameters, decompress window, images, cached task graphs, T1 coders and
+ * buffer pools are all reused, so the frame can be decompressed directly with
+ * grk_decompress, without reading its header. The previous frame's image data
+ * is recycled, so it is only valid until this call.
+ *
+ * @param	codec			decompression codec, whose header has already been read
+ * @param	stream_params	stream parameters for next frame
+ *
+ * @return					true if next frame matches and is ready to be decompressed
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_next_frame(grk_codec* codec,
+													grk_stream_params* stream_params);
+
+/**
+ * Cancel decompression. Safe to call from any thread while decompression is in progress.
+ * The decompress call in progress stops scheduling new work and fails, as do all later
+ * decompress calls with this codec.
+ *
+ * @param	codec			decompression codec
+ */
+GRK_API void GRK_CALLCONV grk_decompress_cancel(grk_codec* codec);
+
+/**
+ * Decompress image asynchronously. Returns immediately; decompression runs on
+ * a library thread, and completion is signalled as set out in params.
+ * Only one asynchronous call may be in flight for a codec.
+ *
+ * @param codec 	decompression codec
+ * @param tile		tile struct from plugin
+ * @param params	completion parameters (may be null, in which case
+ * 					grk_async_status or grk_async_wait must be used)
+ *
+ * @return 			true if decompression was launched, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_async(grk_codec* codec, grk_plugin_tile* tile,
+											   grk_async_params* params);
+
+/**
+ * Get status of asynchronous call without blocking
+ *
+ * @param codec 	codec
+ * @param result	set to result once call is complete (may be null)
+ *
+ * @return 			status
+ */
+GRK_API GRK_ASYNC_STATUS GRK_CALLCONV grk_async_status(grk_codec* codec, uint64_t* result);
+
+/**
+ * Wait until asynchronous call, including its completion callback, has finished
+ *
+ * @param codec 	codec
+ * @param result	set to result (may be null)
+ *
+ * @return 			status
+ */
+GRK_API GRK_ASYNC_STATUS GRK_CALLCONV grk_async_wait(grk_codec* codec, uint64_t* result);
+
 /* COMPRESSION FUNCTIONS*/
 
 /**
@@ -1037,7 +1350,13 @@ typedef struct _grk_cparameters
 	uint32_t repeats;
 	bool writePLT;
 	bool writeTLM;
+	/* compress only tiles tileRangeBegin to tileRangeEnd - 1 into a code stream fragment
+	 * that can be stitched with grk_stitch; tileRangeEnd = 0 compresses all tiles */
+	uint16_t tileRangeBegin;
+	uint16_t tileRangeEnd;
 	bool verbose;
+	/* instrumentation flags: combination of GRK_STATS_* values */
+	uint32_t statsFlags;
 } grk_cparameters;
 
 /**
@@ -1081,6 +1400,130 @@ GRK_API grk_codec* GRK_CALLCONV grk_compress_init(grk_stream_params* stream_para
  */
 GRK_API uint64_t GRK_CALLCONV grk_compress(grk_codec* codec, grk_plugin_tile* tile);
 
+/**
+ * Compress image asynchronously. Returns immediately; compression runs on
+ * a library thread, and completion is signalled as set out in params.
+ * The result is the number of bytes written. Input image and output stream
+ * must stay valid until the call has completed.
+ *
+ * @param codec 		compression codec
+ * @param tile			plugin tile
+ * @param params		completion parameters (may be null)
+ *
+ * @return 				true if compression was launched, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_compress_async(grk_codec* codec, grk_plugin_tile* tile,
+											 grk_async_params* params);
+
+/**
+ * Create a compress pipeline, which keeps several frames of a sequence in flight
+ * at once. Each frame is compressed to its own code stream with the same
+ * parameters. All frames share the library executor and a pool of
+ * output buffers. If parameters->max_cs_size is set, it is a hard cap on each
+ * frame: a frame that does not fit is delivered as failed.
+ * Release the pipeline with grk_object_unref, which first flushes it.
+ *
+ * @param parameters			compression parameters (copied)
+ * @param max_frames_in_flight	maximum number of frames compressing at once;
+ * 								0 selects the number of library driver threads
+ * @param callback				delivery callback
+ * @param user_data				user data passed to callback
+ *
+ * @return 						pipeline, or null on failure
+ */
+GRK_API grk_object* GRK_CALLCONV grk_compress_pipeline_create(grk_cparameters* parameters,
+															  uint32_t max_frames_in_flight,
+															  grk_pipeline_callback callback,
+															  void* user_data);
+
+/**
+ * Push frame into compress pipeline. Blocks while the maximum number of
+ * frames is already in flight. The pipeline holds a reference to the image
+ * until the frame has been delivered; as with grk_compress, image data may be
+ * modified during compression.
+ *
+ * @param pipeline		compress pipeline
+ * @param image			frame image
+ * @param user_data		frame user data, passed back in grk_pipeline_frame
+ *
+ * @return 				true if frame was queued
+ */
+GRK_API bool GRK_CALLCONV grk_compress_pipeline_push(grk_object* pipeline, grk_image* image,
+													 void* user_data);
+
+/**
+ * Wait until all pushed frames have been delivered
+ *
+ * @param pipeline		compress pipeline
+ *
+ * @return 				true if all frames delivered since the previous flush
+ * 						were compressed successfully
+ */
+GRK_API bool GRK_CALLCONV grk_compress_pipeline_flush(grk_object* pipeline);
+
+/**
+ * Transcode a JPEG 2000 code stream without decoding it, keeping only the
+ * first max_layers quality layers and discarding the reduce highest resolutions.
+ * Packets are located by reading packet headers (or PLT/PLM markers, if present)
+ * and are copied unchanged; only marker segments are rewritten.
+ * Each output tile is written as a single tile part. TLM and PLT markers are written
+ * if the source has TLM and PLT/PLM markers respectively.
+ * Source code streams with packed packet headers (PPM/PPT) are not supported.
+ * Discarding resolutions requires tile dimensions (for more than one tile) and, for
+ * position-driven progressions, image and tile origins to be divisible by 2^reduce.
+ *
+ * If a block coder other than GRK_BLOCK_CODER_KEEP is selected, code blocks are instead
+ * decompressed to wavelet coefficients and re-compressed with the selected block coder,
+ * skipping the wavelet transform, multi component transform and DC level shift. The
+ * coefficients of the kept layers are written as a single lossless layer, so the
+ * transcoded code stream decompresses to exactly the same image as the kept layers of
+ * the source, with the exception of irreversible code blocks truncated by layer
+ * selection or rate control, which may differ by up to half a quantization step.
+ * Progression order changes and region of interest shifts are not preserved, resolutions
+ * cannot be discarded, and tile-specific coding parameters must not change the number
+ * of resolutions, wavelet transform or quantization.
+ *
+ * If a crop region is set, the code stream is instead cut down to the tiles intersecting
+ * the region, which cannot be combined with the other transcode parameters. Tile parts are
+ * located with the TLM marker if present, otherwise by skipping from one SOT marker to the
+ * next, and are copied unchanged apart from their tile index, so no packets are read.
+ * Kept tiles retain their reference grid coordinates: the image and tile grid origins are
+ * moved to the first kept tile. A TLM marker is written if the source has one.
+ * Source code streams with packed packet headers in the main header (PPM) are not supported.
+ *
+ * @param src_params	source JPEG 2000 stream (J2K code stream or JP2 file)
+ * @param dest_params	destination stream; a J2K code stream is written.
+ * 						For a buffer destination, buf_compressed_len is set to
+ * 						the number of bytes written
+ * @param params		transcode parameters
+ *
+ * @return 				number of bytes written if successful, 0 otherwise
+ */
+GRK_API uint64_t GRK_CALLCONV grk_transcode(grk_stream_params* src_params,
+											grk_stream_params* dest_params,
+											grk_transcode_params* params);
+
+/**
+ * Stitch code stream fragments into a single code stream, without decompressing them.
+ * Each fragment is compressed from the same image and compression parameters, but with
+ * a different tile range (see tileRangeBegin and tileRangeEnd in grk_cparameters), so
+ * that compression of a large image can be distributed across processes or machines.
+ * Fragments must have identical main headers apart from their TLM and PLM markers, and
+ * together must hold every tile of the image exactly once. Tile parts are located with
+ * the fragments' TLM markers, and are copied unchanged in fragment order, under the main
+ * header of the first fragment and a single TLM marker covering all tile parts.
+ *
+ * @param fragments		array of fragments (J2K code streams or JP2 files)
+ * @param numFragments	number of fragments
+ * @param dest_params	destination stream; a J2K code stream is written.
+ * 						For a buffer destination, buf_compressed_len is set to
+ * 						the number of bytes written
+ *
+ * @return 				number of bytes written if successful, 0 otherwise
+ */
+GRK_API uint64_t GRK_CALLCONV grk_stitch(grk_stream_params* fragments, uint32_t numFragments,
+										 grk_stream_params* dest_params);
+
 /**
  * Dump codec information to file
  *
@@ -1091,6 +1534,155 @@ GRK_API uint64_t GRK_CALLCONV grk_compress(grk_codec* codec, grk_plugin_tile* ti
  */
 GRK_API void GRK_CALLCONV grk_dump_codec(grk_codec* codec, uint32_t info_flag, FILE* output_stream);
 
+/**
+ * Instrumentation flags
+ */
+#define GRK_STATS_NONE 0 /* no instrumentation (default) */
+#define GRK_STATS_ENABLE 1 /* collect per-stage timings and counters */
+#define GRK_STATS_TRACE 2 /* also record individual spans for trace dump */
+#define GRK_STATS_MEMORY 4 /* account for memory used by codec */
+
+/**
+ * Instrumented stages
+ */
+typedef enum _GRK_STAGE
+{
+	GRK_STAGE_MARKER_PARSE, /* main header and tile part header parsing */
+	GRK_STAGE_T2, /* packet parsing (decompress) or packet writing (compress) */
+	GRK_STAGE_T1, /* code block decoding / encoding */
+	GRK_STAGE_DWT, /* wavelet transform */
+	GRK_STAGE_MCT, /* multi component transform and DC level shift */
+	GRK_STAGE_OUTPUT, /* tile compositing and strip serialization */
+	GRK_STAGE_IO, /* waiting on client I/O */
+	GRK_STAGE_TILE, /* entire tile */
+	GRK_NUM_STAGES
+} GRK_STAGE;
+
+/**
+ * Instrumented counters
+ */
+typedef enum _GRK_COUNTER
+{
+	GRK_COUNTER_TILES, /* tiles processed */
+	GRK_COUNTER_BLOCKS, /* code blocks decoded / encoded */
+	GRK_COUNTER_PASSES, /* coding passes decoded / encoded */
+	GRK_COUNTER_BYTES, /* compressed bytes read / written */
+	GRK_COUNTER_PACKETS, /* packets decoded */
+	GRK_NUM_COUNTERS
+} GRK_COUNTER;
+
+/**
+ * Aggregate timing for a single stage
+ */
+typedef struct _grk_stage_stats
+{
+	uint64_t count; /* number of spans */
+	double total_ms; /* sum of span durations, summed over all threads */
+	double max_ms; /* longest span */
+} grk_stage_stats;
+
+/**
+ * Codec instrumentation statistics
+ */
+typedef struct _grk_stats
+{
+	grk_stage_stats stages[GRK_NUM_STAGES];
+	uint64_t counters[GRK_NUM_COUNTERS];
+	double elapsed_ms; /* wall clock time since codec was initialized */
+} grk_stats;
+
+/**
+ * Get instrumentation statistics. Statistics are only collected if
+ * GRK_STATS_ENABLE was set in the codec parameters.
+ *
+ * @param	codec	compression or decompression codec
+ * @param	stats	statistics (out)
+ *
+ * @return true if statistics were collected for this codec
+ */
+GRK_API bool GRK_CALLCONV grk_get_stats(grk_codec* codec, grk_stats* stats);
+
+/**
+ * Get name of instrumented stage
+ *
+ * @param	stage	stage
+ *
+ * @return stage name
+ */
+GRK_API const char* GRK_CALLCONV grk_get_stage_name(GRK_STAGE stage);
+
+/**
+ * Get name of instrumented counter
+ *
+ * @param	counter	counter
+ *
+ * @return counter name
+ */
+GRK_API const char* GRK_CALLCONV grk_get_counter_name(GRK_COUNTER counter);
+
+/**
+ * Dump recorded spans to file in Chrome trace event (JSON) format,
+ * which can be loaded into chrome://tracing or Perfetto.
+ * Spans are only recorded if GRK_STATS_TRACE was set in the codec parameters.
+ *
+ * @param	codec		compression or decompression codec
+ * @param	fileName	trace file name
+ *
+ * @return true if successful
+ */
+GRK_API bool GRK_CALLCONV grk_dump_trace(grk_codec* codec, const char* fileName);
+
+/**
+ * Memory categories
+ */
+typedef enum _GRK_MEM_CATEGORY
+{
+	GRK_MEM_TILE_WINDOW, /* tile component and resolution windows */
+	GRK_MEM_CODEBLOCK, /* code block coefficient and compressed buffers */
+	GRK_MEM_COMPRESSED, /* compressed tile data read from code stream */
+	GRK_MEM_STRIP, /* strip buffers for client I/O */
+	GRK_MEM_T1, /* T1 coder scratch buffers */
+	GRK_NUM_MEM_CATEGORIES
+} GRK_MEM_CATEGORY;
+
+/**
+ * Current and peak memory usage
+ */
+typedef struct _grk_mem_usage
+{
+	uint64_t current; /* bytes currently allocated */
+	uint64_t peak; /* peak bytes allocated */
+} grk_mem_usage;
+
+/**
+ * Codec memory statistics
+ */
+typedef struct _grk_mem_stats
+{
+	grk_mem_usage categories[GRK_NUM_MEM_CATEGORIES];
+	grk_mem_usage total; /* peak is peak of sum over all categories */
+} grk_mem_stats;
+
+/**
+ * Get memory statistics. Memory is only accounted for if
+ * GRK_STATS_MEMORY was set in the codec parameters.
+ *
+ * @param	codec	compression or decompression codec
+ * @param	stats	memory statistics (out)
+ *
+ * @return true if memory was accounted for with this codec
+ */
+GRK_API bool GRK_CALLCONV grk_get_mem_stats(grk_codec* codec, grk_mem_stats* stats);
+
+/**
+ * Get name of memory category
+ *
+ * @param	category	memory category
+ *
+ * @return category name
+ */
+GRK_API const char* GRK_CALLCONV grk_get_mem_category_name(GRK_MEM_CATEGORY category);
+
 /**
  * Set the MCT matrix to use.
  *
@@ -1416,6 +2008,7 @@ typedef struct grk_plugin_compress_user_callback_info
 	grk_stream_params stream_params;
 	unsigned int error_code;
 	bool transferExifTags;
+	const char* trace_file; /* Chrome trace output file (null/empty for no trace) */
 } grk_plugin_compress_user_callback_info;
 
 typedef uint64_t (*GRK_PLUGIN_COMPRESS_USER_CALLBACK)(grk_plugin_compress_user_callback_info* info);
@@ -0,0 +1,223 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *    This source code incorporates work covered by the BSD 2-clause license.
+ *    Please see the LICENSE file in the root directory for details.
+ *
+ */
+#include "grk_includes.h"
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "point_transform/Resampler.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
+namespace grk
+{
+namespace HWY_NAMESPACE
+{
+	using namespace hwy::HWY_NAMESPACE;
+
+	/**
+	 * Multiply input row by weight, and add to accumulator row
+	 */
+	template<typename T>
+	void accumulate(const T* in, float weight, float* accum, uint32_t len)
+	{
+		const HWY_FULL(float) df;
+		const HWY_FULL(int32_t) di;
+		auto vweight = Set(df, weight);
+		size_t i = 0;
+		for(; i + Lanes(df) <= len; i += Lanes(df))
+		{
+			Vec<decltype(df)> v;
+			if constexpr(std::is_same<T, float>::value)
+				v = LoadU(df, in + i);
+			else
+				v = ConvertTo(df, LoadU(di, in + i));
+			StoreU(MulAdd(vweight, v, LoadU(df, accum + i)), df, accum + i);
+		}
+		for(; i < len; ++i)
+			accum[i] += weight * (float)in[i];
+	}
+
+	/**
+	 * Apply horizontal taps to accumulator row: tap k of output sample x
+	 * has input sample index[k * len + x] and weight weights[k * len + x].
+	 * Integer output is rounded to nearest.
+	 */
+	template<typename T>
+	void filter(const float* accum, const int32_t* index, const float* weights, uint32_t taps,
+				uint32_t len, T* out)
+	{
+		const HWY_FULL(float) df;
+		const HWY_FULL(int32_t) di;
+		auto vhalf = Set(df, 0.5f);
+		size_t x = 0;
+		for(; x + Lanes(df) <= len; x += Lanes(df))
+		{
+			auto sum = Zero(df);
+			for(uint32_t k = 0; k < taps; ++k)
+			{
+				auto in = GatherIndex(df, accum, LoadU(di, index + (size_t)k * len + x));
+				sum = MulAdd(LoadU(df, weights + (size_t)k * len + x), in, sum);
+			}
+			if constexpr(std::is_same<T, float>::value)
+				StoreU(sum, df, out + x);
+			else
+				StoreU(ConvertTo(di, Floor(sum + vhalf)), di, out + x);
+		}
+		for(; x < len; ++x)
+		{
+			float sum = 0;
+			for(uint32_t k = 0; k < taps; ++k)
+				sum += weights[(size_t)k * len + x] * accum[index[(size_t)k * len + x]];
+			if constexpr(std::is_same<T, float>::value)
+				out[x] = sum;
+			else
+				out[x] = (T)std::floor(sum + 0.5f);
+		}
+	}
+
+	void hwy_resample_accumulate(const int32_t* in, float weight, float* accum, uint32_t len)
+	{
+		accumulate<int32_t>(in, weight, accum, len);
+	}
+
+	void hwy_resample_accumulate_float(const float* in, float weight, float* accum, uint32_t len)
+	{
+		accumulate<float>(in, weight, accum, len);
+	}
+
+	void hwy_resample_filter(const float* accum, const int32_t* index, const float* weights,
+							 uint32_t taps, uint32_t len, int32_t* out)
+	{
+		filter<int32_t>(accum, index, weights, taps, len, out);
+	}
+
+	void hwy_resample_filter_float(const float* accum, const int32_t* index, const float* weights,
+								   uint32_t taps, uint32_t len, float* out)
+	{
+		filter<float>(accum, index, weights, taps, len, out);
+	}
+} // namespace HWY_NAMESPACE
+} // namespace grk
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace grk
+{
+HWY_EXPORT(hwy_resample_accumulate);
+HWY_EXPORT(hwy_resample_accumulate_float);
+HWY_EXPORT(hwy_resample_filter);
+HWY_EXPORT(hwy_resample_filter_float);
+
+AreaFilter::AreaFilter(uint32_t inLen, uint32_t outLen)
+	: first_(outLen), taps_(outLen), offset_(outLen)
+{
+	double scale = (double)inLen / outLen;
+	for(uint32_t i = 0; i < outLen; ++i)
+	{
+		double begin = i * scale;
+		double end = std::min<double>((i + 1) * scale, inLen);
+		auto b = std::min<uint32_t>((uint32_t)begin, inLen - 1);
+		auto e = std::clamp<uint32_t>((uint32_t)std::ceil(end), b + 1, inLen);
+		first_[i] = b;
+		taps_[i] = e - b;
+		offset_[i] = (uint32_t)weights_.size();
+		for(uint32_t j = b; j < e; ++j)
+		{
+			double cover = std::min<double>(j + 1, end) - std::max<double>(j, begin);
+			weights_.push_back((float)(std::max<double>(cover, 0) / (end - begin)));
+		}
+	}
+}
+uint32_t AreaFilter::maxTaps(void) const
+{
+	return taps_.empty() ? 0 : *std::max_element(taps_.begin(), taps_.end());
+}
+Resampler::Resampler(uint32_t inWidth, uint32_t inHeight, uint32_t outWidth, uint32_t outHeight)
+	: vert_(inHeight, outHeight), horzTaps_(0), outWidth_(outWidth), accum_(inWidth),
+	  inRow_(0), outRow_(0)
+{
+	AreaFilter horz(inWidth, outWidth);
+	horzTaps_ = horz.maxTaps();
+	horzIndex_.resize((size_t)horzTaps_ * outWidth);
+	horzWeights_.resize((size_t)horzTaps_ * outWidth);
+	for(uint32_t k = 0; k < horzTaps_; ++k)
+	{
+		for(uint32_t x = 0; x < outWidth; ++x)
+		{
+			auto tap = std::min<uint32_t>(k, horz.taps_[x] - 1);
+			horzIndex_[(size_t)k * outWidth + x] = (int32_t)(horz.first_[x] + tap);
+			horzWeights_[(size_t)k * outWidth + x] =
+				k < horz.taps_[x] ? horz.weights_[horz.offset_[x] + k] : 0.0f;
+		}
+	}
+}
+void Resampler::accumulate(const int32_t* in, float weight)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_resample_accumulate)
+	(in, weight, accum_.data(), (uint32_t)accum_.size());
+}
+void Resampler::accumulate(const float* in, float weight)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_resample_accumulate_float)
+	(in, weight, accum_.data(), (uint32_t)accum_.size());
+}
+void Resampler::filter(int32_t* out)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_resample_filter)
+	(accum_.data(), horzIndex_.data(), horzWeights_.data(), horzTaps_, outWidth_, out);
+}
+void Resampler::filter(float* out)
+{
+	HWY_DYNAMIC_DISPATCH(hwy_resample_filter_float)
+	(accum_.data(), horzIndex_.data(), horzWeights_.data(), horzTaps_, outWidth_, out);
+}
+template<typename T>
+bool Resampler::pushRow(const T* in, T* out)
+{
+	uint32_t y = inRow_++;
+	uint32_t outHeight = (uint32_t)vert_.first_.size();
+	bool rc = false;
+	while(outRow_ < outHeight && vert_.first_[outRow_] <= y)
+	{
+		uint32_t tap = y - vert_.first_[outRow_];
+		accumulate(in, vert_.weights_[vert_.offset_[outRow_] + tap]);
+		if(tap + 1 < vert_.taps_[outRow_])
+			break;
+		// input row completes output row: with downscaling, it completes at most
+		// one output row, but it may also be the first input row of the next one
+		filter(out);
+		std::fill(accum_.begin(), accum_.end(), 0.0f);
+		outRow_++;
+		rc = true;
+	}
+
+	return rc;
+}
+bool Resampler::push(const int32_t* in, int32_t* out)
+{
+	return pushRow<int32_t>(in, out);
+}
+bool Resampler::push(const float* in, float* out)
+{
+	return pushRow<float>(in, out);
+}
+
+} // namespace grk
+#endif
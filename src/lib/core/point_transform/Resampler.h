@@ -0,0 +1,86 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ *    This source code incorporates work covered by the BSD 2-clause license.
+ *    Please see the LICENSE file in the root directory for details.
+ *
+ */
+
+#pragma once
+#include <vector>
+
+namespace grk
+{
+/**
+ * Area filter taps for resampling a line of samples to a shorter line:
+ * each output sample is the average of the input samples it covers,
+ * weighted by how much of each input sample is covered
+ */
+struct AreaFilter
+{
+	AreaFilter(uint32_t inLen, uint32_t outLen);
+	uint32_t maxTaps(void) const;
+	std::vector<uint32_t> first_; // first input sample of each output sample
+	std::vector<uint32_t> taps_; // number of input samples of each output sample
+	std::vector<uint32_t> offset_; // offset of each output sample's weights
+	std::vector<float> weights_;
+};
+
+/**
+ * Area resampling of a plane to a smaller size, one input row at a time.
+ * Each input row is added to the output row it covers, and once the final
+ * input row covered by an output row has been added, the horizontal taps are
+ * applied and the output row is complete. Only one partial output row is carried
+ * from one input row to the next, so rows can be pushed as strips of the plane
+ * become available.
+ */
+class Resampler
+{
+  public:
+	Resampler(uint32_t inWidth, uint32_t inHeight, uint32_t outWidth, uint32_t outHeight);
+	/**
+	 * Add next input row
+	 *
+	 * @param in 	input row of inWidth samples
+	 * @param out 	output row of outWidth samples
+	 *
+	 * @return true if the input row completed the next output row, which is stored in out
+	 */
+	bool push(const int32_t* in, int32_t* out);
+	bool push(const float* in, float* out);
+
+  private:
+	template<typename T>
+	bool pushRow(const T* in, T* out);
+	void accumulate(const int32_t* in, float weight);
+	void accumulate(const float* in, float weight);
+	void filter(int32_t* out);
+	void filter(float* out);
+	AreaFilter vert_;
+	// horizontal taps, stored tap by tap for all output samples so that each
+	// tap of a run of output samples is a single gather: output samples with
+	// fewer taps repeat their final input sample with zero weight
+	std::vector<int32_t> horzIndex_;
+	std::vector<float> horzWeights_;
+	uint32_t horzTaps_;
+	uint32_t outWidth_;
+	// accumulated input rows of the current output row
+	std::vector<float> accum_;
+	uint32_t inRow_;
+	uint32_t outRow_;
+};
+
+} // namespace grk
@@ -33,7 +33,8 @@ namespace HWY_NAMESPACE
 	/**
 	 * Apply dc shift for irreversible decompressed image.
 	 * (assumes mono with no  MCT)
-	 * input is floating point, output is 32 bit integer
+	 * input is floating point, output is 32 bit integer, or floating point
+	 * if float output is enabled
 	 */
 	class DecompressDcShiftIrrev
 	{
@@ -48,14 +49,25 @@ namespace HWY_NAMESPACE
 			auto chan0 = (float*)highestResBuffer.buf_;
 			const HWY_FULL(int32_t) di;
 			const HWY_FULL(float) df;
-			auto vshift = Set(di, shiftInfo[0]._shift);
-			auto vmin = Set(di, shiftInfo[0]._min);
-			auto vmax = Set(di, shiftInfo[0]._max);
 			size_t begin = index;
-			for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
+			if(info.floatOutput)
+			{
+				auto vshift = Set(df, (float)shiftInfo[0]._shift);
+				auto vmin = Set(df, (float)shiftInfo[0]._min);
+				auto vmax = Set(df, (float)shiftInfo[0]._max);
+				for(auto j = begin; j < begin + chunkSize; j += Lanes(df))
+					Store(Clamp(Load(df, chan0 + j) + vshift, vmin, vmax), df, chan0 + j);
+			}
+			else
 			{
-				auto ni = Clamp(NearestInt(Load(df, chan0 + j)) + vshift, vmin, vmax);
-				Store(ni, di, (int32_t*)(chan0 + j));
+				auto vshift = Set(di, shiftInfo[0]._shift);
+				auto vmin = Set(di, shiftInfo[0]._min);
+				auto vmax = Set(di, shiftInfo[0]._max);
+				for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
+				{
+					auto ni = Clamp(NearestInt(Load(df, chan0 + j)) + vshift, vmin, vmax);
+					Store(ni, di, (int32_t*)(chan0 + j));
+				}
 			}
 			if(info.stripCache_->isInitialized() && !info.stripCache_->isMultiTile())
 				info.stripCache_->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin,
@@ -66,7 +78,8 @@ namespace HWY_NAMESPACE
 	/**
 	 * Apply dc shift for reversible decompressed image
 	 * (assumes mono with no MCT)
-	 * input and output buffers are both 32 bit integer
+	 * input and output buffers are both 32 bit integer, unless float output
+	 * is enabled, in which case output is floating point
 	 */
 	class DecompressDcShiftRev
 	{
@@ -81,6 +94,7 @@ namespace HWY_NAMESPACE
 			auto chan0 =
 				info.tile->comps[info.compno].getWindow()->getResWindowBufferHighestSimple().buf_;
 			const HWY_FULL(int32_t) di;
+			const HWY_FULL(float) df;
 			auto vshift = Set(di, shiftInfo[0]._shift);
 			auto vmin = Set(di, shiftInfo[0]._min);
 			auto vmax = Set(di, shiftInfo[0]._max);
@@ -88,7 +102,10 @@ namespace HWY_NAMESPACE
 			for(auto j = begin; j < begin + chunkSize; j += Lanes(di))
 			{
 				auto ni = Clamp(Load(di, chan0 + j) + vshift, vmin, vmax);
-				Store(ni, di, chan0 + j);
+				if(info.floatOutput)
+					Store(ConvertTo(df, ni), df, (float*)(chan0 + j));
+				else
+					Store(ni, di, chan0 + j);
 			}
 			if(info.stripCache_->isInitialized() && !info.stripCache_->isMultiTile())
 				info.stripCache_->ingestStrip(ExecSingleton::threadId(), info.tile, info.yBegin,
@@ -117,6 +134,7 @@ namespace HWY_NAMESPACE
 			int32_t _max[3] = {shiftInfo[0]._max, shiftInfo[1]._max, shiftInfo[2]._max};
 
 			const HWY_FULL(int32_t) di;
+			const HWY_FULL(float) df;
 			auto vdcr = Set(di, shift[0]);
 			auto vdcg = Set(di, shift[1]);
 			auto vdcb = Set(di, shift[2]);
@@ -136,9 +154,21 @@ namespace HWY_NAMESPACE
 				auto g = y - ShiftRight<2>(u + v);
 				auto r = v + g;
 				auto b = u + g;
-				Store(Clamp(r + vdcr, minr, maxr), di, chan0 + j);
-				Store(Clamp(g + vdcg, ming, maxg), di, chan1 + j);
-				Store(Clamp(b + vdcb, minb, maxb), di, chan2 + j);
+				r = Clamp(r + vdcr, minr, maxr);
+				g = Clamp(g + vdcg, ming, maxg);
+				b = Clamp(b + vdcb, minb, maxb);
+				if(info.floatOutput)
+				{
+					Store(ConvertTo(df, r), df, (float*)(chan0 + j));
+					Store(ConvertTo(df, g), df, (float*)(chan1 + j));
+					Store(ConvertTo(df, b), df, (float*)(chan2 + j));
+				}
+				else
+				{
+					Store(r, di, chan0 + j);
+					Store(g, di, chan1 + j);
+					Store(b, di, chan2 + j);
+				}
 			}
 		}
 	};
@@ -179,6 +209,15 @@ namespace HWY_NAMESPACE
 			auto maxr = Set(di, _max[0]);
 			auto maxg = Set(di, _max[1]);
 			auto maxb = Set(di, _max[2]);
+			auto vdcrf = ConvertTo(df, vdcr);
+			auto vdcgf = ConvertTo(df, vdcg);
+			auto vdcbf = ConvertTo(df, vdcb);
+			auto minrf = ConvertTo(df, minr);
+			auto mingf = ConvertTo(df, ming);
+			auto minbf = ConvertTo(df, minb);
+			auto maxrf = ConvertTo(df, maxr);
+			auto maxgf = ConvertTo(df, maxg);
+			auto maxbf = ConvertTo(df, maxb);
 
 			auto vrv = Set(df, 1.402f);
 			auto vgu = Set(df, 0.34413f);
@@ -195,9 +234,18 @@ namespace HWY_NAMESPACE
 				auto vg = vy - vu * vgu - vv * vgv;
 				auto vb = vy + vu * vbu;
 
-				Store(Clamp(NearestInt(vr) + vdcr, minr, maxr), di, c0 + j);
-				Store(Clamp(NearestInt(vg) + vdcg, ming, maxg), di, c1 + j);
-				Store(Clamp(NearestInt(vb) + vdcb, minb, maxb), di, c2 + j);
+				if(info.floatOutput)
+				{
+					Store(Clamp(vr + vdcrf, minrf, maxrf), df, chan0 + j);
+					Store(Clamp(vg + vdcgf, mingf, maxgf), df, chan1 + j);
+					Store(Clamp(vb + vdcbf, minbf, maxbf), df, chan2 + j);
+				}
+				else
+				{
+					Store(Clamp(NearestInt(vr) + vdcr, minr, maxr), di, c0 + j);
+					Store(Clamp(NearestInt(vg) + vdcg, ming, maxg), di, c1 + j);
+					Store(Clamp(NearestInt(vb) + vdcb, minb, maxb), di, c2 + j);
+				}
 			}
 		}
 	};
@@ -304,7 +352,7 @@ namespace HWY_NAMESPACE
 	{
 		auto highestResBuffer =
 			info.tile->comps[info.compno].getWindow()->getResWindowBufferHighestSimple();
-		if(ExecSingleton::get()->num_workers() > 1)
+		if(ExecSingleton::num_workers() > 1)
 		{
 			tf::Task* tasks = nullptr;
 			tf::Taskflow taskflow;
@@ -406,6 +454,7 @@ void mct::decompress_dc_shift_irrev(FlowComponent* flow, uint16_t compno)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
 	info.compno = compno;
+	info.floatOutput = image_->comps[compno].float_data;
 	genShift(compno, 1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_dc_shift_irrev)(info);
 }
@@ -416,6 +465,7 @@ void mct::decompress_dc_shift_rev(FlowComponent* flow, uint16_t compno)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
 	info.compno = compno;
+	info.floatOutput = image_->comps[compno].float_data;
 	genShift(compno, 1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_dc_shift_rev)(info);
 }
@@ -427,6 +477,7 @@ void mct::decompress_dc_shift_rev(FlowComponent* flow, uint16_t compno)
 void mct::decompress_irrev(FlowComponent* flow)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
+	info.floatOutput = image_->comps->float_data;
 	hwy::DisableTargets(uint32_t(~HWY_SCALAR));
 	genShift(1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_irrev)
@@ -439,6 +490,7 @@ void mct::decompress_irrev(FlowComponent* flow)
 void mct::decompress_rev(FlowComponent* flow)
 {
 	ScheduleInfo info(tile_, flow, stripCache_, image_->rowsPerTask);
+	info.floatOutput = image_->comps->float_data;
 	genShift(1, info.shiftInfo);
 	HWY_DYNAMIC_DISPATCH(hwy_decompress_rev)
 	(info);
@@ -37,7 +37,7 @@ struct ScheduleInfo
 {
 	ScheduleInfo(Tile* t, FlowComponent* flow, StripCache* stripCache, uint32_t linesPerTask)
 		: tile(t), compno(0), flow_(flow), linesPerTask_(linesPerTask), stripCache_(stripCache),
-		  yBegin(0), yEnd(0)
+		  yBegin(0), yEnd(0), floatOutput(false)
 	{}
 	Tile* tile;
 	uint16_t compno;
@@ -47,6 +47,8 @@ struct ScheduleInfo
 	StripCache* stripCache_;
 	uint32_t yBegin;
 	uint32_t yEnd;
+	// store floating point samples rather than rounded integers
+	bool floatOutput;
 };
 
 class mct
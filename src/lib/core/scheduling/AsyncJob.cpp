@@ -0,0 +1,124 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "grk_includes.h"
+
+namespace grk
+{
+AsyncJob::AsyncJob(void)
+	: codec_(nullptr), status_(GRK_ASYNC_NONE), result_(0), finished_(true)
+{
+	params_.callback = nullptr;
+	params_.user_data = nullptr;
+	params_.notify_fd = -1;
+}
+AsyncJob::~AsyncJob()
+{
+	wait(nullptr);
+}
+bool AsyncJob::launch(grk_codec* codec, grk_async_params* params,
+					  std::function<uint64_t(void)> job)
+{
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		if(!finished_)
+		{
+			GRK_ERROR("Asynchronous job already in flight for this codec");
+			return false;
+		}
+		codec_ = codec;
+		if(params)
+		{
+			params_ = *params;
+		}
+		else
+		{
+			params_.callback = nullptr;
+			params_.user_data = nullptr;
+			params_.notify_fd = -1;
+		}
+		status_ = GRK_ASYNC_PENDING;
+		result_ = 0;
+		finished_ = false;
+	}
+	AsyncExecSingleton::get()->silent_async([this, job] {
+		uint64_t result = 0;
+		try
+		{
+			result = job();
+		}
+		catch([[maybe_unused]] std::bad_alloc& ba)
+		{
+			GRK_ERROR("Out of memory");
+			result = 0;
+		}
+		complete(result);
+	});
+
+	return true;
+}
+void AsyncJob::complete(uint64_t result)
+{
+	grk_async_params params;
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		result_ = result;
+		status_ = result ? GRK_ASYNC_SUCCEEDED : GRK_ASYNC_FAILED;
+		params = params_;
+	}
+	if(params.callback)
+		params.callback(codec_, result != 0, result, params.user_data);
+	signal(params.notify_fd);
+	// notify while holding the lock: once a waiter sees finished_,
+	// it may destroy the codec, and this job with it
+	std::unique_lock<std::mutex> lk(mutex_);
+	finished_ = true;
+	finishedCondition_.notify_all();
+}
+void AsyncJob::signal([[maybe_unused]] int fd)
+{
+#ifndef _WIN32
+	if(fd < 0)
+		return;
+	// eventfd requires an 8 byte counter increment; pipes just need to become readable
+	uint64_t one = 1;
+	if(write(fd, &one, sizeof(one)) != (ssize_t)sizeof(one))
+		GRK_WARN("Unable to signal asynchronous completion on file descriptor %d", fd);
+#endif
+}
+GRK_ASYNC_STATUS AsyncJob::status(uint64_t* result)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	if(result && status_ != GRK_ASYNC_PENDING)
+		*result = result_;
+
+	return status_;
+}
+GRK_ASYNC_STATUS AsyncJob::wait(uint64_t* result)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	finishedCondition_.wait(lk, [this] { return finished_; });
+	if(result)
+		*result = result_;
+
+	return status_;
+}
+
+} // namespace grk
@@ -0,0 +1,75 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
+namespace grk
+{
+/**
+ * Asynchronous decompress or compress call for a single codec.
+ *
+ * At most one job is in flight per codec. On completion, the result is stored,
+ * then the completion callback is invoked and the notification file descriptor
+ * is signalled, and finally the job is marked as finished.
+ */
+class AsyncJob
+{
+  public:
+	AsyncJob(void);
+	/**
+	 * Waits for job in flight to finish
+	 */
+	~AsyncJob();
+	/**
+	 * Launch job on AsyncExecSingleton
+	 *
+	 * @param codec codec passed to completion callback
+	 * @param params completion parameters (may be null)
+	 * @param job job returning 0 for failure, otherwise success
+	 *
+	 * @return false if a job is already in flight
+	 */
+	bool launch(grk_codec* codec, grk_async_params* params, std::function<uint64_t(void)> job);
+	/**
+	 * Get job status without blocking
+	 *
+	 * @param result job result, stored if job is complete (may be null)
+	 */
+	GRK_ASYNC_STATUS status(uint64_t* result);
+	/**
+	 * Wait until job in flight has finished, including its completion notifications
+	 *
+	 * @param result job result (may be null)
+	 */
+	GRK_ASYNC_STATUS wait(uint64_t* result);
+
+  private:
+	void complete(uint64_t result);
+	static void signal(int fd);
+	grk_codec* codec_;
+	grk_async_params params_;
+	GRK_ASYNC_STATUS status_;
+	uint64_t result_;
+	bool finished_;
+	std::mutex mutex_;
+	std::condition_variable finishedCondition_;
+};
+
+} // namespace grk
@@ -20,9 +20,11 @@
 namespace grk
 {
 CompressScheduler::CompressScheduler(Tile* tile, bool needsRateControl, TileCodingParams* tcp,
-									 const double* mct_norms, uint16_t mct_numcomps)
-	: Scheduler(tile), tile(tile), needsRateControl(needsRateControl), encodeBlocks(nullptr),
-	  blockCount(-1), tcp_(tcp), mct_norms_(mct_norms), mct_numcomps_(mct_numcomps)
+									 const double* mct_norms, uint16_t mct_numcomps, Stats* stats,
+									 uint16_t tileIndex)
+	: Scheduler(tile, stats, tileIndex), tile(tile), needsRateControl(needsRateControl),
+	  encodeBlocks(nullptr), blockCount(-1), tcp_(tcp), mct_norms_(mct_norms),
+	  mct_numcomps_(mct_numcomps)
 {
 	for(uint16_t compno = 0; compno < numcomps_; ++compno)
 	{
@@ -91,7 +93,7 @@ bool CompressScheduler::scheduleBlocks(uint16_t compno)
 			}
 		}
 	}
-	for(auto i = 0U; i < ExecSingleton::get()->num_workers(); ++i)
+	for(auto i = 0U; i < ExecSingleton::num_workers(); ++i)
 		t1Implementations.push_back(T1Factory::makeT1(true, tcp_, maxCblkW, maxCblkH));
 	compress(&blocks);
 
@@ -103,7 +105,7 @@ void CompressScheduler::compress(std::vector<CompressBlockExec*>* blocks)
 	if(!blocks || blocks->size() == 0)
 		return;
 
-	size_t num_threads = ExecSingleton::get()->num_workers();
+	size_t num_threads = ExecSingleton::num_workers();
 	if(num_threads == 1)
 	{
 		auto impl = t1Implementations[0];
@@ -121,13 +123,15 @@ void CompressScheduler::compress(std::vector<CompressBlockExec*>* blocks)
 	blocks->clear();
 
 	tf::Taskflow taskflow;
-	auto numThreads = ExecSingleton::get()->num_workers();
+	auto numThreads = ExecSingleton::num_workers();
 	auto node = new tf::Task[numThreads];
 	for(uint64_t i = 0; i < numThreads; i++)
 		node[i] = taskflow.placeholder();
+	auto memAccount = MemAccount::current();
 	for(uint64_t i = 0; i < numThreads; i++)
 	{
-		node[i].work([this, maxBlocks] {
+		node[i].work([this, maxBlocks, memAccount] {
+			MemAccountScope memScope(memAccount);
 			auto threadnum = ExecSingleton::get()->this_worker_id();
 			while(compress((size_t)threadnum, maxBlocks))
 			{}
@@ -152,7 +156,13 @@ bool CompressScheduler::compress(size_t threadId, uint64_t maxBlocks)
 }
 void CompressScheduler::compress(T1Interface* impl, CompressBlockExec* block)
 {
+	ScopedSpan span(stats_, GRK_STAGE_T1, tileIndex_, (int8_t)block->resno);
 	block->open(impl);
+	if(stats_)
+	{
+		stats_->addCounter(GRK_COUNTER_BLOCKS, 1);
+		stats_->addCounter(GRK_COUNTER_PASSES, block->cblk->numPassesTotal);
+	}
 	if(needsRateControl)
 	{
 		std::unique_lock<std::mutex> lk(distortion_mutex);
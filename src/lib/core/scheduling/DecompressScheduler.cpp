@@ -37,9 +37,10 @@ void ResDecompressBlocks::release(void)
 
 DecompressScheduler::DecompressScheduler(TileProcessor* tileProcessor, Tile* tile,
 										 TileCodingParams* tcp, uint8_t prec)
-	: Scheduler(tile), tileProcessor_(tileProcessor), tcp_(tcp), prec_(prec),
+	: Scheduler(tile, tileProcessor->getStats(), tileProcessor->getIndex()),
+	  tileProcessor_(tileProcessor), tcp_(tcp), prec_(prec),
 	  numcomps_(tile->numcomps_), tileBlocks_(TileDecompressBlocks(numcomps_)),
-	  waveletReverse_(nullptr)
+	  waveletReverse_(nullptr), key_(genKey(tile, tcp, prec))
 {
 	waveletReverse_ = new WaveletReverse*[numcomps_];
 	for(uint16_t compno = 0; compno < numcomps_; ++compno)
@@ -54,6 +55,50 @@ DecompressScheduler::~DecompressScheduler()
 		delete[] waveletReverse_;
 	}
 }
+SchedulerKey DecompressScheduler::genKey(Tile* tile, TileCodingParams* tcp, uint8_t prec)
+{
+	SchedulerKey key;
+	key.push_back(tile->numcomps_);
+	key.push_back(prec);
+	key.push_back(tcp->mct);
+	key.push_back(tcp->isHT());
+	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+	{
+		auto tilec = tile->comps + compno;
+		auto tccp = tcp->tccps + compno;
+		key.push_back(tilec->width());
+		key.push_back(tilec->height());
+		key.push_back(tilec->highestResolutionDecompressed);
+		key.push_back(tilec->isWholeTileDecoding());
+		key.push_back(tccp->cblkw);
+		key.push_back(tccp->cblkh);
+		key.push_back(tccp->cblk_sty);
+		key.push_back(tccp->qmfbid);
+	}
+
+	return key;
+}
+const SchedulerKey& DecompressScheduler::getKey(void) const
+{
+	return key_;
+}
+void DecompressScheduler::rebind(TileProcessor* tileProcessor, Tile* tile, TileCodingParams* tcp)
+{
+	Scheduler::rebind(tile, tileProcessor->getStats(), tileProcessor->getIndex());
+	tileProcessor_ = tileProcessor;
+	tcp_ = tcp;
+}
+void DecompressScheduler::release(void)
+{
+	for(uint16_t compno = 0; compno < numcomps_; ++compno)
+	{
+		delete waveletReverse_[compno];
+		waveletReverse_[compno] = nullptr;
+		// blocks have already been deleted by their tasks
+		tileBlocks_[compno].clear();
+	}
+	rewind();
+}
 bool DecompressScheduler::schedule(uint16_t compno)
 {
 	auto tilec = tile_->comps + compno;
@@ -68,6 +113,9 @@ bool DecompressScheduler::schedule(uint16_t compno)
 		// generate dependency graph
 		graph(compno);
 	}
+	// coefficients are kept as they are when tile is transcoded
+	if(tileProcessor_->holdsCoefficients())
+		return true;
 	uint8_t numRes = tilec->highestResolutionDecompressed + 1U;
 	if(numRes > 0 && !scheduleWavelet(compno))
 	{
@@ -152,25 +200,31 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 		return true;
 
 	uint8_t numResolutions = (tile_->comps + compno)->highestResolutionDecompressed + 1;
-	imageComponentFlows_[compno] = new ImageComponentFlow(numResolutions);
+	// flow is kept if scheduler is reused
+	if(!imageComponentFlows_[compno])
+		imageComponentFlows_[compno] = new ImageComponentFlow(numResolutions);
+	imageComponentFlows_[compno]->instrument(stats_, tileIndex_);
 	if(!tile_->comps->isWholeTileDecoding())
 		imageComponentFlows_[compno]->setRegionDecompression();
 
 	// nominal code block dimensions
 	uint16_t codeblock_width = (uint16_t)(tccp->cblkw ? (uint32_t)1 << tccp->cblkw : 0);
 	uint16_t codeblock_height = (uint16_t)(tccp->cblkh ? (uint32_t)1 << tccp->cblkh : 0);
-	for(auto i = 0U; i < ExecSingleton::get()->num_workers(); ++i)
+	for(auto i = (uint32_t)t1Implementations.size(); i < ExecSingleton::num_workers(); ++i)
 		t1Implementations.push_back(
 			T1Factory::makeT1(false, tcp_, codeblock_width, codeblock_height));
 
-	size_t num_threads = ExecSingleton::get()->num_workers();
+	size_t num_threads = ExecSingleton::num_workers();
 	success = true;
+	auto control = tileProcessor_->getControl();
 	if(num_threads == 1)
 	{
 		for(auto& resBlocks : blocks)
 		{
 			for(auto& block : resBlocks.blocks_)
 			{
+				if(success && control->isCancelled())
+					success = false;
 				if(!success)
 				{
 					delete block;
@@ -192,7 +246,10 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 		auto resFlow = imageComponentFlows_[compno]->resFlows_ + resFlowNum;
 		for(auto& block : resBlocks.blocks_)
 		{
-			resFlow->blocks_->nextTask().work([this, block] {
+			resFlow->blocks_->nextTask().work([this, block, control] {
+				// once cancelled, remaining blocks are released without being decompressed
+				if(success && control->isCancelled())
+					success = false;
 				if(!success)
 				{
 					delete block;
@@ -216,10 +273,21 @@ bool DecompressScheduler::scheduleBlocks(uint16_t compno)
 }
 bool DecompressScheduler::decompressBlock(T1Interface* impl, DecompressBlockExec* block)
 {
+	ScopedSpan span(stats_, GRK_STAGE_T1, tileIndex_, (int8_t)block->resno);
+	if(stats_)
+	{
+		uint64_t numPasses = 0;
+		auto cblk = block->cblk;
+		for(uint32_t i = 0; i < cblk->getNumSegments(); ++i)
+			numPasses += cblk->getSegment(i)->numpasses;
+		stats_->addCounter(GRK_COUNTER_BLOCKS, 1);
+		stats_->addCounter(GRK_COUNTER_PASSES, numPasses);
+	}
 	try
 	{
 		bool rc = block->open(impl);
 		delete block;
+		tileProcessor_->getControl()->blockDone();
 		return rc;
 	}
 	catch(std::runtime_error& rerr)
@@ -239,6 +307,10 @@ bool DecompressScheduler::scheduleWavelet(uint16_t compno)
 	waveletReverse_[compno] =
 		new WaveletReverse(tileProcessor_, tilec, compno, tilec->getWindow()->unreducedBounds(),
 						   numRes, (tcp_->tccps + compno)->qmfbid);
+	// with a single thread, the wavelet transform runs synchronously here;
+	// otherwise, it is scheduled and its tasks are instrumented by the component flow
+	ScopedSpan span(ExecSingleton::num_workers() == 1 ? stats_ : nullptr, GRK_STAGE_DWT,
+					tileIndex_);
 
 	return waveletReverse_[compno]->decompress();
 }
@@ -42,6 +42,20 @@ class DecompressScheduler : public Scheduler
 	~DecompressScheduler();
 
 	bool schedule(uint16_t compno) override;
+	/**
+	 * Generate key for tile geometry and coding parameters:
+	 * tiles with equal keys can share a scheduler's task graph
+	 */
+	static SchedulerKey genKey(Tile* tile, TileCodingParams* tcp, uint8_t prec);
+	const SchedulerKey& getKey(void) const;
+	/**
+	 * Bind reused scheduler to a new tile
+	 */
+	void rebind(TileProcessor* tileProcessor, Tile* tile, TileCodingParams* tcp);
+	/**
+	 * Release per-tile state after a run, keeping task graph and T1 implementations
+	 */
+	void release(void);
 
   private:
 	bool scheduleBlocks(uint16_t compno);
@@ -54,6 +68,7 @@ class DecompressScheduler : public Scheduler
 	uint16_t numcomps_;
 	TileDecompressBlocks tileBlocks_;
 	WaveletReverse** waveletReverse_;
+	SchedulerKey key_;
 };
 
 } // namespace grk
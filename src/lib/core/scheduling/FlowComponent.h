@@ -17,12 +17,77 @@
 
 #pragma once
 
+/**
+ * Task proxy returned by FlowComponent::nextTask: wraps the task body in a span
+ * if the component is instrumented, and in the current memory account, if any
+ */
+class FlowTask
+{
+  public:
+	FlowTask(tf::Task& task, grk::Stats* stats, GRK_STAGE stage, uint16_t tileIndex, int8_t resno)
+		: task_(task), stats_(stats), stage_(stage), tileIndex_(tileIndex), resno_(resno)
+	{}
+	template<typename C>
+	tf::Task& work(C&& callable)
+	{
+		// memory account current at scheduling time is carried over to the task
+		auto memAccount = grk::MemAccount::current();
+		if(!stats_ && !memAccount)
+			return task_.work(std::forward<C>(callable));
+		auto stats = stats_;
+		auto stage = stage_;
+		auto tileIndex = tileIndex_;
+		auto resno = resno_;
+		return task_.work([stats, stage, tileIndex, resno, memAccount, callable]() {
+			grk::MemAccountScope memScope(memAccount);
+			grk::ScopedSpan span(stats, stage, tileIndex, resno);
+			callable();
+		});
+	}
+
+  private:
+	tf::Task& task_;
+	grk::Stats* stats_;
+	GRK_STAGE stage_;
+	uint16_t tileIndex_;
+	int8_t resno_;
+};
+
 class FlowComponent
 {
   public:
+	FlowComponent()
+		: nextTask_(0), composed_(false), stats_(nullptr), stage_(GRK_STAGE_TILE), tileIndex_(0),
+		  resno_(-1)
+	{}
+	/**
+	 * Record a span for every task in this component
+	 *
+	 * @param stats instrumentation (may be null)
+	 * @param stage stage
+	 * @param tileIndex tile index
+	 * @param resno resolution number, or -1 if not applicable
+	 */
+	FlowComponent* instrument(grk::Stats* stats, GRK_STAGE stage, uint16_t tileIndex,
+							  int8_t resno)
+	{
+		stats_ = stats;
+		stage_ = stage;
+		tileIndex_ = tileIndex;
+		resno_ = resno;
+		return this;
+	}
+	/**
+	 * Add component to composition. Idempotent, so that a component
+	 * can be re-wired when its flow is reused
+	 */
 	FlowComponent* addTo(tf::Taskflow& composition)
 	{
-		compositionTask_ = composition.composed_of(componentFlow_);
+		if(!composed_)
+		{
+			compositionTask_ = composition.composed_of(componentFlow_);
+			composed_ = true;
+		}
 		return this;
 	}
 	FlowComponent* precede(FlowComponent& successor)
@@ -32,7 +97,11 @@ class FlowComponent
 	FlowComponent* precede(FlowComponent* successor)
 	{
 		assert(successor);
-		compositionTask_.precede(successor->compositionTask_);
+		if(std::find(successors_.begin(), successors_.end(), successor) == successors_.end())
+		{
+			compositionTask_.precede(successor->compositionTask_);
+			successors_.push_back(successor);
+		}
 		return this;
 	}
 	FlowComponent* name(const std::string& name)
@@ -40,14 +109,37 @@ class FlowComponent
 		compositionTask_.name(name);
 		return this;
 	}
-	tf::Task& nextTask()
+	/**
+	 * Get next task. Tasks left over from a previous run are reused,
+	 * otherwise a new task is added to the component
+	 */
+	FlowTask nextTask()
+	{
+		if(nextTask_ == componentTasks_.size())
+			componentTasks_.push_back(componentFlow_.placeholder());
+		return FlowTask(componentTasks_[nextTask_++], stats_, stage_, tileIndex_, resno_);
+	}
+	/**
+	 * Prepare component for reuse: tasks are kept, but their work is released,
+	 * so that tasks which are not re-assigned by the next run do nothing
+	 */
+	void rewind(void)
 	{
-		componentTasks_.push(componentFlow_.placeholder());
-		return componentTasks_.back();
+		for(auto& t : componentTasks_)
+			t.work([]() {});
+		nextTask_ = 0;
 	}
 
   private:
-	std::queue<tf::Task> componentTasks_;
+	// deque, so that references to tasks stay valid as tasks are added
+	std::deque<tf::Task> componentTasks_;
+	size_t nextTask_;
 	tf::Taskflow componentFlow_;
 	tf::Task compositionTask_;
+	bool composed_;
+	std::vector<FlowComponent*> successors_;
+	grk::Stats* stats_;
+	GRK_STAGE stage_;
+	uint16_t tileIndex_;
+	int8_t resno_;
 };
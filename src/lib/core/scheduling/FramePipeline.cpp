@@ -0,0 +1,166 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "grk_includes.h"
+
+namespace grk
+{
+// room for main and tile part headers, on top of estimated compressed size
+const uint64_t pipelineHeaderBytes = 64 * 1024;
+
+FramePipeline::FramePipeline(grk_cparameters* parameters, uint32_t maxFramesInFlight,
+							 grk_pipeline_callback callback, void* userData)
+	: parameters_(*parameters), maxFramesInFlight_(maxFramesInFlight), callback_(callback),
+	  userData_(userData), nextFrameIndex_(0), delivering_(false), success_(true)
+{
+	if(!maxFramesInFlight_)
+		maxFramesInFlight_ = (uint32_t)std::max<size_t>(AsyncExecSingleton::get()->num_workers(), 1);
+	obj.wrapper = new GrkObjectWrapperImpl<FramePipeline>(this);
+}
+FramePipeline::~FramePipeline()
+{
+	flush();
+	for(auto& b : bufferPool_)
+		delete[] b.first;
+}
+bool FramePipeline::push(grk_image* image, void* userData)
+{
+	auto frame = new PipelineFrame();
+	frame->frame.image = image;
+	frame->frame.user_data = userData;
+	frame->frame.success = false;
+	frame->frame.data = nullptr;
+	frame->frame.len = 0;
+	frame->buf = nullptr;
+	frame->bufLen = 0;
+	frame->done = false;
+	grk_object_ref(&image->obj);
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		deliveredCondition_.wait(lk, [this] { return inFlight_.size() < maxFramesInFlight_; });
+		frame->frame.frame_index = nextFrameIndex_++;
+		inFlight_.push_back(frame);
+	}
+	AsyncExecSingleton::get()->silent_async([this, frame] {
+		compress(frame);
+		complete(frame);
+	});
+
+	return true;
+}
+bool FramePipeline::flush(void)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	deliveredCondition_.wait(lk, [this] { return inFlight_.empty() && !delivering_; });
+	bool rc = success_;
+	success_ = true;
+
+	return rc;
+}
+void FramePipeline::compress(PipelineFrame* frame)
+{
+	uint64_t len = 0;
+	try
+	{
+		size_t streamLen = bufferLength(frame->frame.image);
+		frame->buf = getBuffer(streamLen, &frame->bufLen);
+		// compressor adjusts parameters to suit image, so each frame gets its own copy
+		grk_cparameters parameters = parameters_;
+		grk_stream_params streamParams;
+		memset(&streamParams, 0, sizeof(streamParams));
+		streamParams.buf = frame->buf;
+		streamParams.len = streamLen;
+		auto codec = grk_compress_init(&streamParams, &parameters, frame->frame.image);
+		if(codec)
+		{
+			len = grk_compress(codec, nullptr);
+			grk_object_unref(codec);
+		}
+	}
+	catch([[maybe_unused]] std::bad_alloc& ba)
+	{
+		GRK_ERROR("Out of memory");
+		len = 0;
+	}
+	if(!len)
+		GRK_ERROR("Failed to compress frame %" PRIu64, frame->frame.frame_index);
+	frame->frame.success = len != 0;
+	frame->frame.data = len ? frame->buf : nullptr;
+	frame->frame.len = len;
+}
+void FramePipeline::complete(PipelineFrame* frame)
+{
+	std::unique_lock<std::mutex> lk(mutex_);
+	frame->done = true;
+	// thread currently delivering will pick up this frame when its turn comes
+	if(delivering_)
+		return;
+	delivering_ = true;
+	while(!inFlight_.empty() && inFlight_.front()->done)
+	{
+		auto oldest = inFlight_.front();
+		inFlight_.pop_front();
+		lk.unlock();
+		callback_(&oldest->frame, userData_);
+		grk_object_unref(&oldest->frame.image->obj);
+		lk.lock();
+		if(!oldest->frame.success)
+			success_ = false;
+		if(oldest->buf)
+			bufferPool_.push_back(std::make_pair(oldest->buf, oldest->bufLen));
+		delete oldest;
+		deliveredCondition_.notify_all();
+	}
+	delivering_ = false;
+	deliveredCondition_.notify_all();
+}
+size_t FramePipeline::bufferLength(grk_image* image)
+{
+	uint64_t imageBytes = 0;
+	for(uint16_t i = 0; i < image->numcomps; ++i)
+	{
+		auto comp = image->comps + i;
+		imageBytes += (uint64_t)comp->w * comp->h * ((comp->prec + 7U) / 8U);
+	}
+	uint64_t len = (imageBytes * 3U) / 2U + pipelineHeaderBytes;
+	// buffer length enforces size cap; memory stream needs one spare byte
+	if(parameters_.max_cs_size)
+		len = std::min<uint64_t>(len, parameters_.max_cs_size + 1);
+
+	return (size_t)len;
+}
+uint8_t* FramePipeline::getBuffer(size_t len, size_t* poolLen)
+{
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		for(auto it = bufferPool_.begin(); it != bufferPool_.end(); ++it)
+		{
+			if(it->second >= len)
+			{
+				auto buf = it->first;
+				*poolLen = it->second;
+				bufferPool_.erase(it);
+
+				return buf;
+			}
+		}
+	}
+	*poolLen = len;
+
+	return new uint8_t[len];
+}
+
+} // namespace grk
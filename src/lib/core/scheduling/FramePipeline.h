@@ -0,0 +1,98 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace grk
+{
+/**
+ * Compresses a sequence of frames with up to maxFramesInFlight frames in flight.
+ *
+ * Each frame runs as its own compress call on AsyncExecSingleton, so frames
+ * share the compute executor. Compressed frames are handed to the delivery
+ * callback strictly in submission order: whichever thread completes the
+ * oldest frame delivers it, along with any completed frames queued behind it.
+ * Output buffers are recycled from a pool once a frame has been delivered.
+ */
+class FramePipeline
+{
+  public:
+	FramePipeline(grk_cparameters* parameters, uint32_t maxFramesInFlight,
+				  grk_pipeline_callback callback, void* userData);
+	/**
+	 * Flushes pipeline
+	 */
+	~FramePipeline();
+	static FramePipeline* getImpl(grk_object* pipeline)
+	{
+		return ((GrkObjectWrapperImpl<FramePipeline>*)pipeline->wrapper)->getWrappee();
+	}
+	grk_object* getWrapper(void)
+	{
+		return &obj;
+	}
+	/**
+	 * Queue frame for compression, blocking while pipeline is full
+	 *
+	 * @param image frame image
+	 * @param userData frame user data
+	 *
+	 * @return true if frame was queued
+	 */
+	bool push(grk_image* image, void* userData);
+	/**
+	 * Wait until all queued frames have been delivered
+	 *
+	 * @return true if all frames delivered since previous flush succeeded
+	 */
+	bool flush(void);
+
+	grk_object obj;
+
+  private:
+	struct PipelineFrame
+	{
+		grk_pipeline_frame frame;
+		uint8_t* buf;
+		size_t bufLen;
+		bool done;
+	};
+	void compress(PipelineFrame* frame);
+	void complete(PipelineFrame* frame);
+	size_t bufferLength(grk_image* image);
+	uint8_t* getBuffer(size_t len, size_t* poolLen);
+
+	grk_cparameters parameters_;
+	uint32_t maxFramesInFlight_;
+	grk_pipeline_callback callback_;
+	void* userData_;
+	uint64_t nextFrameIndex_;
+	// frames in submission order, from oldest to newest
+	std::deque<PipelineFrame*> inFlight_;
+	bool delivering_;
+	bool success_;
+	// recycled output buffers
+	std::vector<std::pair<uint8_t*, size_t>> bufferPool_;
+	std::mutex mutex_;
+	std::condition_variable deliveredCondition_;
+};
+
+} // namespace grk
@@ -44,6 +44,14 @@ void ResFlow::graph(void)
 		waveletHoriz_->precede(waveletVert_);
 	}
 }
+void ResFlow::rewind(void)
+{
+	if(packets_)
+		packets_->rewind();
+	blocks_->rewind();
+	waveletHoriz_->rewind();
+	waveletVert_->rewind();
+}
 ResFlow* ResFlow::addTo(tf::Taskflow& composition)
 {
 	if(packets_)
@@ -89,7 +97,7 @@ ResFlow::~ResFlow(void)
 }
 ImageComponentFlow::ImageComponentFlow(uint8_t numResolutions)
 	: numResFlows_(numResolutions), resFlows_(nullptr), waveletFinalCopy_(nullptr),
-	  prePostProc_(nullptr)
+	  prePostProc_(nullptr), stats_(nullptr), tileIndex_(0)
 {
 	if(numResFlows_)
 	{
@@ -111,7 +119,29 @@ ImageComponentFlow::~ImageComponentFlow()
 }
 void ImageComponentFlow::setRegionDecompression(void)
 {
+	if(waveletFinalCopy_)
+		return;
 	waveletFinalCopy_ = new FlowComponent();
+	waveletFinalCopy_->instrument(stats_, GRK_STAGE_DWT, tileIndex_, -1);
+}
+ImageComponentFlow* ImageComponentFlow::instrument(Stats* stats, uint16_t tileIndex)
+{
+	stats_ = stats;
+	tileIndex_ = tileIndex;
+	// code blocks are instrumented individually, so only wavelet and
+	// post processing flows are instrumented here
+	for(uint8_t i = 0; i < numResFlows_; ++i)
+	{
+		auto resFlow = resFlows_ + i;
+		resFlow->waveletHoriz_->instrument(stats, GRK_STAGE_DWT, tileIndex, (int8_t)(i + 1));
+		resFlow->waveletVert_->instrument(stats, GRK_STAGE_DWT, tileIndex, (int8_t)(i + 1));
+	}
+	if(waveletFinalCopy_)
+		waveletFinalCopy_->instrument(stats, GRK_STAGE_DWT, tileIndex, -1);
+	if(prePostProc_)
+		prePostProc_->instrument(stats, GRK_STAGE_MCT, tileIndex, -1);
+
+	return this;
 }
 void ImageComponentFlow::graph(void)
 {
@@ -122,6 +152,15 @@ void ImageComponentFlow::graph(void)
 	if(waveletFinalCopy_)
 		(resFlows_ + numResFlows_ - 1)->precede(waveletFinalCopy_);
 }
+void ImageComponentFlow::rewind(void)
+{
+	for(uint8_t i = 0; i < numResFlows_; ++i)
+		(resFlows_ + i)->rewind();
+	if(waveletFinalCopy_)
+		waveletFinalCopy_->rewind();
+	if(prePostProc_)
+		prePostProc_->rewind();
+}
 FlowComponent* ImageComponentFlow::getFinalFlowT1(void)
 {
 	return waveletFinalCopy_ ? waveletFinalCopy_ : (resFlows_ + numResFlows_ - 1)->getFinalFlowT1();
@@ -144,6 +183,7 @@ FlowComponent* ImageComponentFlow::getPrePostProc(tf::Taskflow& codecFlow)
 	if(!prePostProc_)
 	{
 		prePostProc_ = new FlowComponent();
+		prePostProc_->instrument(stats_, GRK_STAGE_MCT, tileIndex_, -1);
 		prePostProc_->addTo(codecFlow);
 	}
 
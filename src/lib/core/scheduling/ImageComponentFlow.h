@@ -29,6 +29,7 @@ struct ResFlow
 	FlowComponent* getPacketsFlow(void);
 	void disableWavelet(void);
 	void graph(void);
+	void rewind(void);
 	ResFlow* addTo(tf::Taskflow& composition);
 	ResFlow* precede(ResFlow* successor);
 	ResFlow* precede(FlowComponent* successor);
@@ -49,14 +50,23 @@ class ImageComponentFlow
 	std::string genBlockFlowTaskName(uint8_t resFlowNo);
 	ResFlow* getResFlow(uint8_t resFlowNo);
 	void graph(void);
+	/**
+	 * Prepare flow for reuse by another tile with the same geometry
+	 */
+	void rewind(void);
 	ImageComponentFlow* addTo(tf::Taskflow& composition);
 	FlowComponent* getFinalFlowT1(void);
 	FlowComponent* getPrePostProc(tf::Taskflow& codecFlow);
+	ImageComponentFlow* instrument(Stats* stats, uint16_t tileIndex);
 
 	uint8_t numResFlows_;
 	ResFlow* resFlows_;
 	FlowComponent* waveletFinalCopy_;
 	FlowComponent* prePostProc_;
+
+  private:
+	Stats* stats_;
+	uint16_t tileIndex_;
 };
 
 } // namespace grk
@@ -18,8 +18,9 @@
 
 namespace grk
 {
-Scheduler::Scheduler(Tile* tile)
-	: success(true), tile_(tile), numcomps_(tile->numcomps_), prePostProc_(nullptr)
+Scheduler::Scheduler(Tile* tile, Stats* stats, uint16_t tileIndex)
+	: success(true), tile_(tile), numcomps_(tile->numcomps_), prePostProc_(nullptr),
+	  stats_(stats), tileIndex_(tileIndex)
 {
 	imageComponentFlows_ = new ImageComponentFlow*[numcomps_];
 	for(uint16_t compno = 0; compno < numcomps_; ++compno)
@@ -36,10 +37,33 @@ Scheduler::~Scheduler()
 }
 bool Scheduler::run(void)
 {
-	ExecSingleton::get()->run(codecFlow_).wait();
+	// inline: all work has already been done while scheduling
+	if(!ExecSingleton::isInline())
+		ExecSingleton::get()->run(codecFlow_).wait();
 
 	return success;
 }
+void Scheduler::rewind(void)
+{
+	for(uint16_t compno = 0; compno < numcomps_; ++compno)
+	{
+		if(imageComponentFlows_[compno])
+			imageComponentFlows_[compno]->rewind();
+	}
+	if(prePostProc_)
+		prePostProc_->rewind();
+	success = true;
+}
+void Scheduler::rebind(Tile* tile, Stats* stats, uint16_t tileIndex)
+{
+	assert(tile->numcomps_ == numcomps_);
+	tile_ = tile;
+	stats_ = stats;
+	tileIndex_ = tileIndex;
+	if(prePostProc_)
+		prePostProc_->instrument(stats_, GRK_STAGE_MCT, tileIndex_, -1);
+	success = true;
+}
 void Scheduler::graph(uint16_t compno)
 {
 	assert(compno < numcomps_);
@@ -59,6 +83,7 @@ FlowComponent* Scheduler::getPrePostProc(void)
 	if(!prePostProc_)
 	{
 		prePostProc_ = new FlowComponent();
+		prePostProc_->instrument(stats_, GRK_STAGE_MCT, tileIndex_, -1);
 		prePostProc_->addTo(codecFlow_);
 	}
 
@@ -21,7 +21,7 @@ namespace grk
 class Scheduler
 {
   public:
-	Scheduler(Tile* tile);
+	Scheduler(Tile* tile, Stats* stats, uint16_t tileIndex);
 	virtual ~Scheduler();
 
 	virtual bool schedule(uint16_t compno) = 0;
@@ -30,8 +30,13 @@ class Scheduler
 	ImageComponentFlow* getImageComponentFlow(uint16_t compno);
 	tf::Taskflow& getCodecFlow(void);
 	FlowComponent* getPrePostProc(void);
+	/**
+	 * Release work from all flows, keeping the task graph for reuse
+	 */
+	void rewind(void);
 
   protected:
+	void rebind(Tile* tile, Stats* stats, uint16_t tileIndex);
 	std::atomic_bool success;
 	std::vector<T1Interface*> t1Implementations;
 	ImageComponentFlow** imageComponentFlows_;
@@ -39,6 +44,9 @@ class Scheduler
 	Tile* tile_;
 	uint16_t numcomps_;
 	FlowComponent* prePostProc_;
+	// instrumentation (null if disabled)
+	Stats* stats_;
+	uint16_t tileIndex_;
 };
 
 } // namespace grk
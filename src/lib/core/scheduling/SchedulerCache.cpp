@@ -0,0 +1,67 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "grk_includes.h"
+
+namespace grk
+{
+// idle schedulers cached per worker thread
+const size_t maxIdleSchedulersPerWorker = 2;
+
+SchedulerCache::SchedulerCache(void) : numIdle_(0) {}
+SchedulerCache::~SchedulerCache(void)
+{
+	for(auto& kv : idle_)
+	{
+		for(auto& s : kv.second)
+			delete s;
+	}
+}
+DecompressScheduler* SchedulerCache::get(TileProcessor* tileProcessor, Tile* tile,
+										 TileCodingParams* tcp, uint8_t prec)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto iter = idle_.find(DecompressScheduler::genKey(tile, tcp, prec));
+		if(iter != idle_.end() && !iter->second.empty())
+		{
+			auto scheduler = iter->second.back();
+			iter->second.pop_back();
+			numIdle_--;
+			scheduler->rebind(tileProcessor, tile, tcp);
+
+			return scheduler;
+		}
+	}
+
+	return new DecompressScheduler(tileProcessor, tile, tcp, prec);
+}
+void SchedulerCache::put(DecompressScheduler* scheduler)
+{
+	if(!scheduler)
+		return;
+	scheduler->release();
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(numIdle_ >= maxIdleSchedulersPerWorker * ExecSingleton::get()->num_workers())
+	{
+		delete scheduler;
+		return;
+	}
+	idle_[scheduler->getKey()].push_back(scheduler);
+	numIdle_++;
+}
+
+} // namespace grk
@@ -0,0 +1,70 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+namespace grk
+{
+class DecompressScheduler;
+struct TileProcessor;
+struct Tile;
+struct TileCodingParams;
+
+/**
+ * Tile geometry and coding parameters that determine the shape of
+ * a decompress scheduler's task graph
+ */
+typedef std::vector<uint32_t> SchedulerKey;
+
+/**
+ * Cache of idle decompress schedulers, keyed by tile geometry and coding parameters.
+ *
+ * Building a scheduler's task graph (component, resolution and wavelet flows, and their
+ * dependencies) is redundant when many tiles share the same geometry. A scheduler
+ * is therefore returned to the cache after its run, with the graph intact and
+ * its per-tile work released, and handed to the next tile with a matching key, which
+ * then only binds its own work to the existing tasks.
+ */
+class SchedulerCache
+{
+  public:
+	SchedulerCache(void);
+	~SchedulerCache(void);
+	/**
+	 * Get scheduler for tile, reusing an idle scheduler if one matches
+	 *
+	 * @param tileProcessor tile processor
+	 * @param tile tile
+	 * @param tcp tile coding parameters
+	 * @param prec precision
+	 * @return DecompressScheduler
+	 */
+	DecompressScheduler* get(TileProcessor* tileProcessor, Tile* tile, TileCodingParams* tcp,
+							 uint8_t prec);
+	/**
+	 * Return scheduler to cache after a successful run
+	 *
+	 * @param scheduler scheduler
+	 */
+	void put(DecompressScheduler* scheduler);
+
+  private:
+	std::mutex mutex_;
+	std::map<SchedulerKey, std::vector<DecompressScheduler*>> idle_;
+	size_t numIdle_;
+};
+
+} // namespace grk
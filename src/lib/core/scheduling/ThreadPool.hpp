@@ -47,8 +47,66 @@ class ExecSingleton
 	{
 		get()->shutdown();
 	}
+	/**
+	 * Number of workers available to calling thread: 1 if calling thread
+	 * is running inline (see InlineExecScope), otherwise number of executor workers
+	 */
+	static uint32_t num_workers(void)
+	{
+		return inline_ ? 1 : (uint32_t)get()->num_workers();
+	}
+	static bool isInline(void)
+	{
+		return inline_;
+	}
 	static uint32_t threadId(void)
 	{
-		return get()->num_workers() > 1 ? (uint32_t)ExecSingleton::get()->this_worker_id() : 0;
+		return num_workers() > 1 ? (uint32_t)ExecSingleton::get()->this_worker_id() : 0;
+	}
+
+  private:
+	friend class InlineExecScope;
+	static inline thread_local bool inline_ = false;
+};
+
+/**
+ * RAII: run all work scheduled by calling thread inline on that thread,
+ * bypassing the executor, and restore previous mode on destruction.
+ * Every stage with a single worker does its work eagerly when it is scheduled,
+ * so there is no task graph to run.
+ */
+class InlineExecScope
+{
+  public:
+	explicit InlineExecScope(bool enable) : previous_(ExecSingleton::inline_)
+	{
+		if(enable)
+			ExecSingleton::inline_ = true;
+	}
+	~InlineExecScope()
+	{
+		ExecSingleton::inline_ = previous_;
+	}
+	InlineExecScope(const InlineExecScope&) = delete;
+	InlineExecScope& operator=(const InlineExecScope&) = delete;
+
+  private:
+	bool previous_;
+};
+
+/**
+ * Drives asynchronous decompress/compress calls. A driver thread blocks for the
+ * duration of a call, while the heavy lifting runs on ExecSingleton, so the
+ * two executors must never be the same.
+ * Calls beyond the number of driver threads are queued.
+ */
+class AsyncExecSingleton
+{
+  public:
+	static tf::Executor* get()
+	{
+		static tf::Executor singleton(ExecSingleton::get()->num_workers());
+
+		return &singleton;
 	}
 };
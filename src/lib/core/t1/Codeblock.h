@@ -65,7 +65,7 @@ struct Layer
 struct Codeblock : public grk_buf2d<int32_t, AllocatorAligned>, public ICacheable
 {
 	Codeblock(uint16_t numLayers)
-		: numbps(0), numlenbits(0)
+		: numbps(0), numlenbits(0), memTracker(GRK_MEM_CODEBLOCK)
 #ifdef DEBUG_LOSSLESS_T2
 		  ,
 		  included(false)
@@ -80,7 +80,7 @@ struct Codeblock : public grk_buf2d<int32_t, AllocatorAligned>, public ICacheabl
 	}
 	Codeblock(const Codeblock& rhs)
 		: grk_buf2d(rhs), numbps(rhs.numbps), numlenbits(rhs.numlenbits),
-		  numPassesInPacket(rhs.numPassesInPacket)
+		  memTracker(GRK_MEM_CODEBLOCK), numPassesInPacket(rhs.numPassesInPacket)
 #ifdef DEBUG_LOSSLESS_T2
 		  ,
 		  included(0)
@@ -111,9 +111,17 @@ struct Codeblock : public grk_buf2d<int32_t, AllocatorAligned>, public ICacheabl
 	{
 		(*(grk_rect32*)this) = r;
 	}
+	/**
+	 * Account for memory currently owned by code block
+	 */
+	void trackMem(void)
+	{
+		memTracker.set(ownedBytes() + (compressedStream.owns_data ? compressedStream.len : 0));
+	}
 	grk_buf8 compressedStream;
 	uint8_t numbps;
 	uint8_t numlenbits;
+	MemTracker memTracker;
 	uint8_t getNumPassesInPacket(uint16_t layno)
 	{
 		assert(layno < numPassesInPacket.size());
@@ -186,6 +194,7 @@ struct CompressCodeblock : public Codeblock
 		compressedStream.buf = buf;
 		compressedStream.len = desired_data_size;
 		compressedStream.owns_data = true;
+		memTracker.set(desired_data_size + grk_cblk_enc_compressed_data_pad_left);
 
 		return true;
 	}
@@ -280,6 +289,7 @@ struct DecompressCodeblock : public Codeblock
 		delete[] segs;
 		segs = nullptr;
 		grk_buf2d::dealloc();
+		memTracker.release();
 	}
 	std::vector<grk_buf8*> seg_buffers;
 
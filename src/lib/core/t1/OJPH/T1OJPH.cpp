@@ -32,10 +32,12 @@ T1OJPH::T1OJPH(bool isCompressor, [[maybe_unused]] grk::TileCodingParams* tcp, u
 	: coded_data_size(isCompressor ? 0 : (uint32_t)(maxCblkW * maxCblkH * sizeof(int32_t))),
 	  coded_data(isCompressor ? nullptr : new uint8_t[coded_data_size]),
 	  unencoded_data_size(maxCblkW * maxCblkH), unencoded_data(new int32_t[unencoded_data_size]),
-	  allocator(new mem_fixed_allocator), elastic_alloc(new mem_elastic_allocator(1048576))
+	  allocator(new mem_fixed_allocator), elastic_alloc(new mem_elastic_allocator(1048576)),
+	  mem_tracker(GRK_MEM_T1)
 {
 	if(!isCompressor)
 		memset(coded_data, 0, grk_cblk_dec_compressed_data_pad_ht);
+	mem_tracker.set(coded_data_size + unencoded_data_size * sizeof(int32_t));
 }
 T1OJPH::~T1OJPH()
 {
@@ -131,6 +133,7 @@ bool T1OJPH::decompress(grk::DecompressBlockExec* block)
 			delete[] coded_data;
 			coded_data = new uint8_t[total_seg_len];
 			coded_data_size = (uint32_t)total_seg_len;
+			mem_tracker.set(coded_data_size + unencoded_data_size * sizeof(int32_t));
 			memset(coded_data, 0, grk_cblk_dec_compressed_data_pad_ht);
 		}
 		memset(coded_data + grk_cblk_dec_compressed_data_pad_ht + cblk->getSegBuffersLen(), 0,
@@ -169,6 +172,7 @@ bool T1OJPH::decompress(grk::DecompressBlockExec* block)
 	}
 
 	block->tilec->postProcessHT(unencoded_data, block, stride);
+	cblk->cleanUpSegBuffers();
 
 	return true;
 }
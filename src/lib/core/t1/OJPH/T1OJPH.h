@@ -46,5 +46,7 @@ class T1OJPH : public grk::T1Interface
 
 	mem_fixed_allocator* allocator;
 	mem_elastic_allocator* elastic_alloc;
+	// memory accounting for coded_data and unencoded_data
+	grk::MemTracker mem_tracker;
 };
 } // namespace ojph
@@ -140,6 +140,7 @@ namespace t1_part1
 	{
 		auto cblk = block->cblk;
 		cblk->alloc2d(true);
+		cblk->trackMem();
 		t1->attachUncompressedData(cblk->getBuffer(), cblk->width(), cblk->height());
 		if(cblk->isClosed())
 		{
@@ -243,7 +243,8 @@ static const double dwt_norms_real[4][10] = {
 T1::T1(bool isCompressor, uint32_t maxCblkW, uint32_t maxCblkH)
 	: uncompressedData(nullptr), uncompressedDataLen(0), ownsUncompressedData(false), w(0), h(0),
 	  uncompressedDataStride(0), compressedData(nullptr), compressedDataLen(0), flags(nullptr),
-	  flagssize(0), compressor(isCompressor)
+	  flagssize(0), compressor(isCompressor), uncompressedDataMem(GRK_MEM_T1),
+	  compressedDataMem(GRK_MEM_T1), flagsMem(GRK_MEM_T1)
 {
 	memset(&coder, 0, sizeof(coder));
 	if(!isCompressor)
@@ -290,6 +291,7 @@ void T1::allocCompressedData(size_t len)
 	delete[] compressedData;
 	compressedData = new uint8_t[len];
 	compressedDataLen = len;
+	compressedDataMem.set(len);
 }
 int32_t* T1::getUncompressedData(void)
 {
@@ -313,6 +315,7 @@ bool T1::allocUncompressedData(size_t len)
 	}
 	ownsUncompressedData = true;
 	uncompressedDataLen = len;
+	uncompressedDataMem.set(len);
 
 	return true;
 }
@@ -322,6 +325,7 @@ void T1::deallocUncompressedData(void)
 		grk::grk_aligned_free(uncompressedData);
 	uncompressedData = nullptr;
 	ownsUncompressedData = false;
+	uncompressedDataMem.release();
 }
 void T1::attachUncompressedData(int32_t* data, uint32_t width, uint32_t height)
 {
@@ -361,9 +365,11 @@ bool T1::alloc(uint32_t width, uint32_t height)
 		flags = (grk_flag*)grk::grk_aligned_malloc(newflagssize * sizeof(grk_flag));
 		if(!flags)
 		{
+			flagsMem.release();
 			GRK_ERROR("Out of memory");
 			return false;
 		}
+		flagsMem.set(newflagssize * sizeof(grk_flag));
 	}
 	flagssize = newflagssize;
 	memset(flags, 0, newflagssize * sizeof(grk_flag));
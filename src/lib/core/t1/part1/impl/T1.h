@@ -73,6 +73,11 @@ struct T1
 	uint32_t flagssize;
 	bool compressor;
 
+	// memory accounting for uncompressedData (if owned), compressedData and flags
+	MemTracker uncompressedDataMem;
+	MemTracker compressedDataMem;
+	MemTracker flagsMem;
+
 	template<uint32_t w, uint32_t h, bool vsc>
 	void dec_clnpass(int32_t bpno);
 	void dec_clnpass(int32_t bpno, int32_t cblksty);
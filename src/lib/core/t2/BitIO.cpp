@@ -171,19 +171,6 @@ bool BitIO::putcommacode(uint8_t n)
 	return write(0);
 }
 
-uint8_t BitIO::getcommacode(void)
-{
-	uint8_t n = 0;
-	uint8_t temp = read();
-	while(temp)
-	{
-		n++;
-		temp = read();
-	}
-
-	return n;
-}
-
 bool BitIO::putnumpasses(uint32_t n)
 {
 	if(n == 1)
@@ -215,34 +202,4 @@ bool BitIO::putnumpasses(uint32_t n)
 	return true;
 }
 
-void BitIO::getnumpasses(uint32_t* numpasses)
-{
-	uint32_t n = read();
-	if(!n)
-	{
-		*numpasses = 1;
-		return;
-	}
-	n = read();
-	if(!n)
-	{
-		*numpasses = 2;
-		return;
-	}
-	read(&n, 2);
-	if(n != 3)
-	{
-		*numpasses = n + 3;
-		return;
-	}
-	read(&n, 5);
-	if(n != 31)
-	{
-		*numpasses = n + 6;
-		return;
-	}
-	read(&n, 7);
-	*numpasses = n + 37;
-}
-
 } // namespace grk
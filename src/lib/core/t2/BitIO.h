@@ -69,9 +69,7 @@ class BitIO : public IBitIO
 	void inalign(void) override;
 
 	bool putcommacode(uint8_t n);
-	uint8_t getcommacode(void);
 	bool putnumpasses(uint32_t n);
-	void getnumpasses(uint32_t* numpasses);
 
   private:
 	/* pointer to the start of the buffer */
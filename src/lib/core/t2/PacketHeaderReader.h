@@ -0,0 +1,274 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+namespace grk
+{
+/**
+ Packet header bit reader
+
+ Bits are served from a 64-bit register that is refilled a byte at a time, with bit
+ stuffing (only seven bits are taken from a byte that follows 0xFF) resolved
+ during refill, so that reads themselves are shifts and masks.
+ Errors match those of BitIO: a marker in the header, or running out of data,
+ is only reported once a read actually needs the offending bits.
+ */
+class PacketHeaderReader
+{
+  public:
+	PacketHeaderReader(const uint8_t* data, size_t len)
+		: data_(data), len_(len), pos_(0), reg_(0), bits_(0), stuffedBytes_(0), prevFF_(false),
+		  marker_(0), numBytes_(0)
+	{}
+	/**
+	 Read a single bit
+	 */
+	inline uint8_t read(void)
+	{
+		if(!bits_)
+			fill(1);
+		auto bit = (uint8_t)(reg_ >> 63);
+		consume(1);
+
+		return bit;
+	}
+	/**
+	 Read bits
+	 @param n number of bits to read (at most 32)
+	 */
+	inline uint32_t read(uint8_t n)
+	{
+		assert(n <= 32);
+		if(!n)
+			return 0;
+		if(bits_ < n)
+			fill(n);
+		auto val = (uint32_t)(reg_ >> (64 - n));
+		consume(n);
+
+		return val;
+	}
+	/**
+	 Read comma code i.e. run of ones terminated by a zero
+	 @return number of ones
+	 */
+	inline uint8_t readCommaCode(void)
+	{
+		uint32_t n = 0;
+		while(true)
+		{
+			if(!bits_)
+				fill(1);
+			// bits below bits_ are zero, so the run stops within the register
+			auto ones = (uint32_t)std::countl_one(reg_);
+			if(ones < bits_)
+			{
+				consume(ones + 1);
+				return (uint8_t)(n + ones);
+			}
+			n += bits_;
+			consume(bits_);
+		}
+	}
+	/**
+	 Read number of coding passes
+	 */
+	inline uint32_t readNumPasses(void)
+	{
+		if(bits_ < 16)
+			refill();
+		// longest code is 16 bits; shorter tails fall back to bitwise decoding
+		if(bits_ < 16)
+			return readNumPassesSlow();
+		auto code = (uint32_t)(reg_ >> 48);
+		if(!(code & 0x8000))
+		{
+			consume(1);
+			return 1;
+		}
+		if(!(code & 0x4000))
+		{
+			consume(2);
+			return 2;
+		}
+		uint32_t n = (code >> 12) & 0x3;
+		if(n != 3)
+		{
+			consume(4);
+			return n + 3;
+		}
+		n = (code >> 7) & 0x1F;
+		if(n != 31)
+		{
+			consume(9);
+			return n + 6;
+		}
+		consume(16);
+
+		return (code & 0x7F) + 37;
+	}
+	/**
+	 Read zeros until a one is read, or maxZeros zeros have been read.
+	 Used for tag tree descent.
+	 @param maxZeros maximum number of zeros to read
+	 @param one set to true if run was terminated by a one (which is consumed)
+	 @return number of zeros read
+	 */
+	inline uint32_t readZeros(uint32_t maxZeros, bool* one)
+	{
+		uint32_t n = 0;
+		*one = false;
+		while(n < maxZeros)
+		{
+			if(!bits_)
+				fill(1);
+			auto zeros = std::min<uint32_t>((uint32_t)std::countl_zero(reg_), bits_);
+			auto remaining = maxZeros - n;
+			if(zeros >= remaining)
+			{
+				consume(remaining);
+				return maxZeros;
+			}
+			n += zeros;
+			if(zeros < bits_)
+			{
+				consume(zeros + 1);
+				*one = true;
+				return n;
+			}
+			consume(zeros);
+		}
+
+		return n;
+	}
+	/**
+	 Skip remaining bits of current byte, as well as the stuffed byte that
+	 follows if current byte is 0xFF
+	 */
+	void inalign(void)
+	{
+		// count bytes in register that have not been touched, newest first
+		uint32_t unread = bits_;
+		uint32_t untouched = 0;
+		while(true)
+		{
+			uint32_t width = ((stuffedBytes_ >> untouched) & 1) ? 7 : 8;
+			if(unread < width)
+				break;
+			unread -= width;
+			untouched++;
+		}
+		auto consumed = pos_ - untouched;
+		if(consumed && data_[consumed - 1] == 0xFF)
+		{
+			if(consumed == len_)
+				throw TruncatedPacketHeaderException();
+			if(consumed > 1 && data_[consumed - 2] == 0xFF)
+			{
+				marker_ = 0xFFFF;
+				throwMarker();
+			}
+			consumed++;
+		}
+		numBytes_ = consumed;
+		reg_ = 0;
+		bits_ = 0;
+	}
+	/**
+	 Number of bytes read, valid after inalign
+	 */
+	size_t numBytes(void)
+	{
+		return numBytes_;
+	}
+
+  private:
+	inline void consume(uint32_t n)
+	{
+		assert(n <= bits_);
+		reg_ = n < 64 ? reg_ << n : 0;
+		bits_ -= n;
+	}
+	void refill(void)
+	{
+		// stop at end of data, or after a byte that completes a marker
+		while(bits_ <= 56 && pos_ < len_ && !marker_)
+		{
+			uint8_t byte = data_[pos_++];
+			uint32_t width = prevFF_ ? 7 : 8;
+			reg_ |= (uint64_t)(byte & (prevFF_ ? 0x7F : 0xFF)) << (64 - bits_ - width);
+			bits_ += width;
+			stuffedBytes_ = (stuffedBytes_ << 1) | (prevFF_ ? 1 : 0);
+			if(prevFF_ && byte >= 0x90)
+				marker_ = (uint16_t)(0xFF00 | byte);
+			prevFF_ = byte == 0xFF;
+		}
+	}
+	void fill(uint32_t n)
+	{
+		refill();
+		if(bits_ >= n)
+			return;
+		if(marker_)
+			throwMarker();
+		throw TruncatedPacketHeaderException();
+	}
+	void throwMarker(void)
+	{
+		if(marker_ != J2K_MS_EPH && marker_ != J2K_MS_SOP)
+			GRK_WARN("Invalid marker 0x%x detected in packet header", marker_);
+		else
+			GRK_WARN("Unexpected SOP/EPH marker 0x%x detected in packet header", marker_);
+
+		throw InvalidMarkerException(marker_);
+	}
+	uint32_t readNumPassesSlow(void)
+	{
+		if(!read())
+			return 1;
+		if(!read())
+			return 2;
+		uint32_t n = read(2);
+		if(n != 3)
+			return n + 3;
+		n = read(5);
+		if(n != 31)
+			return n + 6;
+
+		return read(7) + 37;
+	}
+
+	const uint8_t* data_;
+	size_t len_;
+	size_t pos_;
+	// unread bits, most significant first
+	uint64_t reg_;
+	// number of unread bits in register
+	uint32_t bits_;
+	// one bit per loaded byte, newest in least significant bit: set if byte was stuffed
+	uint32_t stuffedBytes_;
+	bool prevFF_;
+	// marker found in header: no more bytes are loaded after it
+	uint16_t marker_;
+	size_t numBytes_;
+};
+
+} // namespace grk
@@ -124,11 +124,11 @@ void PacketParser::readHeader(void)
 	if(*remainingBytes == 0)
 		throw TruncatedPacketHeaderException();
 	auto currentHeaderPtr = *headerStart;
-	std::unique_ptr<BitIO> bio(new BitIO(currentHeaderPtr, *remainingBytes, false));
+	PacketHeaderReader reader(currentHeaderPtr, *remainingBytes);
 	auto tccp = tcp->tccps + compno_;
 	try
 	{
-		tagBitsPresent_ = bio->read();
+		tagBitsPresent_ = reader.read();
 		// GRK_INFO("present=%u ", present);
 		if(tagBitsPresent_)
 		{
@@ -156,7 +156,7 @@ void PacketParser::readHeader(void)
 					{
 						uint16_t value;
 						auto incl = prc->getInclTree();
-						incl->decodeValue(bio.get(), cblkno, layno_ + 1, &value);
+						incl->decodeValue(&reader, cblkno, layno_ + 1, &value);
 						if(value != incl->getUninitializedValue() && value != layno_)
 						{
 							GRK_WARN("Tile number: %u", tileProcessor_->getIndex() + 1);
@@ -170,7 +170,7 @@ void PacketParser::readHeader(void)
 					}
 					else
 					{
-						included = bio->read();
+						included = reader.read();
 					}
 					if(!included)
 						continue;
@@ -184,7 +184,7 @@ void PacketParser::readHeader(void)
 
 						// see Taubman + Marcellin page 388
 						// loop below stops at (# of missing bit planes  + 1)
-						imsb->decodeValue(bio.get(), cblkno, K_msbs, &value);
+						imsb->decodeValue(&reader, cblkno, K_msbs, &value);
 						while(value >= K_msbs)
 						{
 							++K_msbs;
@@ -196,7 +196,7 @@ void PacketParser::readHeader(void)
 								headerError_ = true;
 								throw CorruptPacketHeaderException();
 							}
-							imsb->decodeValue(bio.get(), cblkno, K_msbs, &value);
+							imsb->decodeValue(&reader, cblkno, K_msbs, &value);
 						}
 						assert(K_msbs >= 1);
 						K_msbs--;
@@ -221,10 +221,9 @@ void PacketParser::readHeader(void)
 						}
 						cblk->numlenbits = 3;
 					}
-					uint32_t numPassesInPacket = 0;
-					bio->getnumpasses(&numPassesInPacket);
+					uint32_t numPassesInPacket = reader.readNumPasses();
 					cblk->setNumPassesInPacket(layno_, (uint8_t)numPassesInPacket);
-					uint8_t increment = bio->getcommacode();
+					uint8_t increment = reader.readCommaCode();
 					cblk->numlenbits += increment;
 					uint32_t segno = 0;
 					if(!cblk->getNumSegments())
@@ -270,7 +269,7 @@ void PacketParser::readHeader(void)
 							headerError_ = true;
 							throw CorruptPacketHeaderException();
 						}
-						bio->read(&seg->numBytesInPacket, bits_to_read);
+						seg->numBytesInPacket = reader.read(bits_to_read);
 						signalledDataBytes_ += seg->numBytesInPacket;
 #ifdef DEBUG_LOSSLESS_T2
 						cblk->packet_length_info.push_back(
@@ -284,8 +283,8 @@ void PacketParser::readHeader(void)
 				}
 			}
 		}
-		bio->inalign();
-		currentHeaderPtr += bio->numBytes();
+		reader.inalign();
+		currentHeaderPtr += reader.numBytes();
 	}
 	catch([[maybe_unused]] InvalidMarkerException& ex)
 	{
@@ -0,0 +1,123 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "grk_includes.h"
+
+namespace grk
+{
+// bound on number of distinct tile geometries cached
+const size_t maxCachedPacketSequences = 16;
+
+void PacketSequence::append(PacketIter* pi)
+{
+	while(pi->next(nullptr))
+		packets_.push_back(
+			{pi->getPrecinctIndex(), pi->getLayno(), pi->getCompno(), pi->getResno()});
+}
+/**
+ * Least common multiple of two periods, saturating once it exceeds canvas coordinates
+ */
+static uint64_t lcmPeriod(uint64_t a, uint64_t b)
+{
+	const uint64_t saturated = (uint64_t)UINT_MAX + 1;
+	if(a >= saturated || b >= saturated)
+		return saturated;
+
+	return std::min<uint64_t>(a / std::gcd(a, b) * b, saturated);
+}
+PacketSequenceKey PacketSequenceCache::genKey(TileProcessor* tileProcessor)
+{
+	auto cp = tileProcessor->cp_;
+	auto image = tileProcessor->headerImage;
+	auto tcp = tileProcessor->getTileCodingParams();
+	uint16_t tileIndex = tileProcessor->getIndex();
+	auto tileBounds = cp->getTileBounds(image, tileIndex % cp->t_grid_width,
+										tileIndex / cp->t_grid_width);
+	PacketSequenceKey key;
+	key.push_back(tcp->prg);
+	key.push_back(tcp->max_layers_);
+	key.push_back(tcp->numLayersToDecompress);
+	key.push_back(tileProcessor->getMaxNumDecompressResolutions());
+	key.push_back(tcp->numpocs);
+	if(tcp->hasPoc())
+	{
+		for(uint32_t pino = 0; pino < tcp->getNumProgressions(); ++pino)
+		{
+			auto poc = tcp->progressionOrderChange + pino;
+			key.push_back(poc->progression);
+			key.push_back(poc->layE);
+			key.push_back(poc->resS);
+			key.push_back(poc->resE);
+			key.push_back(poc->compS);
+			key.push_back(poc->compE);
+		}
+	}
+	// precinct grids of all components and resolutions repeat on the canvas
+	// with these periods
+	uint64_t periodX = 1;
+	uint64_t periodY = 1;
+	key.push_back(image->numcomps);
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		auto tccp = tcp->tccps + compno;
+		key.push_back(comp->dx);
+		key.push_back(comp->dy);
+		key.push_back(tccp->numresolutions);
+		for(uint8_t resno = 0; resno < tccp->numresolutions; ++resno)
+		{
+			uint32_t decompLevel = tccp->numresolutions - 1U - resno;
+			key.push_back(tccp->precWidthExp[resno]);
+			key.push_back(tccp->precHeightExp[resno]);
+			periodX = lcmPeriod(periodX, (uint64_t)comp->dx
+											 << (tccp->precWidthExp[resno] + decompLevel));
+			periodY = lcmPeriod(periodY, (uint64_t)comp->dy
+											 << (tccp->precHeightExp[resno] + decompLevel));
+		}
+	}
+	// translating a tile by a multiple of the periods leaves its packet order unchanged
+	key.push_back(tileBounds.width());
+	key.push_back(tileBounds.height());
+	key.push_back(tileBounds.x0 % periodX);
+	key.push_back(tileBounds.y0 % periodY);
+	// packet iterators take an optimized path for a tile at the canvas origin
+	key.push_back(tileBounds.x0 == 0 && tileBounds.y0 == 0);
+
+	return key;
+}
+std::shared_ptr<const PacketSequence> PacketSequenceCache::get(TileProcessor* tileProcessor)
+{
+	auto key = genKey(tileProcessor);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto iter = sequences_.find(key);
+		if(iter != sequences_.end())
+			return iter->second;
+	}
+	auto sequence = std::make_shared<PacketSequence>();
+	auto tcp = tileProcessor->getTileCodingParams();
+	PacketManager packetManager(false, tileProcessor->headerImage, tileProcessor->cp_,
+								tileProcessor->getIndex(), FINAL_PASS, tileProcessor);
+	for(uint32_t pino = 0; pino < tcp->getNumProgressions(); ++pino)
+		sequence->append(packetManager.getPacketIter(pino));
+	std::lock_guard<std::mutex> lock(mutex_);
+	if(sequences_.size() < maxCachedPacketSequences)
+		sequences_.emplace(key, sequence);
+
+	return sequence;
+}
+
+} // namespace grk
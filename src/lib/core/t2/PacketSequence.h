@@ -0,0 +1,97 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <memory>
+
+namespace grk
+{
+struct PacketIter;
+struct TileProcessor;
+
+/**
+ * Packet coordinates
+ */
+struct PacketId
+{
+	uint64_t precinctIndex;
+	uint16_t layno;
+	uint16_t compno;
+	uint8_t resno;
+};
+
+/**
+ * Packets of a tile, in the order produced by the tile's packet iterators.
+ *
+ * Iterating the progression is costly: every step re-evaluates the nested
+ * layer/resolution/component/precinct loops, precinct grid alignment and
+ * inclusion bitmaps. A sequence is generated once, and then iterated linearly.
+ */
+class PacketSequence
+{
+  public:
+	/**
+	 * Append all remaining packets of a packet iterator
+	 *
+	 * @param pi packet iterator
+	 */
+	void append(PacketIter* pi);
+	const PacketId* begin(void) const
+	{
+		return packets_.data();
+	}
+	const PacketId* end(void) const
+	{
+		return packets_.data() + packets_.size();
+	}
+	size_t size(void) const
+	{
+		return packets_.size();
+	}
+
+  private:
+	std::vector<PacketId> packets_;
+};
+
+/**
+ * Tile geometry and coding parameters that determine a tile's packet order
+ */
+typedef std::vector<uint64_t> PacketSequenceKey;
+
+/**
+ * Cache of decompress packet sequences, shared between tiles
+ * with matching geometry and coding parameters
+ */
+class PacketSequenceCache
+{
+  public:
+	/**
+	 * Get packet sequence for whole-tile decompression, generating
+	 * and caching it if no tile with the same key has been seen yet
+	 *
+	 * @param tileProcessor tile processor
+	 * @return packet sequence
+	 */
+	std::shared_ptr<const PacketSequence> get(TileProcessor* tileProcessor);
+
+  private:
+	static PacketSequenceKey genKey(TileProcessor* tileProcessor);
+	std::mutex mutex_;
+	std::map<PacketSequenceKey, std::shared_ptr<const PacketSequence>> sequences_;
+};
+
+} // namespace grk
@@ -22,8 +22,41 @@
 
 namespace grk
 {
-T2Compress::T2Compress(TileProcessor* tileProc) : tileProcessor(tileProc) {}
+T2Compress::T2Compress(TileProcessor* tileProc)
+	: tileProcessor(tileProc), simulationTilePartPosition_(0)
+{}
 
+bool T2Compress::generateSimulationSequences(uint16_t tile_no, uint32_t pocno, uint32_t max_comp,
+											 uint32_t newTilePartProgressionPosition)
+{
+	if(!simulationSequences_.empty() &&
+	   simulationTilePartPosition_ == newTilePartProgressionPosition)
+		return true;
+	simulationSequences_.clear();
+	simulationSequences_.resize((size_t)max_comp * pocno);
+	simulationTilePartPosition_ = newTilePartProgressionPosition;
+	PacketManager packetManager(true, tileProcessor->headerImage, tileProcessor->cp_, tile_no,
+								THRESH_CALC, tileProcessor);
+	for(uint16_t compno = 0; compno < max_comp; ++compno)
+	{
+		for(uint32_t poc = 0; poc < pocno; ++poc)
+		{
+			auto current_pi = packetManager.getPacketIter(poc);
+			packetManager.enableTilePartGeneration(poc, (compno == 0),
+												   newTilePartProgressionPosition);
+
+			if(current_pi->getProgression() == GRK_PROG_UNKNOWN)
+			{
+				GRK_ERROR("decompress_packets_simulate: Unknown progression order");
+				simulationSequences_.clear();
+				return false;
+			}
+			simulationSequences_[compno * pocno + poc].append(current_pi);
+		}
+	}
+
+	return true;
+}
 bool T2Compress::compressPacketsSimulate(uint16_t tile_no, uint16_t max_layers,
 										 uint32_t* allPacketBytes, uint32_t maxBytes,
 										 uint32_t newTilePartProgressionPosition,
@@ -40,7 +73,8 @@ bool T2Compress::compressPacketsSimulate(uint16_t tile_no, uint16_t max_layers,
 	// each component length meets spec. Otherwise, set to 1.
 	uint32_t max_comp = cp->coding_params_.enc_.max_comp_size_ > 0 ? image->numcomps : 1;
 
-	PacketManager packetManager(true, image, cp, tile_no, THRESH_CALC, tileProcessor);
+	if(!generateSimulationSequences(tile_no, pocno, max_comp, newTilePartProgressionPosition))
+		return false;
 	*allPacketBytes = 0;
 	tileProcessor->getPacketTracker()->clear();
 	if(markers)
@@ -50,21 +84,12 @@ bool T2Compress::compressPacketsSimulate(uint16_t tile_no, uint16_t max_layers,
 		uint64_t componentBytes = 0;
 		for(uint32_t poc = 0; poc < pocno; ++poc)
 		{
-			auto current_pi = packetManager.getPacketIter(poc);
-			packetManager.enableTilePartGeneration(poc, (compno == 0),
-												   newTilePartProgressionPosition);
-
-			if(current_pi->getProgression() == GRK_PROG_UNKNOWN)
-			{
-				GRK_ERROR("decompress_packets_simulate: Unknown progression order");
-				return false;
-			}
-			while(current_pi->next(nullptr))
+			for(auto& packet : simulationSequences_[compno * pocno + poc])
 			{
-				if(current_pi->getLayno() < max_layers)
+				if(packet.layno < max_layers)
 				{
 					uint32_t bytesInPacket = 0;
-					if(!compressPacketSimulate(tcp, current_pi, &bytesInPacket, maxBytes, markers,
+					if(!compressPacketSimulate(tcp, packet, &bytesInPacket, maxBytes, markers,
 											   debug))
 						return false;
 
@@ -82,15 +107,15 @@ bool T2Compress::compressPacketsSimulate(uint16_t tile_no, uint16_t max_layers,
 
 	return true;
 }
-bool T2Compress::compressPacketSimulate(TileCodingParams* tcp, PacketIter* pi,
+bool T2Compress::compressPacketSimulate(TileCodingParams* tcp, const PacketId& packet,
 										uint32_t* packet_bytes_written,
 										uint32_t max_bytes_available, PLMarkerMgr* markers,
 										[[maybe_unused]] bool debug)
 {
-	uint16_t compno = pi->getCompno();
-	uint32_t resno = pi->getResno();
-	uint64_t precinctIndex = pi->getPrecinctIndex();
-	uint16_t layno = pi->getLayno();
+	uint16_t compno = packet.compno;
+	uint32_t resno = packet.resno;
+	uint64_t precinctIndex = packet.precinctIndex;
+	uint16_t layno = packet.layno;
 	uint64_t nb_blocks;
 	auto tile = tileProcessor->getTile();
 	auto tilec = tile->comps + compno;
@@ -194,8 +219,10 @@ bool T2Compress::compressPackets(uint16_t tile_no, uint16_t max_layers, Buffered
 	{
 		if(current_pi->getLayno() < max_layers)
 		{
+			PacketId packet = {current_pi->getPrecinctIndex(), current_pi->getLayno(),
+							   current_pi->getCompno(), current_pi->getResno()};
 			uint32_t numBytes = 0;
-			if(!compressPacket(tcp, current_pi, stream, &numBytes))
+			if(!compressPacket(tcp, packet, stream, &numBytes))
 				return false;
 			*tileBytesWritten += numBytes;
 			tileProcessor->incNumProcessedPackets(1);
@@ -342,15 +369,15 @@ bool T2Compress::compressHeader(BitIO* bio, Resolution* res, uint16_t layno, uin
 
 	return true;
 }
-bool T2Compress::compressPacket(TileCodingParams* tcp, PacketIter* pi, BufferedStream* stream,
-								uint32_t* packet_bytes_written)
+bool T2Compress::compressPacket(TileCodingParams* tcp, const PacketId& packet,
+								BufferedStream* stream, uint32_t* packet_bytes_written)
 {
 	assert(stream);
 
-	uint16_t compno = pi->getCompno();
-	uint32_t resno = pi->getResno();
-	uint64_t precinctIndex = pi->getPrecinctIndex();
-	uint16_t layno = pi->getLayno();
+	uint16_t compno = packet.compno;
+	uint32_t resno = packet.resno;
+	uint64_t precinctIndex = packet.precinctIndex;
+	uint16_t layno = packet.layno;
 	auto tile = tileProcessor->getTile();
 	auto tilec = tile->comps + compno;
 	size_t stream_start = stream->tell();
@@ -62,28 +62,43 @@ struct T2Compress
   private:
 	TileProcessor* tileProcessor;
 
+	/**
+	 Generate the packet sequences iterated by compressPacketsSimulate, one per
+	 component/progression pair. Rate allocation simulates the same tile many times,
+	 so the sequences are kept for the lifetime of this object.
+	 @param tileno           number of the tile encoded
+	 @param pocno            number of progression order changes
+	 @param max_comp         number of components tracked separately
+	 @param tppos            position of the tile part flag in the progression order
+	 */
+	bool generateSimulationSequences(uint16_t tileno, uint32_t pocno, uint32_t max_comp,
+									 uint32_t tppos);
+	std::vector<PacketSequence> simulationSequences_;
+	uint32_t simulationTilePartPosition_;
+
 	/**
 	 Encode a packet of a tile to a destination buffer
 	 @param tcp 			Tile coding parameters
-	 @param pi 				packet iterator
+	 @param packet 			packet
 	 @param stream 			stream
 	 @param p_data_written  amount of data written
 	 @return
 	 */
-	bool compressPacket(TileCodingParams* tcp, PacketIter* pi, BufferedStream* stream,
+	bool compressPacket(TileCodingParams* tcp, const PacketId& packet, BufferedStream* stream,
 						uint32_t* p_data_written);
 
 	/**
 	 Encode a packet of a tile to a destination buffer
 	 @param tcp 			Tile coding parameters
-	 @param pi 				packet iterator
+	 @param packet 			packet
 	 @param p_data_written  amount of data written
 	 @param len 			length of the destination buffer
 	 @param markers			packet length markers
 	 @return
 	 */
-	bool compressPacketSimulate(TileCodingParams* tcp, PacketIter* pi, uint32_t* p_data_written,
-								uint32_t len, PLMarkerMgr* markers, bool debug);
+	bool compressPacketSimulate(TileCodingParams* tcp, const PacketId& packet,
+								uint32_t* p_data_written, uint32_t len, PLMarkerMgr* markers,
+								bool debug);
 
 	bool compressHeader(BitIO* bio, Resolution* res, uint16_t layno, uint64_t precinctIndex);
 };
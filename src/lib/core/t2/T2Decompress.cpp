@@ -22,7 +22,19 @@
 
 namespace grk
 {
-T2Decompress::T2Decompress(TileProcessor* tileProc) : tileProcessor(tileProc) {}
+T2Decompress::T2Decompress(TileProcessor* tileProc)
+	: tileProcessor(tileProc), scannedPackets_(nullptr)
+{}
+bool T2Decompress::scanPackets(uint16_t tile_no, SparseBuffer* src,
+							   std::vector<PacketSpan>* packets)
+{
+	bool stop = false;
+	scannedPackets_ = packets;
+	decompressPackets(tile_no, src, &stop);
+	scannedPackets_ = nullptr;
+
+	return !stop;
+}
 
 void T2Decompress::decompressPackets(uint16_t tile_no, SparseBuffer* src,
 									 bool* stopProcessionPackets)
@@ -30,67 +42,78 @@ void T2Decompress::decompressPackets(uint16_t tile_no, SparseBuffer* src,
 	auto cp = tileProcessor->cp_;
 	auto tcp = tileProcessor->getTileCodingParams();
 	*stopProcessionPackets = false;
-	PacketManager packetManager(false, tileProcessor->headerImage, cp, tile_no, FINAL_PASS,
-								tileProcessor);
 	tileProcessor->packetLengthCache.rewind();
 	auto markers = tileProcessor->packetLengthCache.getMarkers();
 	if(markers && !markers->isEnabled())
 		markers = nullptr;
-	for(uint32_t pino = 0; pino < tcp->getNumProgressions(); ++pino)
+	if(cp->wholeTileDecompress_)
 	{
-		auto currPi = packetManager.getPacketIter(pino);
-		while(currPi->next(markers ? src : nullptr))
+		// all packets are visited, in an order shared by tiles of the same geometry
+		auto sequence = tileProcessor->getPacketSequenceCache()->get(tileProcessor);
+		for(auto& packet : *sequence)
 		{
-			if(src->getCurrentChunkLength() == 0)
+			if(!readPacket(tile_no, packet, src))
 			{
-				GRK_WARN("Tile %u is truncated.", tile_no);
 				*stopProcessionPackets = true;
 				break;
 			}
-			try
-			{
-				if(!processPacket(currPi->getCompno(), currPi->getResno(),
-								  currPi->getPrecinctIndex(), currPi->getLayno(), src))
-				{
-					*stopProcessionPackets = true;
-					break;
-				}
-			}
-			catch([[maybe_unused]] TruncatedPacketHeaderException& tex)
+		}
+		return;
+	}
+	// packet iterators skip packets outside of decompress window
+	PacketManager packetManager(false, tileProcessor->headerImage, cp, tile_no, FINAL_PASS,
+								tileProcessor);
+	for(uint32_t pino = 0; pino < tcp->getNumProgressions(); ++pino)
+	{
+		auto currPi = packetManager.getPacketIter(pino);
+		while(currPi->next(markers ? src : nullptr))
+		{
+			PacketId packet = {currPi->getPrecinctIndex(), currPi->getLayno(),
+							   currPi->getCompno(), currPi->getResno()};
+			if(!readPacket(tile_no, packet, src))
 			{
-				GRK_WARN("Truncated packet: tile=%u component=%02d resolution=%02d precinct=%03d "
-						 "layer=%02d",
-						 tile_no, currPi->getCompno(), currPi->getResno(),
-						 currPi->getPrecinctIndex(), currPi->getLayno());
 				*stopProcessionPackets = true;
 				break;
 			}
-			catch([[maybe_unused]] CorruptPacketException& cex)
-			{
-				// we can skip corrupt packet if PLT markers are present
-				if(!tileProcessor->packetLengthCache.getMarkers())
-				{
-					GRK_WARN("Corrupt packet: tile=%u component=%02d resolution=%02d precinct=%03d "
-							 "layer=%02d",
-							 tile_no, currPi->getCompno(), currPi->getResno(),
-							 currPi->getPrecinctIndex(), currPi->getLayno());
-					*stopProcessionPackets = true;
-					break;
-				}
-				else
-				{
-					GRK_WARN("Corrupt packet: tile=%u component=%02d resolution=%02d precinct=%03d "
-							 "layer=%02d",
-							 tile_no, currPi->getCompno(), currPi->getResno(),
-							 currPi->getPrecinctIndex(), currPi->getLayno());
-				}
-				// ToDo: skip corrupt packet if SOP marker is present
-			}
 		}
 		if(*stopProcessionPackets)
 			break;
 	}
 }
+bool T2Decompress::readPacket(uint16_t tile_no, const PacketId& packet, SparseBuffer* src)
+{
+	if(tileProcessor->getControl()->isCancelled())
+		return false;
+	if(src->getCurrentChunkLength() == 0)
+	{
+		GRK_WARN("Tile %u is truncated.", tile_no);
+		return false;
+	}
+	try
+	{
+		if(!processPacket(packet.compno, packet.resno, packet.precinctIndex, packet.layno, src))
+			return false;
+	}
+	catch([[maybe_unused]] TruncatedPacketHeaderException& tex)
+	{
+		GRK_WARN("Truncated packet: tile=%u component=%02d resolution=%02d precinct=%03d "
+				 "layer=%02d",
+				 tile_no, packet.compno, packet.resno, packet.precinctIndex, packet.layno);
+		return false;
+	}
+	catch([[maybe_unused]] CorruptPacketException& cex)
+	{
+		GRK_WARN("Corrupt packet: tile=%u component=%02d resolution=%02d precinct=%03d "
+				 "layer=%02d",
+				 tile_no, packet.compno, packet.resno, packet.precinctIndex, packet.layno);
+		// we can skip corrupt packet if PLT markers are present
+		// ToDo: skip corrupt packet if SOP marker is present
+		if(!tileProcessor->packetLengthCache.getMarkers())
+			return false;
+	}
+
+	return true;
+}
 
 bool T2Decompress::processPacket(uint16_t compno, uint8_t resno, uint64_t precinctIndex,
 								 uint16_t layno, SparseBuffer* src)
@@ -103,7 +126,8 @@ bool T2Decompress::processPacket(uint16_t compno, uint8_t resno, uint64_t precin
 	auto tilec = tileProcessor->getTile()->comps + compno;
 	auto res = tilec->resolutions_ + resno;
 	auto tcp = tileProcessor->getTileCodingParams();
-	auto skip = layno >= tcp->numLayersToDecompress || resno >= tilec->numResolutionsToDecompress;
+	auto skip = scannedPackets_ || layno >= tcp->numLayersToDecompress ||
+				resno >= tilec->numResolutionsToDecompress;
 	if(!skip && !tilec->isWholeTileDecoding())
 	{
 		skip = true;
@@ -153,6 +177,19 @@ bool T2Decompress::processPacket(uint16_t compno, uint8_t resno, uint64_t precin
 		}
 		packetLen = parser->numHeaderBytes() + parser->numSignalledDataBytes();
 	}
+	if(scannedPackets_)
+	{
+		// packets may not straddle tile parts
+		if(packetLen > src->getCurrentChunkLength())
+		{
+			GRK_ERROR("Packet length %u exceeds remaining tile part length %u", packetLen,
+					  (uint32_t)src->getCurrentChunkLength());
+			delete parser;
+			return false;
+		}
+		scannedPackets_->push_back(
+			{{precinctIndex, layno, compno, resno}, src->getCurrentChunkPtr(), packetLen});
+	}
 	try
 	{
 		src->incrementCurrentChunkOffset(packetLen);
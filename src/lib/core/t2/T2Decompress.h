@@ -22,6 +22,16 @@ namespace grk
 {
 struct TileProcessor;
 
+/**
+ * Location of a packet in compressed tile data
+ */
+struct PacketSpan
+{
+	PacketId id;
+	const uint8_t* data;
+	uint32_t len;
+};
+
 /**
  Tier-2 decoding
  */
@@ -30,10 +40,26 @@ struct T2Decompress
 	T2Decompress(TileProcessor* tileProc);
 	virtual ~T2Decompress(void) = default;
 	void decompressPackets(uint16_t tileno, SparseBuffer* src, bool* truncated);
+	/**
+	 Locate all packets of a tile, reading packet headers (unless packet lengths
+	 are signalled by PLT/PLM markers), but not packet data
+	 @param tileno  tile index
+	 @param src     compressed tile data
+	 @param packets receives packet locations, in code stream order
+	 @return true if all packets of the tile were located
+	 */
+	bool scanPackets(uint16_t tileno, SparseBuffer* src, std::vector<PacketSpan>* packets);
 
   private:
 	TileProcessor* tileProcessor;
+	// packet locations collected by scanPackets, otherwise null
+	std::vector<PacketSpan>* scannedPackets_;
 	void decompressPacket(PacketParser* parser, bool skipData);
+	/**
+	 Read packet, reporting truncated and corrupt packets
+	 @return false if packet processing must stop
+	 */
+	bool readPacket(uint16_t tileno, const PacketId& packet, SparseBuffer* src);
 	bool processPacket(uint16_t compno, uint8_t resno, uint64_t precinctIndex, uint16_t layno,
 					   SparseBuffer* src);
 	void readPacketData(Resolution* res, PacketParser* parser, uint64_t precinctIndex, bool defer);
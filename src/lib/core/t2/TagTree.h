@@ -205,12 +205,12 @@ class TagTree
 	}
 	/**
 	 Decompress the value of a leaf of the tag tree up to a given threshold
-	 @param bio Pointer to a BIO handle
+	 @param reader packet header reader
 	 @param leafno Number that identifies the leaf to decompress
 	 @param threshold Threshold to use when decoding value of the leaf
 	 @param value the node's value
 	 */
-	void decodeValue(BitIO* bio, uint64_t leafno, T threshold, T* value)
+	void decodeValue(PacketHeaderReader* reader, uint64_t leafno, T threshold, T* value)
 	{
 		TagTreeNode<T>* nodeStack[31];
 		*value = getUninitializedValue();
@@ -230,14 +230,14 @@ class TagTree
 				node->low = low;
 			else
 				low = node->low;
-			while(low < threshold && low < node->value)
+			// zeros raise the lower bound, and a one fixes the node's value
+			T limit = std::min<T>(threshold, node->value);
+			if(low < limit)
 			{
-				if(bio->read())
-				{
+				bool one;
+				low = (T)(low + reader->readZeros((uint32_t)(limit - low), &one));
+				if(one)
 					node->value = low;
-					break;
-				}
-				low++;
 			}
 			node->low = low;
 			if(nodeStackPtr == nodeStack)
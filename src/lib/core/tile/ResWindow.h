@@ -70,7 +70,7 @@ struct ResWindow
 {
 	friend struct TileComponentWindowBase<T>;
 	friend struct TileComponentWindow<T>;
-	typedef grk_buf2d<T, AllocatorAligned> Buf2dAligned;
+	typedef grk_buf2d<T, AllocatorPooled> Buf2dAligned;
 
   private:
 	ResWindow(uint8_t numresolutions, uint8_t resno, Buf2dAligned* resWindowHighestResREL,
@@ -384,6 +384,27 @@ struct ResWindow
 	{
 		return resWindowBufferREL_;
 	}
+	/**
+	 * Get number of bytes allocated by this window's buffers
+	 * (buffers attached to other windows are not included)
+	 */
+	uint64_t allocatedBytes(void) const
+	{
+		uint64_t bytes = resWindowBufferREL_->ownedBytes() + resWindowBuffer_->ownedBytes();
+		for(uint32_t i = 0; i < SPLIT_NUM_ORIENTATIONS; ++i)
+		{
+			if(resWindowBufferSplitREL_[i])
+				bytes += resWindowBufferSplitREL_[i]->ownedBytes();
+			if(resWindowBufferSplit_[i])
+				bytes += resWindowBufferSplit_[i]->ownedBytes();
+		}
+		for(auto& b : bandWindowsBuffersPaddedREL_)
+			bytes += b->ownedBytes();
+		for(auto& b : bandWindowsBuffersPadded_)
+			bytes += b->ownedBytes();
+
+		return bytes;
+	}
 	bool allocated_;
 	uint32_t filterWidth_;
 
@@ -57,11 +57,13 @@ struct SparseBlock
 	SparseBlock(void) : data(nullptr) {}
 	~SparseBlock()
 	{
-		delete[] data;
+		SizeClassPool::get()->dealloc(data);
 	}
 	void alloc(uint32_t block_area, bool zeroOutBuffer)
 	{
-		data = new int32_t[block_area];
+		data = (int32_t*)SizeClassPool::get()->alloc(block_area * sizeof(int32_t));
+		if(!data)
+			throw std::bad_alloc();
 		if(zeroOutBuffer)
 			memset(data, 0, block_area * sizeof(int32_t));
 	}
@@ -396,7 +396,7 @@ void TileComponent::postDecompressImpl(int32_t* srcData, DecompressBlockExec* bl
 
 	window_->toRelativeCoordinates(block->resno, block->bandOrientation, block->x, block->y);
 	auto src =
-		grk_buf2d<int32_t, AllocatorAligned>(srcData, false, cblk->width(), stride, cblk->height());
+		grk_buf2d<int32_t, AllocatorPooled>(srcData, false, cblk->width(), stride, cblk->height());
 	auto blockBounds =
 		grk_rect32(block->x, block->y, block->x + cblk->width(), block->y + cblk->height());
 	if(!empty)
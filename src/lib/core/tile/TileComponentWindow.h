@@ -57,7 +57,7 @@ struct TileComponentWindowBase
 							grk_rect32 unreducedImageCompWindow, uint8_t numresolutions,
 							uint8_t reducedNumResolutions)
 		: unreducedBounds_(unreducedTileComp), bounds_(reducedTileComp), compress_(isCompressor),
-		  wholeTileDecompress_(wholeTileDecompress)
+		  wholeTileDecompress_(wholeTileDecompress), memTracker_(GRK_MEM_TILE_WINDOW)
 	{
 		assert(reducedNumResolutions > 0);
 		auto currentRes = unreducedTileComp;
@@ -132,9 +132,20 @@ struct TileComponentWindowBase
 			if(!b->alloc(!compress_))
 				return false;
 		}
+		trackMem();
 
 		return true;
 	}
+	/**
+	 * Record bytes owned by resolution windows with codec's memory account
+	 */
+	void trackMem(void)
+	{
+		uint64_t bytes = 0;
+		for(auto& b : resWindows)
+			bytes += b->allocatedBytes();
+		memTracker_.set(bytes);
+	}
 
   protected:
 	bool useBandWindows() const
@@ -153,12 +164,13 @@ struct TileComponentWindowBase
 	std::vector<ResSimple> resolution_;
 	bool compress_;
 	bool wholeTileDecompress_;
+	MemTracker memTracker_;
 };
 
 template<typename T>
 struct TileComponentWindow : public TileComponentWindowBase<T>
 {
-	typedef grk_buf2d<T, AllocatorAligned> Buf2dAligned;
+	typedef grk_buf2d<T, AllocatorPooled> Buf2dAligned;
 	TileComponentWindow(bool isCompressor, bool lossless, bool wholeTileDecompress,
 						grk_rect32 unreducedTileComp, grk_rect32 reducedTileComp,
 						grk_rect32 unreducedImageCompWindow, uint8_t numresolutions,
@@ -210,7 +222,7 @@ struct TileComponentWindow : public TileComponentWindowBase<T>
 	void postProcess(Buf2dAligned& src, uint8_t resno, eBandOrientation bandOrientation,
 					 DecompressBlockExec* block)
 	{
-		grk_buf2d<int32_t, AllocatorAligned> dst;
+		grk_buf2d<int32_t, AllocatorPooled> dst;
 		dst = getCodeBlockDestWindowREL(resno, bandOrientation);
 		dst.copyFrom<F>(src, F(block));
 	}
@@ -395,6 +407,7 @@ struct TileComponentWindow : public TileComponentWindowBase<T>
 	void transfer(T** buffer, uint32_t* stride)
 	{
 		getResWindowBufferHighestREL()->transfer(buffer, stride);
+		this->trackMem();
 	}
 
   private:
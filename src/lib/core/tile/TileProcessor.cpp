@@ -30,8 +30,12 @@ TileProcessor::TileProcessor(uint16_t tileIndex, CodeStream* codeStream, Buffere
 	  numProcessedPackets(0), numDecompressedPackets(0), tilePartDataLength(0),
 	  tileIndex_(tileIndex), stream_(stream),
 	  newTilePartProgressionPosition(cp_->coding_params_.enc_.newTilePartProgressionPosition),
-	  tcp_(cp_->tcps + tileIndex_), truncated(false), image_(nullptr), isCompressor_(isCompressor),
-	  preCalculatedTileLen(0), mct_(new mct(tile, headerImage, tcp_, stripCache))
+	  tcp_(cp_->tcps + tileIndex_), truncated(false), coefficients_(false), image_(nullptr),
+	  isCompressor_(isCompressor), preCalculatedTileLen(0),
+	  mct_(new mct(tile, headerImage, tcp_, stripCache)), stats_(codeStream->getStats()),
+	  control_(codeStream->getControl()),
+	  schedulerCache_(codeStream->getSchedulerCache()),
+	  packetSequenceCache_(codeStream->getPacketSequenceCache())
 {}
 TileProcessor::~TileProcessor()
 {
@@ -145,6 +149,18 @@ Scheduler* TileProcessor::getScheduler(void)
 {
 	return scheduler_;
 }
+PacketSequenceCache* TileProcessor::getPacketSequenceCache(void)
+{
+	return packetSequenceCache_;
+}
+Stats* TileProcessor::getStats(void)
+{
+	return stats_;
+}
+CodecControl* TileProcessor::getControl(void)
+{
+	return control_;
+}
 bool TileProcessor::isCompressor(void)
 {
 	return isCompressor_;
@@ -322,22 +338,28 @@ bool TileProcessor::doCompress(void)
 	bool debugEncode = state & GRK_PLUGIN_STATE_DEBUG;
 	bool debugMCT = (state & GRK_PLUGIN_STATE_MCT_ONLY) ? true : false;
 
+	ScopedSpan tileSpan(stats_, GRK_STAGE_TILE, tileIndex_);
+	if(stats_)
+		stats_->addCounter(GRK_COUNTER_TILES, 1);
 	if(!current_plugin_tile || debugEncode)
 	{
-		if(!debugEncode)
+		if(!debugEncode && !coefficients_)
 		{
+			ScopedSpan mctSpan(stats_, GRK_STAGE_MCT, tileIndex_);
 			if(!dcLevelShiftCompress())
 				return false;
 			if(!mct_encode())
 				return false;
 		}
-		if(!debugEncode || debugMCT)
+		if((!debugEncode || debugMCT) && !coefficients_)
 		{
+			ScopedSpan dwtSpan(stats_, GRK_STAGE_DWT, tileIndex_);
 			if(!dwt_encode())
 				return false;
 		}
 		t1_encode();
 	}
+	ScopedSpan t2Span(stats_, GRK_STAGE_T2, tileIndex_);
 	// 1. create PLT marker if required
 	packetLengthCache.deleteMarkers();
 	if(cp_->coding_params_.enc_.writePLT)
@@ -390,6 +412,7 @@ bool TileProcessor::canWritePocMarker(void)
 }
 bool TileProcessor::writeTilePartT2(uint32_t* tileBytesWritten)
 {
+	ScopedSpan t2Span(stats_, GRK_STAGE_T2, tileIndex_);
 	// write entire PLT marker in first tile part header
 	if(tilePartCounter_ == 0 && packetLengthCache.getMarkers())
 	{
@@ -428,6 +451,22 @@ bool TileProcessor::isWholeTileDecompress(uint16_t compno)
 			  ((tilec->x1 - dims.x1) >> shift) == 0 && ((tilec->y1 - dims.y1) >> shift) == 0)));
 }
 
+uint64_t TileProcessor::getDecompressMemoryEstimate(void)
+{
+	uint64_t bytes = 0;
+	for(uint16_t compno = 0; compno < tile->numcomps_; ++compno)
+	{
+		auto tilec = tile->comps + compno;
+		if(!tilec->resolutions_ || !tilec->numResolutionsToDecompress)
+			continue;
+		auto res = tilec->resolutions_ + tilec->numResolutionsToDecompress - 1;
+		// tile component window, plus roughly the same again for
+		// band windows, code block buffers and T1 scratch
+		bytes += 2 * res->area() * sizeof(int32_t);
+	}
+
+	return bytes;
+}
 bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 {
 	auto tcp = getTileCodingParams();
@@ -438,7 +477,8 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 	}
 	bool doT1 = !current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_T1);
 	bool doPostT1 =
-		!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_POST_T1);
+		!coefficients_ &&
+		(!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_POST_T1));
 
 	// create window buffers
 	// (no buffer allocation)
@@ -458,6 +498,9 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 	bool doT2 = !current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_T2);
 	if(doT2)
 	{
+		ScopedSpan t2Span(stats_, GRK_STAGE_T2, tileIndex_);
+		if(stats_)
+			stats_->addCounter(GRK_COUNTER_BYTES, tcp->compressedTileData_->totalLength());
 		auto t2 = std::make_unique<T2Decompress>(this);
 		t2->decompressPackets(tileIndex_, tcp->compressedTileData_, &truncated);
 		// synch plugin with T2 data
@@ -479,7 +522,7 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 		// 2.create and populate tasks, and execute
 		if(parserCount)
 		{
-			auto numThreads = std::min<size_t>(ExecSingleton::get()->num_workers(), parserCount);
+			auto numThreads = std::min<size_t>(ExecSingleton::num_workers(), parserCount);
 			if(numThreads == 1)
 			{
 				for(uint16_t compno = 0; compno < headerImage->numcomps; ++compno)
@@ -490,6 +533,8 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 						auto res = tilec->resolutions_ + resno;
 						for(auto& pp : res->parserMap_->precinctParsers_)
 						{
+							if(control_->isCancelled())
+								break;
 							for(uint64_t j = 0; j < pp.second->numParsers_; ++j)
 							{
 								try
@@ -524,7 +569,12 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 						for(auto& pp : res->parserMap_->precinctParsers_)
 						{
 							auto& ppair = pp;
-							auto decompressor = [ppair]() {
+							auto memAccount = MemAccount::current();
+							auto control = control_;
+							auto decompressor = [ppair, memAccount, control]() {
+								if(control->isCancelled())
+									return;
+								MemAccountScope memScope(memAccount);
 								for(uint64_t j = 0; j < ppair.second->numParsers_; ++j)
 								{
 									try
@@ -548,10 +598,13 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 			}
 		}
 	}
+	if(control_->isCancelled())
+		return false;
 	// T1
 	if(doT1)
 	{
-		scheduler_ = new DecompressScheduler(this, tile, tcp_, headerImage->comps->prec);
+		auto scheduler = schedulerCache_->get(this, tile, tcp_, headerImage->comps->prec);
+		scheduler_ = scheduler;
 		FlowComponent* mctPostProc = nullptr;
 		// schedule MCT post processing
 		if(doPostT1 && needsMctDecompress())
@@ -614,13 +667,14 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 			return false;
 		if(!scheduler_->run())
 			return false;
-		delete scheduler_;
+		schedulerCache_->put(scheduler);
 		scheduler_ = nullptr;
+		// code blocks no longer reference the compressed stream, and the tile
+		// cache only retains decompressed images, so release it now
+		tcp->releaseCompressedData();
 	}
 	// 4. post T1
-	bool doPost =
-		!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_POST_T1);
-	if(doPost)
+	if(doPostT1)
 	{
 		if(outputImage->hasMultipleTiles)
 			generateImage(outputImage, tile);
@@ -628,6 +682,8 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 			outputImage->transferDataFrom(tile);
 		deallocBuffers();
 	}
+	if(stats_)
+		stats_->addCounter(GRK_COUNTER_PACKETS, getNumDecompressedPackets());
 	if(doT1 && getNumDecompressedPackets() == 0)
 	{
 		GRK_WARN("Tile %u was not decompressed", tileIndex_);
@@ -637,6 +693,28 @@ bool TileProcessor::decompressT2T1(GrkImage* outputImage)
 	return true;
 }
 
+bool TileProcessor::decompressCoefficients(GrkImage* outputImage)
+{
+	coefficients_ = true;
+
+	return decompressT2T1(outputImage);
+}
+bool TileProcessor::holdsCoefficients(void) const
+{
+	return coefficients_;
+}
+bool TileProcessor::scanPackets(std::vector<PacketSpan>* packets)
+{
+	auto tcp = getTileCodingParams();
+	if(!tcp->compressedTileData_)
+	{
+		GRK_ERROR("Tile %u has no compressed data", getIndex());
+		return false;
+	}
+	T2Decompress t2(this);
+
+	return t2.scanPackets(tileIndex_, tcp->compressedTileData_, packets);
+}
 void TileProcessor::ingestImage()
 {
 	for(uint16_t i = 0; i < headerImage->numcomps; ++i)
@@ -818,7 +896,8 @@ void TileProcessor::t1_encode()
 		mct_norms = (const double*)(tcp->mct_norms);
 	}
 
-	scheduler_ = new CompressScheduler(tile, needsRateControl(), tcp, mct_norms, mct_numcomps);
+	scheduler_ = new CompressScheduler(tile, needsRateControl(), tcp, mct_norms, mct_numcomps,
+									   stats_, tileIndex_);
 	scheduler_->schedule(0);
 }
 bool TileProcessor::encodeT2(uint32_t* tileBytesWritten)
@@ -958,6 +1037,24 @@ bool TileProcessor::preCompressTile()
 
 	return true;
 }
+bool TileProcessor::preCompressTile(TILE_FUNC ingest)
+{
+	tilePartCounter_ = 0;
+	first_poc_tile_part_ = true;
+	if(!init() || !createWindowBuffers(nullptr))
+		return false;
+	for(uint16_t compno = 0; compno < headerImage->numcomps; ++compno)
+	{
+		if(!(tile->comps + compno)->getWindow()->alloc())
+		{
+			GRK_ERROR("Error allocating tile component data.");
+			return false;
+		}
+	}
+	coefficients_ = true;
+
+	return ingest(this);
+}
 /**
  * Assume that source stride  == source width == destination width
  */
@@ -73,6 +73,7 @@ struct PacketTracker
  */
 
 class mct;
+struct PacketSpan;
 
 struct TileProcessor
 {
@@ -83,10 +84,44 @@ struct TileProcessor
 	bool createWindowBuffers(const GrkImage* outputImage);
 	void deallocBuffers();
 	bool preCompressTile(void);
+	/**
+	 * Prepare tile for compression from wavelet coefficients rather than image data:
+	 * DC level shift, multi component transform and wavelet transform are skipped
+	 *
+	 * @param ingest fills tile component windows with coefficients
+	 * @return true if successful
+	 */
+	bool preCompressTile(TILE_FUNC ingest);
 	bool canWritePocMarker(void);
 	bool writeTilePartT2(uint32_t* tileBytesWritten);
 	bool doCompress(void);
 	bool decompressT2T1(GrkImage* outputImage);
+	/**
+	 * Locate all packets of tile, without decompressing them
+	 *
+	 * @param packets receives packet locations, in code stream order
+	 * @return true if successful
+	 */
+	bool scanPackets(std::vector<PacketSpan>* packets);
+	/**
+	 * Decompress tile to wavelet coefficients, which are kept in the
+	 * tile component windows
+	 *
+	 * @param outputImage output image
+	 * @return true if successful
+	 */
+	bool decompressCoefficients(GrkImage* outputImage);
+	/**
+	 * @return true if tile holds wavelet coefficients rather than image data
+	 */
+	bool holdsCoefficients(void) const;
+	/**
+	 * Estimate peak memory needed to decompress this tile, not including
+	 * compressed data which has already been read
+	 *
+	 * @return estimate in bytes
+	 */
+	uint64_t getDecompressMemoryEstimate(void);
 	bool ingestUncompressedData(uint8_t* p_src, uint64_t src_length);
 	bool needsRateControl();
 	void ingestImage();
@@ -106,7 +141,10 @@ struct TileProcessor
 	void incrementIndex(void);
 	Tile* getTile(void);
 	Scheduler* getScheduler(void);
+	PacketSequenceCache* getPacketSequenceCache(void);
 	bool isCompressor(void);
+	Stats* getStats(void);
+	CodecControl* getControl(void);
 
 	/** Compression Only
 	 *  true for first POC tile part, otherwise false*/
@@ -170,11 +208,20 @@ struct TileProcessor
 	// coding/decoding parameters for this tile
 	TileCodingParams* tcp_;
 	bool truncated;
+	// true if tile component windows hold wavelet coefficients
+	bool coefficients_;
 	GrkImage* image_;
 	bool isCompressor_;
 	grk_rect32 unreducedImageWindow;
 	uint32_t preCalculatedTileLen;
 	mct* mct_;
+	// instrumentation (null if disabled)
+	Stats* stats_;
+	CodecControl* control_;
+	// decompress schedulers are reused across tiles with the same geometry
+	SchedulerCache* schedulerCache_;
+	// decompress packet sequences are shared across tiles with the same geometry
+	PacketSequenceCache* packetSequenceCache_;
 };
 
 } // namespace grk
@@ -152,6 +152,9 @@ size_t BufferedStream::read(uint8_t* buffer, size_t p_size)
 
 	// 5. read from "media"
 	invalidate_buffer();
+	// memory stream buffer is the media itself, so read in place at current offset
+	if(isMemStream())
+		buf_->offset = stream_offset_;
 	while(true)
 	{
 		buffered_bytes_ = read_fn_(buf_->currPtr(), buf_->len, user_data_);
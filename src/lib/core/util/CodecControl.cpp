@@ -0,0 +1,80 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "grk_includes.h"
+
+namespace grk
+{
+// with a progress callback, progress is reported for every tile,
+// and every blockNotifyInterval code blocks
+const uint64_t blockNotifyInterval = 256;
+
+CodecControl::CodecControl(void)
+	: cancelled_(false), deadlineMs_(0), deadline_(0), callback_(nullptr), userData_(nullptr),
+	  numTiles_(0), tilesDone_(0), blocksDone_(0)
+{}
+void CodecControl::init(uint32_t deadlineMs, grk_progress_callback callback, void* userData)
+{
+	deadlineMs_ = deadlineMs;
+	callback_ = callback;
+	userData_ = userData;
+}
+void CodecControl::start(uint16_t numTiles)
+{
+	deadline_ = deadlineMs_ ? Stats::now() + (uint64_t)deadlineMs_ * 1000000 : 0;
+	numTiles_ = numTiles;
+	tilesDone_ = 0;
+	blocksDone_ = 0;
+}
+void CodecControl::cancel(void)
+{
+	cancelled_.store(true, std::memory_order_relaxed);
+}
+bool CodecControl::isCancelled(void) const
+{
+	return cancelled_.load(std::memory_order_relaxed) || (deadline_ && Stats::now() > deadline_);
+}
+void CodecControl::logCancel(void) const
+{
+	if(cancelled_)
+		GRK_WARN("Decompression cancelled");
+	else
+		GRK_WARN("Decompression deadline of %u ms exceeded", deadlineMs_);
+}
+void CodecControl::tileDone(void)
+{
+	tilesDone_++;
+	notify();
+}
+void CodecControl::blockDone(void)
+{
+	if(++blocksDone_ % blockNotifyInterval == 0)
+		notify();
+}
+void CodecControl::notify(void)
+{
+	if(!callback_)
+		return;
+	grk_progress progress;
+	std::unique_lock<std::mutex> lk(callbackMutex_);
+	progress.tiles_decompressed = tilesDone_;
+	progress.num_tiles = numTiles_;
+	progress.blocks_decompressed = blocksDone_;
+	if(!callback_(&progress, userData_))
+		cancel();
+}
+
+} // namespace grk
@@ -0,0 +1,75 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+namespace grk
+{
+/**
+ * Cooperative cancellation, deadline and progress reporting for a codec.
+ *
+ * Long running stages poll isCancelled() between units of work (tiles,
+ * packets, code blocks), and stop scheduling new work once it returns true.
+ * Cancellation is permanent: all later decompress calls on the codec fail.
+ */
+class CodecControl
+{
+  public:
+	CodecControl(void);
+	/**
+	 * @param deadlineMs maximum duration in ms of each decompress call; 0 means no deadline
+	 * @param callback progress callback (may be null)
+	 * @param userData user data passed to callback
+	 */
+	void init(uint32_t deadlineMs, grk_progress_callback callback, void* userData);
+	/**
+	 * Start deadline timer and reset progress at start of a decompress call
+	 *
+	 * @param numTiles number of tiles scheduled for decompression
+	 */
+	void start(uint16_t numTiles);
+	/**
+	 * Cancel codec - can be called from any thread
+	 */
+	void cancel(void);
+	/**
+	 * @return true if codec has been cancelled, or deadline has passed
+	 */
+	bool isCancelled(void) const;
+	/**
+	 * Log reason for cancellation
+	 */
+	void logCancel(void) const;
+	void tileDone(void);
+	void blockDone(void);
+
+  private:
+	void notify(void);
+	std::atomic<bool> cancelled_;
+	uint32_t deadlineMs_;
+	uint64_t deadline_; // steady clock ns; 0 if there is no deadline
+	grk_progress_callback callback_;
+	void* userData_;
+	uint16_t numTiles_;
+	std::atomic<uint16_t> tilesDone_;
+	std::atomic<uint64_t> blocksDone_;
+	std::mutex callbackMutex_;
+};
+
+} // namespace grk
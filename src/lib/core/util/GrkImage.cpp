@@ -52,6 +52,7 @@ void GrkImage::copyComponent(grk_image_comp* src, grk_image_comp* dest)
 	dest->prec = src->prec;
 	dest->sgnd = src->sgnd;
 	dest->type = src->type;
+	dest->float_data = src->float_data;
 }
 
 bool GrkImage::componentsEqual(uint16_t firstNComponents, bool checkPrecision)
@@ -296,7 +297,7 @@ bool GrkImage::allocData(grk_image_comp* comp, bool clear)
 	assert(!comp->data);
 
 	size_t dataSize = (uint64_t)comp->stride * comp->h * sizeof(uint32_t);
-	auto data = (int32_t*)grk_aligned_malloc(dataSize);
+	auto data = (int32_t*)SizeClassPool::get()->alloc(dataSize);
 	if(!data)
 	{
 		grk::GRK_ERROR("Failed to allocate aligned memory buffer of dimensions %u x %u",
@@ -339,6 +340,7 @@ bool GrkImage::supportsStripCache(CodingParams* cp)
 	bool supportedFileFormat =
 		decompressFormat == GRK_FMT_TIF || (decompressFormat == GRK_FMT_PXM && !splitByComponent);
 	if(isSubsampled() || precision || upsample || needsConversionToRGB() || !supportedFileFormat ||
+	   hasFloatData() ||
 	   (meta && (meta->color.palette || meta->color.icc_profile_buf)))
 	{
 		return false;
@@ -347,6 +349,16 @@ bool GrkImage::supportsStripCache(CodingParams* cp)
 	return componentsEqual(true);
 }
 
+bool GrkImage::hasFloatData(void) const
+{
+	for(uint16_t i = 0; i < numcomps; ++i)
+	{
+		if(comps[i].float_data)
+			return true;
+	}
+
+	return false;
+}
 bool GrkImage::isSubsampled()
 {
 	for(uint32_t i = 0; i < numcomps; ++i)
@@ -380,6 +392,9 @@ void GrkImage::postReadHeader(CodingParams* cp)
 	uint8_t prec = comps[0].prec;
 	if(precision)
 		prec = precision->prec;
+	// floating point samples are packed as 32 bit IEEE floats
+	if(hasFloatData())
+		prec = 32;
 	bool isGAorRGBA =
 		(decompressNumComps == 4 || decompressNumComps == 2) && isOpacity(decompressNumComps - 1);
 	if(meta && meta->color.palette)
@@ -392,12 +407,12 @@ void GrkImage::postReadHeader(CodingParams* cp)
 	decompressWidth = comps->w;
 	if(isSubsampled() && (upsample || forceRGB))
 		decompressWidth = x1 - x0;
+	decompressWidth = resampledDim(decompressWidth, cp->coding_params_.dec_.resampleX_);
 	decompressHeight = comps->h;
 	if(isSubsampled() && (upsample || forceRGB))
 		decompressHeight = y1 - y0;
-	decompressPrec = comps->prec;
-	if(precision)
-		decompressPrec = precision->prec;
+	decompressHeight = resampledDim(decompressHeight, cp->coding_params_.dec_.resampleY_);
+	decompressPrec = prec;
 	decompressColourSpace = color_space;
 	if(needsConversionToRGB())
 		decompressColourSpace = GRK_CLRSPC_SRGB;
@@ -788,7 +803,7 @@ bool GrkImage::apply_palette_clr()
 			while(channel > 0)
 			{
 				--channel;
-				grk_aligned_free(newComps[channel].data);
+				single_component_data_free(newComps + channel);
 			}
 			delete[] newComps;
 			GRK_ERROR("Memory allocation failure in apply_palette_clr().");
@@ -1031,6 +1046,19 @@ bool GrkImage::compositeInterleaved(const Tile* src, uint32_t yBegin, uint32_t y
  * @return:			true if successful
  */
 bool GrkImage::compositeInterleaved(const GrkImage* src)
+{
+	return compositeInterleaved(src, interleavedData.data_);
+}
+
+/**
+ * Interleave image data and copy to interleaved buffer
+ *
+ * @param src 	source image
+ * @param dest 	interleaved buffer, with the layout of this image
+ *
+ * @return:			true if successful
+ */
+bool GrkImage::compositeInterleaved(const GrkImage* src, uint8_t* dest)
 {
 	auto srcComp = src->comps;
 	auto destComp = comps;
@@ -1073,9 +1101,8 @@ bool GrkImage::compositeInterleaved(const GrkImage* src)
 	int32_t const* planes[grk::maxNumPackComponents];
 	for(uint16_t i = 0; i < src->numcomps; ++i)
 		planes[i] = (src->comps + i)->data;
-	iter->interleave(const_cast<int32_t**>(planes), src->numcomps,
-					 interleavedData.data_ + destIndex, destWin.width(), srcComp->stride,
-					 destStride, destWin.height(), 0);
+	iter->interleave(const_cast<int32_t**>(planes), src->numcomps, dest + destIndex,
+					 destWin.width(), srcComp->stride, destStride, destWin.height(), 0);
 	delete iter;
 
 	return true;
@@ -1128,6 +1155,45 @@ bool GrkImage::compositePlanar(const GrkImage* src)
 
 	return true;
 }
+/**
+ * Copy planar image data to planar buffer (no subsampling)
+ *
+ * @param src 	source image
+ * @param dest 	planar buffer, holding the components of this image one after the other,
+ * 				with stride equal to component width
+ *
+ * @return:			true if successful
+ */
+bool GrkImage::compositePlanar(const GrkImage* src, int32_t* dest)
+{
+	auto destComp = comps;
+	grk_rect32 destWin;
+	if(!generateCompositeBounds(src->comps, 0, &destWin))
+	{
+		GRK_WARN("GrkImage::compositePlanar: cannot generate composite bounds");
+		return false;
+	}
+	for(uint16_t compno = 0; compno < src->numcomps; compno++)
+	{
+		auto srcComp = src->comps + compno;
+		if(!srcComp->data)
+		{
+			GRK_WARN("GrkImage::compositePlanar: null data for source component %u", compno);
+			return false;
+		}
+		auto destPtr = dest + (uint64_t)destComp->w * destComp->h * compno +
+					   (uint64_t)destWin.y0 * destComp->w + destWin.x0;
+		auto srcPtr = srcComp->data;
+		for(uint32_t j = 0; j < destWin.height(); ++j)
+		{
+			memcpy(destPtr, srcPtr, destWin.width() * sizeof(int32_t));
+			destPtr += destComp->w;
+			srcPtr += srcComp->stride;
+		}
+	}
+
+	return true;
+}
 /***
  * Generate destination window (relative to destination component bounds)
  * Assumption: source region is wholly contained inside destination component region
@@ -1156,7 +1222,7 @@ void GrkImage::single_component_data_free(grk_image_comp* comp)
 {
 	if(!comp || !comp->data)
 		return;
-	grk_aligned_free(comp->data);
+	SizeClassPool::get()->dealloc(comp->data);
 	comp->data = nullptr;
 }
 
@@ -1168,6 +1234,8 @@ GrkImageMeta::GrkImageMeta()
 	iptc_len = 0;
 	xmp_buf = nullptr;
 	xmp_len = 0;
+	exif_buf = nullptr;
+	exif_len = 0;
 	memset(&color, 0, sizeof(color));
 }
 
@@ -1176,6 +1244,7 @@ GrkImageMeta::~GrkImageMeta()
 	releaseColor();
 	delete[] iptc_buf;
 	delete[] xmp_buf;
+	delete[] exif_buf;
 }
 void GrkImageMeta::allocPalette(uint8_t num_channels, uint16_t num_entries)
 {
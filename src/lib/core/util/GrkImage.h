@@ -75,7 +75,9 @@ class GrkImage : public grk_image
 	GrkImage* duplicate(const Tile* tile_src);
 	bool composite(const GrkImage* src);
 	bool compositeInterleaved(const GrkImage* src);
+	bool compositeInterleaved(const GrkImage* src, uint8_t* dest);
 	bool compositeInterleaved(const Tile* src, uint32_t yBegin, uint32_t yEnd);
+	bool compositePlanar(const GrkImage* src, int32_t* dest);
 	bool greyToRGB(void);
 	bool convertToRGB(bool wholeTileDecompress);
 	bool applyColourManagement(void);
@@ -83,10 +85,21 @@ class GrkImage : public grk_image
 	bool validateICC(void);
 	void convertPrecision(void);
 	bool execUpsample(void);
+	/**
+	 * Resample all components with an area filter
+	 *
+	 * @param ratioX ratio of output width to current width (0 if no resampling)
+	 * @param ratioY ratio of output height to current height (0 if no resampling)
+	 *
+	 * @return true if successful
+	 */
+	bool resample(double ratioX, double ratioY);
+	static uint32_t resampledDim(uint32_t dim, double ratio);
 	void all_components_data_free(void);
 	void postReadHeader(CodingParams* cp);
 	void validateColourSpace(void);
 	bool isSubsampled();
+	bool hasFloatData(void) const;
 	bool validateZeroed(void);
 	bool applyColour(void);
 	bool apply_palette_clr(void);
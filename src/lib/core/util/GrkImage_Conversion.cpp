@@ -209,6 +209,61 @@ bool GrkImage::execUpsample(void)
 	return true;
 }
 
+template<typename T>
+static void resampleComponent(const grk_image_comp* src, grk_image_comp* dest)
+{
+	Resampler resampler(src->w, src->h, dest->w, dest->h);
+	auto srcRow = (const T*)src->data;
+	auto destRow = (T*)dest->data;
+	for(uint32_t y = 0; y < src->h; ++y)
+	{
+		if(resampler.push(srcRow, destRow))
+			destRow += dest->stride;
+		srcRow += src->stride;
+	}
+}
+
+uint32_t GrkImage::resampledDim(uint32_t dim, double ratio)
+{
+	if(ratio == 0)
+		return dim;
+
+	return std::max<uint32_t>((uint32_t)(dim * ratio + 0.5), 1);
+}
+
+bool GrkImage::resample(double ratioX, double ratioY)
+{
+	if(ratioX == 0 && ratioY == 0)
+		return true;
+
+	for(uint16_t compno = 0; compno < numcomps; ++compno)
+	{
+		auto comp = comps + compno;
+		if(!comp->data)
+		{
+			GRK_ERROR("resample: component %u has no data", compno);
+			return false;
+		}
+		grk_image_comp dest;
+		memset(&dest, 0, sizeof(grk_image_comp));
+		copyComponent(comp, &dest);
+		dest.w = resampledDim(comp->w, ratioX);
+		dest.h = resampledDim(comp->h, ratioY);
+		dest.x0 = (uint32_t)(comp->x0 * ratioX);
+		dest.y0 = (uint32_t)(comp->y0 * ratioY);
+		if(!allocData(&dest))
+			return false;
+		if(comp->float_data)
+			resampleComponent<float>(comp, &dest);
+		else
+			resampleComponent<int32_t>(comp, &dest);
+		single_component_data_free(comp);
+		*comp = dest;
+	}
+
+	return true;
+}
+
 template<typename T>
 void clip(grk_image_comp* component, uint8_t precision)
 {
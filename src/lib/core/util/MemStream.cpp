@@ -153,9 +153,9 @@ grk_stream* create_mem_stream(uint8_t* buf, size_t len, bool ownsBuffer, bool is
 		GRK_ERROR("Buffer of length %d is invalid\n", len);
 		return nullptr;
 	}
-	GRK_CODEC_FORMAT format;
-	bool detected = grk_decompress_buffer_detect_format(buf, len, &format);
-	if(is_read_stream && !detected)
+	// write buffer has no content to detect
+	GRK_CODEC_FORMAT format = GRK_CODEC_UNK;
+	if(is_read_stream && !grk_decompress_buffer_detect_format(buf, len, &format))
 		return nullptr;
 
 	auto memStream = new MemStream(buf, 0, len, ownsBuffer);
@@ -77,7 +77,7 @@ template<typename T, typename IT, typename L>
 class MinHeapPtr
 {
   public:
-	MinHeapPtr() : nextIndex(0) {}
+	explicit MinHeapPtr(IT startIndex = 0) : nextIndex(startIndex) {}
 	void push(T* val)
 	{
 		L locker(queue_mutex);
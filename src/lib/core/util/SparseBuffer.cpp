@@ -20,7 +20,9 @@
 
 namespace grk
 {
-SparseBuffer::SparseBuffer() : dataLen(0), currentChunkId(0), reachedEnd_(false) {}
+SparseBuffer::SparseBuffer()
+	: dataLen(0), currentChunkId(0), reachedEnd_(false), memTracker_(GRK_MEM_COMPRESSED)
+{}
 SparseBuffer::~SparseBuffer()
 {
 	cleanup();
@@ -110,6 +112,8 @@ grk_buf8* SparseBuffer::pushBack(uint8_t* buf, size_t len, bool ownsData)
 	// assert(len < UINT_MAX);
 	auto new_chunk = new grk_buf8(buf, len, ownsData);
 	pushBack(new_chunk);
+	if(ownsData)
+		memTracker_.add(len);
 	return new_chunk;
 }
 void SparseBuffer::pushBack(grk_buf8* chunk)
@@ -125,6 +129,7 @@ void SparseBuffer::cleanup(void)
 	for(size_t i = 0; i < chunks.size(); ++i)
 		delete chunks[i];
 	chunks.clear();
+	memTracker_.release();
 }
 void SparseBuffer::rewind(void)
 {
@@ -53,6 +53,8 @@ struct SparseBuffer
 	size_t currentChunkId; /* current index into chunk vector */
 	std::vector<grk_buf8*> chunks;
 	bool reachedEnd_;
+	// memory accounting for owned chunks
+	MemTracker memTracker_;
 };
 
 } // namespace grk
@@ -0,0 +1,137 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "grk_includes.h"
+
+namespace grk
+{
+static const char* stageNames[GRK_NUM_STAGES] = {"marker_parse", "t2",	   "t1", "dwt",
+												 "mct",			 "output", "io", "tile"};
+static const char* counterNames[GRK_NUM_COUNTERS] = {"tiles", "blocks", "passes", "bytes",
+													 "packets"};
+
+const char* statsStageName(GRK_STAGE stage)
+{
+	return stage < GRK_NUM_STAGES ? stageNames[stage] : "unknown";
+}
+const char* statsCounterName(GRK_COUNTER counter)
+{
+	return counter < GRK_NUM_COUNTERS ? counterNames[counter] : "unknown";
+}
+
+Stats::Stats(uint32_t flags) : flags_(flags), origin_(now())
+{
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+	{
+		count_[i] = 0;
+		totalNs_[i] = 0;
+		maxNs_[i] = 0;
+	}
+	for(uint32_t i = 0; i < GRK_NUM_COUNTERS; ++i)
+		counters_[i] = 0;
+}
+bool Stats::isTracing(void) const
+{
+	return flags_ & GRK_STATS_TRACE;
+}
+uint64_t Stats::now(void)
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+uint32_t Stats::threadId(void)
+{
+	static std::atomic<uint32_t> nextThreadId(0);
+	thread_local uint32_t id = nextThreadId++;
+
+	return id;
+}
+void Stats::addSpan(GRK_STAGE stage, uint16_t tileIndex, uint64_t start, uint64_t end,
+					int8_t resno)
+{
+	if(stage >= GRK_NUM_STAGES)
+		return;
+	uint64_t duration = end > start ? end - start : 0;
+	count_[stage]++;
+	totalNs_[stage] += duration;
+	uint64_t prevMax = maxNs_[stage];
+	while(duration > prevMax && !maxNs_[stage].compare_exchange_weak(prevMax, duration))
+	{
+	}
+	if(isTracing())
+	{
+		TraceSpan span;
+		span.start_ = start > origin_ ? start - origin_ : 0;
+		span.duration_ = duration;
+		span.threadId_ = threadId();
+		span.tileIndex_ = tileIndex;
+		span.stage_ = (uint8_t)stage;
+		span.resno_ = resno;
+		std::unique_lock<std::mutex> lk(traceMutex_);
+		spans_.push_back(span);
+	}
+}
+void Stats::addCounter(GRK_COUNTER counter, uint64_t value)
+{
+	if(counter < GRK_NUM_COUNTERS)
+		counters_[counter] += value;
+}
+void Stats::get(grk_stats* stats) const
+{
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+	{
+		stats->stages[i].count = count_[i];
+		stats->stages[i].total_ms = (double)totalNs_[i] / 1e6;
+		stats->stages[i].max_ms = (double)maxNs_[i] / 1e6;
+	}
+	for(uint32_t i = 0; i < GRK_NUM_COUNTERS; ++i)
+		stats->counters[i] = counters_[i];
+	stats->elapsed_ms = (double)(now() - origin_) / 1e6;
+}
+bool Stats::dumpTrace(const char* fileName) const
+{
+	if(!fileName)
+		return false;
+	auto fp = fopen(fileName, "w");
+	if(!fp)
+	{
+		GRK_ERROR("Unable to open trace file %s", fileName);
+		return false;
+	}
+	std::unique_lock<std::mutex> lk(traceMutex_);
+	bool rc = fprintf(fp, "{\"traceEvents\":[\n") > 0;
+	for(size_t i = 0; i < spans_.size() && rc; ++i)
+	{
+		auto& span = spans_[i];
+		rc = fprintf(fp,
+					 "{\"name\":\"%s\",\"cat\":\"grok\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+					 "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"tile\":%u,\"res\":%d}}%s\n",
+					 stageNames[span.stage_], span.threadId_, (double)span.start_ / 1e3,
+					 (double)span.duration_ / 1e3, span.tileIndex_, span.resno_,
+					 i + 1 < spans_.size() ? "," : "") > 0;
+	}
+	if(rc)
+		rc = fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n") > 0;
+	if(fclose(fp) != 0)
+		rc = false;
+	if(!rc)
+		GRK_ERROR("Failed to write trace file %s", fileName);
+
+	return rc;
+}
+
+} // namespace grk
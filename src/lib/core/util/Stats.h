@@ -0,0 +1,98 @@
+/*
+ *    Copyright (C) 2016-2023 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <chrono>
+
+namespace grk
+{
+const char* statsStageName(GRK_STAGE stage);
+const char* statsCounterName(GRK_COUNTER counter);
+
+/**
+ * Single span recorded for trace output
+ */
+struct TraceSpan
+{
+	uint64_t start_; // ns relative to stats origin
+	uint64_t duration_; // ns
+	uint32_t threadId_;
+	uint16_t tileIndex_;
+	uint8_t stage_;
+	int8_t resno_;
+};
+
+/**
+ * Per-codec instrumentation: aggregates span durations per stage and counters,
+ * and optionally records every span for trace output.
+ *
+ * Instrumented code holds a Stats pointer which is null when instrumentation
+ * is disabled, so the disabled cost is a single branch.
+ */
+class Stats
+{
+  public:
+	explicit Stats(uint32_t flags);
+	bool isTracing(void) const;
+	static uint64_t now(void);
+	void addSpan(GRK_STAGE stage, uint16_t tileIndex, uint64_t start, uint64_t end,
+				 int8_t resno = -1);
+	void addCounter(GRK_COUNTER counter, uint64_t value);
+	void get(grk_stats* stats) const;
+	bool dumpTrace(const char* fileName) const;
+
+  private:
+	static uint32_t threadId(void);
+	uint32_t flags_;
+	uint64_t origin_;
+	std::atomic<uint64_t> count_[GRK_NUM_STAGES];
+	std::atomic<uint64_t> totalNs_[GRK_NUM_STAGES];
+	std::atomic<uint64_t> maxNs_[GRK_NUM_STAGES];
+	std::atomic<uint64_t> counters_[GRK_NUM_COUNTERS];
+	mutable std::mutex traceMutex_;
+	std::vector<TraceSpan> spans_;
+};
+
+/**
+ * RAII span: records time from construction to destruction.
+ * No-op if stats is null.
+ */
+class ScopedSpan
+{
+  public:
+	ScopedSpan(Stats* stats, GRK_STAGE stage, uint16_t tileIndex, int8_t resno = -1)
+		: stats_(stats), stage_(stage), tileIndex_(tileIndex), resno_(resno),
+		  start_(stats ? Stats::now() : 0)
+	{}
+	~ScopedSpan()
+	{
+		if(stats_)
+			stats_->addSpan(stage_, tileIndex_, start_, Stats::now(), resno_);
+	}
+
+  private:
+	Stats* stats_;
+	GRK_STAGE stage_;
+	uint16_t tileIndex_;
+	int8_t resno_;
+	uint64_t start_;
+};
+
+} // namespace grk
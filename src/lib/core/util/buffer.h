@@ -43,6 +43,18 @@ struct AllocatorAligned
 		grk_aligned_free(buf);
 	}
 };
+template<typename T>
+struct AllocatorPooled
+{
+	T* alloc(size_t length)
+	{
+		return (T*)SizeClassPool::get()->alloc(length * sizeof(T));
+	}
+	void dealloc(T* buf)
+	{
+		SizeClassPool::get()->dealloc(buf);
+	}
+};
 template<typename T, template<typename TT> typename A>
 struct grk_buf : A<T>
 {
@@ -277,7 +289,7 @@ struct grk_buf2d : protected grk_buf<T, A>, public grk_rect32
 			uint64_t data_size_needed = (uint64_t)stride * height() * sizeof(T);
 			if(!data_size_needed)
 				return true;
-			if(!grk_buf<T, A>::alloc(data_size_needed))
+			if(!grk_buf<T, A>::alloc((uint64_t)stride * height()))
 			{
 				grk::GRK_ERROR("Failed to allocate aligned memory buffer of dimensions %u x %u",
 							   stride, height());
@@ -289,6 +301,11 @@ struct grk_buf2d : protected grk_buf<T, A>, public grk_rect32
 
 		return true;
 	}
+	// number of bytes allocated and owned by this buffer
+	uint64_t ownedBytes(void) const
+	{
+		return this->owns_data ? (uint64_t)this->len * sizeof(T) : 0;
+	}
 	// set buf to buffer without owning it
 	void attach(T* buffer, uint32_t strd)
 	{
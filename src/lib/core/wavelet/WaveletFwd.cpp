@@ -407,7 +407,7 @@ bool WaveletFwdImpl::encode_procedure(TileComponent* tilec)
 	if(dataSize != 0 && !bj)
 		return false;
 	int32_t i = maxNumResolutions;
-	uint32_t num_threads = ExecSingleton::get()->num_workers() > 1 ? 2 : 1;
+	uint32_t num_threads = ExecSingleton::num_workers() > 1 ? 2 : 1;
 	DWT dwt;
 	while(i--)
 	{
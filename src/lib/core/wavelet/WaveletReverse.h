@@ -95,7 +95,9 @@ struct dwt_data
 		}
 		paddingBytes_ = grk_make_aligned_width((uint32_t)padding * 2 + 32) * sizeof(T);
 		lenBytes_ = len * sizeof(T) + 2 * paddingBytes_;
-		allocatedMem = (T*)grk_aligned_malloc(lenBytes_);
+		// scratch is recycled through the buffer pool, so repeated decompression
+		// of small images does not allocate once the pool is warm
+		allocatedMem = (T*)SizeClassPool::get()->alloc(lenBytes_);
 		if(!allocatedMem)
 		{
 			GRK_ERROR("Failed to allocate %u bytes", lenBytes_);
@@ -107,7 +109,7 @@ struct dwt_data
 	}
 	void release(void)
 	{
-		grk_aligned_free(allocatedMem);
+		SizeClassPool::get()->dealloc(allocatedMem);
 		allocatedMem = nullptr;
 		mem = nullptr;
 		memL = nullptr;